@@ -0,0 +1,39 @@
+#pragma once
+
+namespace orbitops {
+
+// Sinusoidal 11-year solar cycle in F10.7 (solar flux units)
+struct SolarCycle {
+    double mean_f107 = 140.0;
+    double amplitude = 60.0;
+    double period_years = 11.0;
+    double phase_years = 0.0;      // Years after the start at which flux is at its mean and rising
+
+    double f107(double years) const;
+};
+
+// Neutral density (kg/m³) from the piecewise exponential reference
+// atmosphere, scaled for solar activity; `scale_height_km` receives the
+// local scale height. Altitude above the equatorial radius.
+double atmospheric_density(double altitude_km, double f107, double* scale_height_km = nullptr);
+
+// Ballistic coefficient Cd A/m (m²/kg) from an SGP4 B* (1/earth radii)
+double ballistic_coefficient_from_bstar(double bstar);
+
+// Orbit-averaged drag decay of a and e (King-Hele, first order in e)
+struct DecayRates {
+    double da_km_per_day = 0.0;
+    double de_per_day = 0.0;
+    double scale_height_km = 0.0;   // At perigee
+};
+
+DecayRates drag_decay_rates(double a_km, double e, double ballistic_m2_per_kg, double f107);
+
+// Integrate a and e under drag for up to `days`, sub-stepping so that a
+// step never lowers a by more than `max_decay_per_scale_height` perigee
+// scale heights. Stops early once the perigee radius falls below
+// `cutoff_radius_km`; returns the days integrated.
+double integrate_drag_decay(double& a_km, double& e, double ballistic_m2_per_kg, double f107,
+                            double days, double cutoff_radius_km, double max_decay_per_scale_height);
+
+} // namespace orbitops
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "types.hpp"
+#include "satellite_system.hpp"
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace orbitops {
+
+enum class BreakupKind {
+    EXPLOSION,
+    COLLISION
+};
+
+// A fragmentation event for the NASA standard breakup model
+struct BreakupEvent {
+    BreakupKind kind = BreakupKind::EXPLOSION;
+    uint32_t parent = 0;                  // Object index in the SatelliteSystem
+    double time_minutes = 0.0;            // Breakup epoch (minutes from element epoch)
+    bool parent_is_rocket_body = false;   // Selects the area-to-mass distribution
+
+    // Explosion: N(>Lc) = 6 S Lc^-1.6
+    double scale_factor = 1.0;            // S
+
+    // Collision: N(>Lc) = 0.1 M^0.75 Lc^-1.71, M = target + projectile mass
+    // (catastrophic) or projectile mass * v^2 (non-catastrophic, v in km/s)
+    double target_mass_kg = 1000.0;
+    double projectile_mass_kg = 10.0;
+    double impact_velocity_km_s = 10.0;
+
+    double min_length_m = 0.1;            // Smallest characteristic length generated
+    double max_length_m = 2.0;            // Largest fragment (about the parent's size)
+    size_t max_fragments = 500000;        // Cap on the sampled count
+    uint64_t seed = 42;
+};
+
+// Sampled fragments (SoA). States are the parent's state at the breakup
+// epoch plus each fragment's delta-v.
+struct FragmentCloud {
+    size_t count = 0;
+    double time_minutes = 0.0;
+    Vec3 parent_position;                 // km, ECI
+    Vec3 parent_velocity;                 // km/s, ECI
+
+    std::vector<float> length_m;          // Characteristic length
+    std::vector<float> area_to_mass;      // m²/kg
+    std::vector<float> mass_kg;
+    std::vector<double> dvx;              // km/s
+    std::vector<double> dvy;
+    std::vector<double> dvz;
+};
+
+struct BreakupResult {
+    bool success = false;
+    std::string error_message;
+    FragmentCloud fragments;
+};
+
+// Fragments larger than min_length_m for a catastrophic collision (specific
+// energy above 40 J/g) or explosion
+size_t breakup_fragment_count(const BreakupEvent& event);
+
+// Sample sizes, area-to-mass ratios and delta-v for every fragment in
+// parallel. Chunks draw from their own seeded engine, so the cloud depends
+// only on the event and not on the thread count.
+BreakupResult simulate_breakup(const SatelliteSystem& sys, const BreakupEvent& event);
+
+// Append the fragments on bound orbits with perigee above `min_perigee_km`
+// to `sys` as debris (elements fitted to their state at the breakup epoch;
+// B* from area-to-mass). Catalog numbers start at `first_catalog_number`.
+// Returns the number injected.
+size_t inject_fragments(
+    SatelliteSystem& sys,
+    const FragmentCloud& cloud,
+    const std::string& parent_name,
+    int first_catalog_number,
+    double min_perigee_km = 100.0
+);
+
+} // namespace orbitops
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+namespace orbitops {
+
+// Cooperative cancellation for long-running kernels.
+//
+// Kernels check the token at chunk granularity (a few hundred objects, cells
+// or Monte Carlo events) and return early with partial results once it trips.
+// A token trips when cancel() is called, its deadline passes, or the optional
+// poll source (e.g. a gRPC ServerContext) reports cancellation. Once tripped
+// it stays tripped, so subsequent checks are a single atomic load.
+class CancellationToken {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    CancellationToken() = default;
+    CancellationToken(const CancellationToken&) = delete;
+    CancellationToken& operator=(const CancellationToken&) = delete;
+
+    void cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+
+    void set_deadline(Clock::time_point deadline) { deadline_ = deadline; }
+    Clock::time_point deadline() const { return deadline_; }
+
+    // External cancellation source, polled on every check (must be thread-safe)
+    void set_poll(std::function<bool()> poll) { poll_ = std::move(poll); }
+
+    bool is_cancelled() const {
+        if (cancelled_.load(std::memory_order_relaxed)) return true;
+
+        if ((deadline_ != Clock::time_point::max() && Clock::now() >= deadline_) ||
+            (poll_ && poll_())) {
+            cancelled_.store(true, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+private:
+    mutable std::atomic<bool> cancelled_{false};
+    Clock::time_point deadline_ = Clock::time_point::max();
+    std::function<bool()> poll_;
+};
+
+// Null-safe check used by kernels that take an optional token
+inline bool is_cancelled(const CancellationToken* token) {
+    return token != nullptr && token->is_cancelled();
+}
+
+} // namespace orbitops
@@ -2,11 +2,27 @@
 
 #include "satellite_system.hpp"
 #include "types.hpp"
+#include "cancellation.hpp"
 #include <vector>
 #include <unordered_map>
+#include <cstddef>
+#include <cstdint>
 
 namespace orbitops {
 
+// Pair of object indices closer than a screening threshold
+struct ClosePair {
+    size_t i;
+    size_t j;
+    double distance_km;
+};
+
+// Result of a neighbour query
+struct Neighbor {
+    size_t index;         // Object index in the SatelliteSystem
+    double distance_km;
+};
+
 // Spatial hash grid for O(N) collision detection
 class SpatialGrid {
 public:
@@ -15,12 +31,47 @@ public:
     // Clear and rebuild grid from satellite positions
     void build(const SatelliteSystem& sys);
     
-    // Find all conjunctions within threshold
+    // As build, indexing only the given object indices (e.g. debris rows)
+    void build(const SatelliteSystem& sys, const std::vector<uint32_t>& indices);
+    
+    // Find all object index pairs within threshold. If `cancel` trips,
+    // remaining cells are skipped and the pairs found so far are returned.
+    std::vector<ClosePair> find_close_pairs(
+        const SatelliteSystem& sys,
+        double threshold_km,
+        const CancellationToken* cancel = nullptr
+    );
+    
+    // As find_close_pairs, reported by catalog number
     std::vector<Conjunction> find_conjunctions(
         const SatelliteSystem& sys,
         double threshold_km,
-        double time_minutes
+        double time_minutes,
+        const CancellationToken* cancel = nullptr
     );
+    
+    // Neighbour queries against the positions the grid was built from.
+    // Results are sorted by distance; `exclude` drops one index (the query
+    // object itself).
+    
+    // All objects within radius_km of point
+    std::vector<Neighbor> query_radius(
+        const SatelliteSystem& sys,
+        const Vec3& point,
+        double radius_km,
+        size_t exclude = SIZE_MAX
+    ) const;
+    
+    // The k nearest objects to point, searched in expanding rings of cells
+    std::vector<Neighbor> query_knn(
+        const SatelliteSystem& sys,
+        const Vec3& point,
+        size_t k,
+        size_t exclude = SIZE_MAX
+    ) const;
+    
+    // Distance tests performed by the last find_close_pairs call
+    size_t candidates_tested() const { return last_candidates_tested; }
 
 private:
     double cell_size;
@@ -29,6 +80,15 @@ private:
     // Hash map: cell_id -> list of satellite indices
     std::unordered_map<uint64_t, std::vector<size_t>> grid;
     
+    // Occupied cell bounds (inclusive), used to stop ring searches
+    int64_t cell_min[3] = {0, 0, 0};
+    int64_t cell_max[3] = {-1, -1, -1};
+    
+    size_t last_candidates_tested = 0;
+    
+    void clear(size_t expected_count);
+    void insert(const SatelliteSystem& sys, size_t i);
+    
     // Convert position to cell coordinates
     inline int64_t pos_to_cell(double pos) const {
         return static_cast<int64_t>(std::floor(pos * inv_cell_size));
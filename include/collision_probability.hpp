@@ -2,6 +2,7 @@
 
 #include "types.hpp"
 #include "satellite_system.hpp"
+#include "cancellation.hpp"
 #include <random>
 #include <vector>
 
@@ -74,11 +75,13 @@ public:
         double hours_since_epoch2 = 0.0
     );
     
-    // Calculate probability for all conjunctions in a system
+    // Calculate probability for all conjunctions in a system. Checked once per
+    // conjunction; if `cancel` trips, the results computed so far are returned.
     std::vector<ConjunctionProbability> calculate_all(
         const SatelliteSystem& sys,
         const std::vector<Conjunction>& conjunctions,
-        const std::vector<TLE>& tles
+        const std::vector<TLE>& tles,
+        const CancellationToken* cancel = nullptr
     );
     
     // Alternative: Analytical Pc using Foster's method (faster, less accurate)
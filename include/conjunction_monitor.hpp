@@ -0,0 +1,157 @@
+#pragma once
+
+#include "satellite_system.hpp"
+#include "cancellation.hpp"
+#include "collision_optimized.hpp"
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <cstdint>
+
+namespace orbitops {
+
+// Standing look-ahead screening settings
+struct MonitorConfig {
+    double threshold_km = 10.0;        // Screening distance
+    double horizon_minutes = 1440.0;   // Look-ahead window
+    double step_seconds = 60.0;        // Screening step
+    double tca_match_minutes = 10.0;   // Same pair within this TCA gap is the same event
+    double change_fraction = 0.1;      // Relative miss/Pc change reported as CHANGED
+    double collision_radius_km = 0.01; // Combined hard body radius for Pc
+};
+
+// One predicted encounter (closest sampled approach of a pair)
+struct MonitoredConjunction {
+    uint64_t event_id = 0;             // Stable across updates (assigned by the table)
+    uint32_t revision = 0;             // Bumped on every material change
+    uint32_t sat1_id = 0;              // Object indices, sat1_id < sat2_id
+    uint32_t sat2_id = 0;
+    double tca_minutes = 0.0;          // Minutes from epoch
+    double miss_distance_km = 0.0;
+    double relative_velocity_km_s = 0.0;
+    double collision_probability = 0.0;
+};
+
+enum class UpdateKind : uint8_t {
+    NEW = 1,
+    CHANGED = 2,
+    RESOLVED = 3,    // No longer predicted (TCA not yet passed)
+};
+
+struct ConjunctionUpdate {
+    UpdateKind kind;
+    MonitoredConjunction event;
+};
+
+// Merges the close pairs found at successive screening steps into
+// encounters, keeping the closest (TCA-refined) sample of each pass
+class EncounterTracker {
+public:
+    explicit EncounterTracker(const MonitorConfig& config = {});
+
+    // Record the close pairs found at time t; steps must be fed in time order
+    void observe(const SatelliteSystem& sys, const std::vector<ClosePair>& pairs, double t_minutes);
+
+    // Record one pair given the relative state of j with respect to i
+    void observe_pair(uint32_t i, uint32_t j, double t_minutes,
+                      const double rel_pos[3], const double rel_vel[3]);
+
+    // Finish encounters last seen before `t_minutes`
+    std::vector<MonitoredConjunction> close_before(double t_minutes);
+
+    // Finish every open encounter
+    std::vector<MonitoredConjunction> flush();
+
+    // Forget open encounters involving any flagged object
+    void drop(const std::vector<uint8_t>& objects);
+
+    // Renumber objects (old index -> new index, -1 = removed)
+    void remap(const std::vector<int64_t>& old_to_new);
+
+    // Adopt another tracker's open encounters (disjoint pairs)
+    void merge(EncounterTracker&& other);
+
+    size_t open_count() const { return open_.size(); }
+
+    // Best sample so far of each encounter still open
+    std::vector<MonitoredConjunction> open_events() const;
+
+private:
+    struct OpenEncounter {
+        MonitoredConjunction best;
+        double last_seen_minutes;
+    };
+
+    MonitorConfig config_;
+    double gap_minutes_;
+    std::unordered_map<uint64_t, OpenEncounter> open_;   // By pair key
+    std::vector<MonitoredConjunction> finished_;
+};
+
+// Screen [start, end] (minutes from epoch) and reduce per-step hits to one
+// event per encounter. TCA and miss distance are refined by linear relative
+// motion around the closest sample. Returns an empty list if cancelled.
+std::vector<MonitoredConjunction> screen_window(
+    SatelliteSystem& sys,
+    double start_minutes,
+    double end_minutes,
+    const MonitorConfig& config,
+    const CancellationToken* cancel = nullptr
+);
+
+// Current look-ahead event list. Each screening result is diffed against it
+// so subscribers only see new, changed and resolved events.
+class ConjunctionEventTable {
+public:
+    using Events = std::shared_ptr<const std::vector<MonitoredConjunction>>;
+
+    explicit ConjunctionEventTable(const MonitorConfig& config = {});
+
+    // Replace the events with TCA in [from, to] by `screened` (which must
+    // cover that whole range). With `objects`, only events involving a
+    // flagged object are replaced. Events matching an encounter in `open`
+    // (still in progress at the end of the range) are held rather than
+    // resolved, until add() reports how that encounter closed. Returns the
+    // resulting updates.
+    std::vector<ConjunctionUpdate> apply(
+        const std::vector<MonitoredConjunction>& screened,
+        double from_minutes,
+        double to_minutes,
+        const std::vector<uint8_t>* objects = nullptr,
+        const std::vector<MonitoredConjunction>* open = nullptr
+    );
+
+    // Insert newly closed events as NEW. A held event of the same pair is
+    // updated instead when its TCA matches, and resolved otherwise.
+    std::vector<ConjunctionUpdate> add(const std::vector<MonitoredConjunction>& screened);
+
+    // Renumber objects after a catalog re-layout (old index -> new index,
+    // -1 = removed). Events keep their ids; events of removed objects resolve.
+    std::vector<ConjunctionUpdate> remap(const std::vector<int64_t>& old_to_new);
+
+    // Drop events whose TCA has passed (not reported as RESOLVED)
+    size_t expire_before(double now_minutes);
+
+    void clear();
+
+    // Immutable view of the current events, sorted by TCA
+    Events events() const;
+    uint64_t generation() const;
+
+private:
+    MonitorConfig config_;
+    std::unordered_map<uint64_t, MonitoredConjunction> events_;  // By event_id
+    std::unordered_map<uint64_t, uint64_t> held_;                // Pair key -> held event_id
+    uint64_t next_event_id_ = 1;
+    uint64_t generation_ = 0;
+
+    mutable Events view_;             // Rebuilt lazily per generation
+    mutable uint64_t view_generation_ = UINT64_MAX;
+    mutable std::mutex mutex_;
+
+    bool materially_changed(const MonitoredConjunction& before,
+                            const MonitoredConjunction& after) const;
+};
+
+} // namespace orbitops
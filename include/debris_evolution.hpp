@@ -0,0 +1,74 @@
+#pragma once
+
+#include "atmosphere.hpp"
+#include "breakup_model.hpp"
+#include "cancellation.hpp"
+#include "satellite_system.hpp"
+#include "shell_density.hpp"
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace orbitops {
+
+// Long-term environment projection settings
+struct EvolutionConfig {
+    double duration_years = 30.0;
+    double step_days = 1.0;
+    double snapshot_interval_days = 365.25;
+    double reentry_altitude_km = 120.0;   // Objects are removed once their perigee drops below this
+    double max_decay_per_scale_height = 0.05;  // Sub-step limit on |da| / H within one step
+    SolarCycle solar;
+    ShellBinning binning;                 // Snapshot histogram (mean altitude, altitude only)
+};
+
+// A fragmentation scheduled during the projection. `object` indexes the
+// evolved population (initial objects first, then injected fragments in
+// injection order); the event's parent and time are taken from it.
+struct ScheduledBreakup {
+    double time_days = 0.0;
+    uint32_t object = 0;
+    BreakupEvent event;
+};
+
+// Population statistics at one instant
+struct EvolutionSnapshot {
+    double time_days = 0.0;
+    double f107 = 0.0;
+    size_t population = 0;                // Objects in orbit
+    size_t reentered = 0;                 // Cumulative
+    size_t injected = 0;                  // Cumulative breakup fragments
+    size_t broken_up = 0;                 // Cumulative parents removed by breakups
+    size_t leo = 0;
+    size_t meo = 0;
+    size_t geo = 0;
+    size_t heo = 0;
+    double mean_altitude_km = 0.0;
+    std::vector<uint32_t> shell_counts;   // Per binning altitude shell
+};
+
+struct EvolutionResult {
+    bool success = false;
+    std::string error_message;
+    std::vector<EvolutionSnapshot> snapshots;   // At t = 0, every interval, and the end
+    std::vector<float> reentry_days;      // Per evolved object; negative if it never reentered
+    size_t initial_count = 0;
+};
+
+// Project a population (indices into `sys`) forward under drag for years.
+// Semi-major axis and eccentricity are integrated with orbit-averaged
+// King-Hele rates in fixed day steps over the SoA arrays in parallel; each
+// object sub-steps only while its decay is fast relative to the perigee
+// scale height. Density follows an exponential atmosphere scaled by the
+// solar cycle. Scheduled breakups sample the standard breakup model at the
+// parent's current orbit and append the fragments to the population.
+EvolutionResult evolve_debris_environment(
+    const SatelliteSystem& sys,
+    const std::vector<uint32_t>& objects,
+    const EvolutionConfig& config = {},
+    const std::vector<ScheduledBreakup>& breakups = {},
+    const CancellationToken* cancel = nullptr
+);
+
+} // namespace orbitops
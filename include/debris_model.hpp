@@ -2,40 +2,26 @@
 
 #include "types.hpp"
 #include "satellite_system.hpp"
+#include "debris_system.hpp"
+#include "shell_density.hpp"
+#include "collision_optimized.hpp"
+#include "small_debris_flux.hpp"
+#include "debris_evolution.hpp"
+#include "debris_render_buffer.hpp"
+#include "orbit_interval_index.hpp"
+#include "reentry_predictor.hpp"
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <string>
 #include <cmath>
 
 namespace orbitops {
 
-// Space debris classification
-enum class DebrisType {
-    ROCKET_BODY,      // Spent rocket stages
-    PAYLOAD_DEBRIS,   // Fragments from satellite breakups
-    MISSION_DEBRIS,   // Items released during missions
-    FRAGMENTATION,    // Collision/explosion fragments
-    UNKNOWN           // Unclassified debris
-};
-
-// Debris size category (based on trackability)
-enum class DebrisSize {
-    LARGE,            // > 10 cm (trackable by ground radar)
-    MEDIUM,           // 1-10 cm (tracked by some sensors)
-    SMALL             // < 1 cm (modeled statistically)
-};
-
-// Risk level for debris encounters
-enum class DebrisRisk {
-    CRITICAL,         // Immediate collision risk
-    HIGH,             // High risk within 24 hours
-    MEDIUM,           // Moderate risk within week
-    LOW,              // Low risk
-    NEGLIGIBLE        // No significant risk
-};
-
-// Individual debris object
+// One debris object materialized from the DebrisSystem view (RPC and
+// visualization); analytics work on the SoA rows directly
 struct DebrisObject {
-    int id;
+    int id;                       // DebrisSystem row
     std::string name;
     std::string origin;           // Source satellite/event
     DebrisType type;
@@ -52,26 +38,38 @@ struct DebrisObject {
     double created_epoch;         // When debris was created (Julian date)
 };
 
-// Debris field from a fragmentation event
+// Debris field from a fragmentation event: an index set over the catalog
+// with cloud statistics refreshed after each propagation
 struct DebrisField {
     int event_id;
     std::string event_name;
     double event_date;            // Julian date
-    Vec3 event_location;          // ECI position at time of event
-    std::vector<int> debris_ids;  // IDs of debris objects from this event
+    std::vector<int> debris_ids;  // DebrisSystem rows from this event
+    std::vector<uint32_t> indices; // SatelliteSystem index per row (same order)
     int total_fragments;
-    double spread_radius_km;      // Current spread radius
+    
+    // Cloud statistics at stats_epoch_minutes (update_field_statistics)
+    bool has_statistics = false;
+    double stats_epoch_minutes = 0.0;
+    Vec3 centroid;                // Mean ECI position (km)
+    Vec3 mean_velocity;           // Mean ECI velocity (km/s)
+    double spread_radius_km = 0.0;       // RMS distance from the centroid
+    double plane_dispersion_deg = 0.0;   // Angular spread of the orbit normals about their mean
+    double spread_rate_km_per_day = 0.0; // Instantaneous d(spread)/dt from the fragments' relative
+                                         // velocities (independent of earlier updates)
 };
 
 // Configuration for debris model
 struct DebrisConfig {
     bool include_rocket_bodies = true;
     bool include_fragments = true;
-    bool include_small_debris = false;  // Statistical model
+    bool include_small_debris = false;  // Statistical model, built at load
     double min_altitude_km = 150.0;     // Below this altitude, debris will decay
     double max_altitude_km = 50000.0;   // GEO + margin
     int max_debris_objects = 10000;     // Limit for performance
     double small_debris_density = 1e-8; // particles per km³ in LEO
+    double neighborhood_km = 100.0;     // Risk assessment search radius
+    size_t closest_count = 10;          // Closest debris reported per satellite
 };
 
 // Debris model and analytics
@@ -80,22 +78,36 @@ public:
     DebrisModel();
     explicit DebrisModel(const DebrisConfig& config);
     
-    // Load debris from TLE data
-    void load_from_tles(const std::vector<TLE>& tles);
+    // Classify the catalog once. `sys` must be built from `tles` (same order);
+    // debris rows keep their index into it.
+    void load(const std::vector<TLE>& tles, const SatelliteSystem& sys);
     
     // Identify debris vs active satellites
     static bool is_debris(const TLE& tle);
     static DebrisType classify_debris(const TLE& tle);
     static DebrisSize estimate_size(const TLE& tle);
     
-    // Get debris objects
-    const std::vector<DebrisObject>& get_debris() const { return debris_; }
-    std::vector<DebrisObject> get_debris_in_shell(double min_alt, double max_alt) const;
-    std::vector<DebrisObject> get_debris_by_type(DebrisType type) const;
-    std::vector<DebrisObject> get_debris_by_risk(DebrisRisk risk) const;
+    // Debris rows and their classification
+    const DebrisSystem& debris() const { return debris_; }
+    
+    // Materialize one row with its current state from `sys`
+    DebrisObject get_object(uint32_t row, const SatelliteSystem& sys) const;
+    
+    // Materialize rows with their state propagated to `time_minutes` (the
+    // SoA state arrays are not touched). Returns false if `cancel` tripped
+    // (`objects` then incomplete).
+    bool get_objects_at(const std::vector<uint32_t>& rows, const SatelliteSystem& sys, double time_minutes,
+                        std::vector<DebrisObject>& objects, const CancellationToken* cancel = nullptr) const;
     
-    // Update debris positions from SatelliteSystem
-    void update_positions(const SatelliteSystem& sys, const std::vector<TLE>& tles);
+    // Filters: ascending DebrisSystem rows (mean altitude for shells)
+    std::vector<uint32_t> get_debris_in_shell(double min_alt, double max_alt) const;
+    std::vector<uint32_t> get_debris_by_type(DebrisType type) const;
+    std::vector<uint32_t> get_debris_by_risk(DebrisRisk risk) const;
+    
+    // Debris rows whose perigee-apogee altitude range crosses the band,
+    // answered by the catalog interval index (in sync with the loaded system)
+    std::vector<uint32_t> get_debris_crossing(const OrbitIntervalIndex& bands,
+                                              double min_alt, double max_alt) const;
     
     // Debris analytics
     struct ShellDensity {
@@ -106,7 +118,22 @@ public:
         double flux;              // objects crossing per m² per year
     };
     
-    std::vector<ShellDensity> calculate_shell_densities(double shell_thickness = 50.0) const;
+    // LEO shells (200-2000 km by mean altitude), from the cached histogram
+    std::vector<ShellDensity> calculate_shell_densities(
+        const SatelliteSystem& sys,
+        double shell_thickness = 50.0
+    ) const;
+    
+    // Shell density histogram, built once per catalog version (and per
+    // position epoch when binning by current altitude) and then shared
+    std::shared_ptr<const ShellDensityTable> shell_densities(
+        const SatelliteSystem& sys,
+        const ShellBinning& binning = {},
+        double epoch_minutes = 0.0
+    ) const;
+    
+    // Incremented by every load()
+    uint64_t catalog_version() const { return catalog_version_; }
     
     // Risk assessment for a satellite
     struct DebrisRiskAssessment {
@@ -118,14 +145,64 @@ public:
     };
     
     DebrisRiskAssessment assess_risk(
+        const SatelliteSystem& sys,
         int satellite_id,
         const Vec3& sat_position,
         double altitude_km
     ) const;
     
+    // Assess every fleet member (indices into `sys`, propagated to
+    // `epoch_minutes`) in parallel against a spatial index of debris
+    // positions. The index is built once per catalog version and epoch.
+    std::vector<DebrisRiskAssessment> assess_risk_fleet(
+        const SatelliteSystem& sys,
+        const std::vector<uint32_t>& fleet,
+        double epoch_minutes
+    ) const;
+    
+    // Small-debris flux table (empty unless include_small_debris)
+    const SmallDebrisFluxTable& small_debris_flux() const { return small_debris_flux_; }
+    
+    // Orbit-averaged small-debris flux and penetration risk per fleet member
+    std::vector<SmallDebrisAssessment> assess_small_debris(
+        const SatelliteSystem& sys,
+        const std::vector<uint32_t>& fleet,
+        const SmallDebrisExposure& exposure = {}
+    ) const;
+    
+    // Project the debris population forward under drag (evolved objects are
+    // debris rows in order, then fragments from `breakups`)
+    EvolutionResult evolve_environment(
+        const SatelliteSystem& sys,
+        const EvolutionConfig& config = {},
+        const std::vector<ScheduledBreakup>& breakups = {},
+        const CancellationToken* cancel = nullptr
+    ) const;
+    
+    // Replace the heuristic decay estimate of debris rows with the nominal
+    // predicted reentry and re-derive their risk. Matches by catalog
+    // number, so `report` may come from an earlier build of the catalog.
+    // Returns the number of rows updated.
+    size_t apply_reentry_predictions(const ReentryReport& report, const SatelliteSystem& sys);
+    
+    // Render arrays (attributes built at load); positions are refreshed by
+    // update_render_positions. Not thread-safe: callers serialize with the
+    // catalog.
+    const DebrisRenderBuffer& render_buffer() const { return render_buffer_; }
+    bool update_render_positions(const SatelliteSystem& sys, double time_minutes,
+                                 const CancellationToken* cancel = nullptr) {
+        return render_buffer_.update_positions(sys, time_minutes, cancel);
+    }
+    
     // Get debris fields
     const std::vector<DebrisField>& get_debris_fields() const { return debris_fields_; }
     
+    // Refresh every field's cloud statistics from the states in `sys`,
+    // which must be propagated to `epoch_minutes`: one vectorized reduction
+    // per field, fields in parallel. A repeated epoch is a no-op. Not
+    // thread-safe: callers serialize with the catalog.
+    void update_field_statistics(const SatelliteSystem& sys, double epoch_minutes);
+    
     // Statistics
     struct Statistics {
         int total_debris;
@@ -137,45 +214,51 @@ public:
         int geo_debris;       // > 35786 km
         double average_altitude_km;
         double max_density_altitude_km;
+        int predicted_reentries;  // Decay from the reentry predictor
     };
     
     Statistics get_statistics() const;
 
 private:
     DebrisConfig config_;
-    std::vector<DebrisObject> debris_;
+    DebrisSystem debris_;
+    std::vector<int32_t> row_of_;         // SatelliteSystem index -> debris row (-1 if not debris)
     std::vector<DebrisField> debris_fields_;
+    SmallDebrisFluxTable small_debris_flux_;
+    DebrisRenderBuffer render_buffer_;
+    uint64_t catalog_version_ = 0;
+    size_t predicted_reentries_ = 0;
+    
+    // Shell density tables, one per binning in use
+    static constexpr size_t MAX_DENSITY_TABLES = 8;
+    mutable std::mutex density_mutex_;
+    mutable std::vector<std::shared_ptr<const ShellDensityTable>> density_tables_;
+    
+    // Spatial index over debris positions at one epoch
+    struct PositionIndex {
+        uint64_t catalog_version = 0;
+        double epoch_minutes = 0.0;
+        SpatialGrid grid;
+        std::vector<int32_t> row_of;     // SatelliteSystem index -> debris row (-1 = not debris)
+        
+        explicit PositionIndex(double cell_size_km) : grid(cell_size_km) {}
+    };
+    mutable std::mutex index_mutex_;
+    mutable std::shared_ptr<const PositionIndex> position_index_;
+    
+    std::shared_ptr<const PositionIndex> position_index(const SatelliteSystem& sys, double epoch_minutes) const;
+    
+    // Overall risk from the sorted closest debris and the neighbourhood count
+    static DebrisRisk classify_risk(const DebrisRiskAssessment& assessment);
     
     // Known debris events (Cosmos-Iridium, Chinese ASAT test, etc.)
     void identify_debris_fields();
     
-    // Estimate RCS from TLE data
-    static double estimate_rcs(const TLE& tle);
+    // Estimate RCS from size and type
+    static double estimate_rcs(DebrisSize size, DebrisType type);
     
     // Calculate decay time estimate
-    static int estimate_decay_days(const TLE& tle);
-};
-
-// Debris visualization helper
-struct DebrisVisualizationData {
-    std::vector<float> positions;    // x,y,z interleaved
-    std::vector<float> colors;       // r,g,b interleaved
-    std::vector<float> sizes;        // point sizes
-    std::vector<int> ids;            // debris IDs
-};
-
-DebrisVisualizationData prepare_debris_for_visualization(
-    const std::vector<DebrisObject>& debris,
-    double scale_factor = 1.0 / 6371.0  // Normalize to Earth radius
-);
-
-// Color scheme for debris types
-struct DebrisColors {
-    static constexpr float ROCKET_BODY[3] = {1.0f, 0.4f, 0.0f};     // Orange
-    static constexpr float PAYLOAD_DEBRIS[3] = {1.0f, 0.2f, 0.2f};  // Red
-    static constexpr float FRAGMENTATION[3] = {0.8f, 0.8f, 0.0f};   // Yellow
-    static constexpr float MISSION_DEBRIS[3] = {0.6f, 0.6f, 0.6f};  // Gray
-    static constexpr float UNKNOWN[3] = {0.5f, 0.5f, 0.5f};         // Dark gray
+    static int estimate_decay_days(double altitude_km, double bstar);
 };
 
 } // namespace orbitops
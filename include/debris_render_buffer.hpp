@@ -0,0 +1,70 @@
+#pragma once
+
+#include "debris_system.hpp"
+#include "satellite_system.hpp"
+#include "cancellation.hpp"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace orbitops {
+
+// Color scheme for debris types
+struct DebrisColors {
+    static constexpr float ROCKET_BODY[3] = {1.0f, 0.4f, 0.0f};     // Orange
+    static constexpr float PAYLOAD_DEBRIS[3] = {1.0f, 0.2f, 0.2f};  // Red
+    static constexpr float FRAGMENTATION[3] = {0.8f, 0.8f, 0.0f};   // Yellow
+    static constexpr float MISSION_DEBRIS[3] = {0.6f, 0.6f, 0.6f};  // Gray
+    static constexpr float UNKNOWN[3] = {0.5f, 0.5f, 0.5f};         // Dark gray
+};
+
+// Persistent render arrays for the debris population, one entry per
+// DebrisSystem row. Ids, colors and point sizes are static per catalog and
+// written once by build(); positions are float32 xyz written straight by
+// the propagation kernel for the debris indices only, so refreshing a view
+// at an epoch already held costs nothing and a full view is one memcpy.
+class DebrisRenderBuffer {
+public:
+    static constexpr double DEFAULT_SCALE = 1.0 / 6371.0;   // Normalize to Earth radius
+
+    void build(const DebrisSystem& debris, uint64_t catalog_version, double scale_factor = DEFAULT_SCALE);
+
+    // Propagate the debris objects of `sys` to `time_minutes` unless the
+    // buffer already holds that epoch. Returns false if cancelled; the
+    // positions are then marked stale.
+    bool update_positions(const SatelliteSystem& sys, double time_minutes,
+                          const CancellationToken* cancel = nullptr);
+
+    size_t count() const { return ids_.size(); }
+    uint64_t catalog_version() const { return catalog_version_; }
+    bool has_positions() const { return positions_valid_; }
+    double epoch_minutes() const { return epoch_minutes_; }
+    double scale_factor() const { return scale_factor_; }
+    double max_altitude_km() const { return max_altitude_km_; }   // Highest mean altitude
+
+    const std::vector<int32_t>& ids() const { return ids_; }           // DebrisSystem rows
+    const std::vector<float>& positions() const { return positions_; } // x,y,z interleaved
+    const std::vector<float>& colors() const { return colors_; }       // r,g,b interleaved
+    const std::vector<float>& sizes() const { return sizes_; }         // Point sizes
+
+    // Copy the arrays for ascending `rows` into caller-owned memory (3
+    // floats per row for positions and colors); the full population is a
+    // straight memcpy. Null outputs are skipped.
+    void gather(const std::vector<uint32_t>& rows, int32_t* ids, float* positions,
+                float* colors, float* sizes) const;
+
+private:
+    uint64_t catalog_version_ = 0;
+    double scale_factor_ = DEFAULT_SCALE;
+    double max_altitude_km_ = 0.0;
+    bool positions_valid_ = false;
+    double epoch_minutes_ = 0.0;
+
+    std::vector<uint32_t> index_;         // SatelliteSystem index per row
+    std::vector<int32_t> ids_;
+    std::vector<float> positions_;
+    std::vector<float> colors_;
+    std::vector<float> sizes_;
+};
+
+} // namespace orbitops
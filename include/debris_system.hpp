@@ -0,0 +1,112 @@
+#pragma once
+
+#include "satellite_system.hpp"
+#include <vector>
+#include <string>
+#include <cstdint>
+
+namespace orbitops {
+
+// Space debris classification
+enum class DebrisType {
+    ROCKET_BODY,      // Spent rocket stages
+    PAYLOAD_DEBRIS,   // Fragments from satellite breakups
+    MISSION_DEBRIS,   // Items released during missions
+    FRAGMENTATION,    // Collision/explosion fragments
+    UNKNOWN           // Unclassified debris
+};
+
+// Debris size category (based on trackability)
+enum class DebrisSize {
+    LARGE,            // > 10 cm (trackable by ground radar)
+    MEDIUM,           // 1-10 cm (tracked by some sensors)
+    SMALL             // < 1 cm (modeled statistically)
+};
+
+// Risk level for debris encounters
+enum class DebrisRisk {
+    CRITICAL,         // Immediate collision risk
+    HIGH,             // High risk within 24 hours
+    MEDIUM,           // Moderate risk within week
+    LOW,              // Low risk
+    NEGLIGIBLE        // No significant risk
+};
+
+// Orbit regime by mean altitude (HEO takes precedence for eccentric orbits)
+enum class OrbitRegime {
+    LEO,              // < 2000 km
+    MEO,              // 2000-35586 km
+    GEO,              // 35586-35986 km
+    HEO               // Eccentricity > 0.25
+};
+
+// Classification bits, one word per debris object. Each group holds exactly
+// one set bit so that filters are a single AND against the word.
+enum DebrisFlag : uint32_t {
+    DEBRIS_TYPE_SHIFT   = 0,      // DebrisType
+    DEBRIS_SIZE_SHIFT   = 8,      // DebrisSize
+    DEBRIS_RISK_SHIFT   = 16,     // DebrisRisk (baseline hazard)
+    DEBRIS_REGIME_SHIFT = 24,     // OrbitRegime
+
+    DEBRIS_TYPE_MASK    = 0xFFu << DEBRIS_TYPE_SHIFT,
+    DEBRIS_SIZE_MASK    = 0xFFu << DEBRIS_SIZE_SHIFT,
+    DEBRIS_RISK_MASK    = 0xFFu << DEBRIS_RISK_SHIFT,
+    DEBRIS_REGIME_MASK  = 0xFFu << DEBRIS_REGIME_SHIFT,
+};
+
+inline uint32_t debris_flag(DebrisType type)    { return 1u << (DEBRIS_TYPE_SHIFT + static_cast<uint32_t>(type)); }
+inline uint32_t debris_flag(DebrisSize size)    { return 1u << (DEBRIS_SIZE_SHIFT + static_cast<uint32_t>(size)); }
+inline uint32_t debris_flag(DebrisRisk risk)    { return 1u << (DEBRIS_RISK_SHIFT + static_cast<uint32_t>(risk)); }
+inline uint32_t debris_flag(OrbitRegime regime) { return 1u << (DEBRIS_REGIME_SHIFT + static_cast<uint32_t>(regime)); }
+
+// Decode one group of a flag word
+DebrisType debris_type(uint32_t flags);
+DebrisSize debris_size(uint32_t flags);
+DebrisRisk debris_risk(uint32_t flags);
+OrbitRegime orbit_regime(uint32_t flags);
+
+// Regime of an orbit from its mean altitude (km, 6371 km sphere) and eccentricity
+OrbitRegime classify_orbit_regime(double mean_altitude_km, double eccentricity);
+
+// Debris as a view over a SatelliteSystem: one row per debris object holding
+// its SoA index and everything derived once at ingest. Positions and
+// velocities are never copied; read them from the system through `index`.
+struct DebrisSystem {
+    size_t count = 0;
+
+    // Hot data - scanned by filters and analytics
+    std::vector<uint32_t> index;             // Row in the SatelliteSystem
+    std::vector<uint32_t> flags;             // DebrisFlag bits
+    std::vector<double> mean_altitude_km;    // a - R_earth at epoch
+    std::vector<double> perigee_km;
+    std::vector<double> apogee_km;
+
+    // Physical estimates
+    std::vector<float> rcs_m2;
+    std::vector<float> mass_kg;
+    std::vector<int32_t> decay_days;         // -1 if stable
+
+    // Cold data
+    std::vector<uint32_t> launch;            // Designator YYNNN as an integer (0 = unknown)
+    std::vector<std::string> designator;
+    std::vector<double> epoch_jd;
+
+    void clear();
+    void reserve(size_t n);
+};
+
+// Debris rows matching `mask`: bits within a group are ORed, groups are
+// ANDed, and a group with no bits set passes everything. For example
+// debris_flag(OrbitRegime::LEO) | debris_flag(DebrisSize::LARGE) |
+// debris_flag(DebrisSize::MEDIUM) selects large or medium LEO debris.
+// Ascending row order.
+std::vector<uint32_t> select_debris(const DebrisSystem& debris, uint32_t mask);
+
+// Debris rows with mean altitude in [min_alt_km, max_alt_km], ascending
+std::vector<uint32_t> select_debris_in_shell(
+    const DebrisSystem& debris,
+    double min_alt_km,
+    double max_alt_km
+);
+
+} // namespace orbitops
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "stage_metrics.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace orbitops {
+
+// Configuration for the slow-request flight recorder
+struct FlightRecorderConfig {
+    size_t capacity = 256;                       // Recent requests kept in memory
+    double default_slo_ms = 1000.0;              // Latency above which a request is dumped
+    std::unordered_map<std::string, double> method_slo_ms;  // Per-method overrides
+    std::string dump_directory = "flight_recorder";
+    size_t max_dumps = 100;                      // Files written per process
+    double min_dump_interval_seconds = 10.0;     // Slow requests closer together are counted, not dumped
+    size_t max_param_bytes = 64 * 1024;          // Request description cap
+};
+
+// One finished request
+struct RequestRecord {
+    uint64_t id = 0;
+    const char* method = "";                     // Static string
+    uint64_t catalog_version = 0;
+    std::chrono::system_clock::time_point wall_start;
+    uint64_t start_cycles = 0;                   // cycle_count() at start (trace window)
+    double duration_ms = 0.0;
+    StageTimings timings;
+    std::string params;                          // Only captured for slow requests
+    bool slow = false;
+};
+
+// Always-on, bounded-memory record of recent requests. Finishing a request
+// costs one short critical section; requests over their latency SLO are
+// described (request parameters, catalog version, stage timings, recent
+// requests and buffered trace spans) and written to a JSON file by a
+// background thread, so the slow request does not also pay for the dump.
+class FlightRecorder {
+public:
+    using Describe = std::function<std::string()>;
+
+    explicit FlightRecorder(const FlightRecorderConfig& config = {});
+    ~FlightRecorder();
+
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    // Scoped request: timed from construction to destruction. `describe`
+    // renders the request parameters and is only called if it is slow.
+    class Request {
+    public:
+        Request(FlightRecorder& recorder, const char* method, uint64_t catalog_version,
+                Describe describe = nullptr);
+        ~Request();
+
+        Request(const Request&) = delete;
+        Request& operator=(const Request&) = delete;
+
+        StageTimings& timings() { return record_.timings; }
+
+        // Stop the clock early (e.g. before a blocking stream write)
+        void finish();
+
+    private:
+        FlightRecorder& recorder_;
+        RequestRecord record_;
+        Describe describe_;
+        bool finished_ = false;
+    };
+
+    double slo_ms(const std::string& method) const;
+
+    // Most recent requests, oldest first
+    std::vector<RequestRecord> recent() const;
+
+    // Block until queued dumps are written
+    void flush();
+
+    struct Stats {
+        size_t requests = 0;
+        size_t slow_requests = 0;
+        size_t dumps_written = 0;
+        size_t dumps_suppressed = 0;   // Rate-limited, over max_dumps, or write failed
+    };
+    Stats get_stats() const;
+
+private:
+    struct Dump {
+        RequestRecord request;
+        std::vector<RequestRecord> recent;
+        double slo_ms;
+    };
+
+    FlightRecorderConfig config_;
+
+    mutable std::mutex mutex_;
+    std::deque<RequestRecord> recent_;
+    uint64_t next_id_ = 1;
+    Stats stats_;
+    std::chrono::steady_clock::time_point last_dump_{};
+
+    // Dump writer
+    std::deque<Dump> pending_;
+    std::condition_variable pending_cv_;
+    std::condition_variable idle_cv_;
+    size_t in_flight_ = 0;     // Claimed dumps not yet written (queued or writing)
+    bool stop_ = false;
+    std::thread writer_;
+
+    void finish(RequestRecord&& record, const Describe& describe);
+    void writer_loop();
+    bool write_dump(const Dump& dump) const;
+};
+
+} // namespace orbitops
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <memory>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+
+namespace orbitops {
+
+// Payload formats stored in the frame cache
+enum class FrameEncoding : uint64_t {
+    POSITION_BATCH = 1,      // Serialized PositionBatch
+    CONJUNCTION_BATCH = 2,   // Serialized ConjunctionBatch (empty = no conjunctions)
+    CATALOG_PAGE = 3,        // Serialized CatalogResponse page (timestamp = page offset)
+};
+
+// Cache key: one encoded frame per (catalog version, timestamp, encoding)
+struct FrameKey {
+    uint64_t catalog_version = 0;
+    double timestamp = 0.0;      // Unix timestamp of the frame
+    uint64_t encoding = 0;       // FrameEncoding, optionally mixed with request parameters
+
+    bool operator==(const FrameKey& other) const {
+        return catalog_version == other.catalog_version &&
+               timestamp == other.timestamp &&
+               encoding == other.encoding;
+    }
+};
+
+struct FrameKeyHash {
+    size_t operator()(const FrameKey& key) const {
+        uint64_t t_bits;
+        std::memcpy(&t_bits, &key.timestamp, sizeof(t_bits));
+        uint64_t h = key.catalog_version * 0x9E3779B97F4A7C15ULL;
+        h ^= t_bits + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+        h ^= key.encoding + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+        return static_cast<size_t>(h);
+    }
+};
+
+// Mix a request parameter into an encoding tag (e.g. screening threshold)
+inline uint64_t frame_encoding(FrameEncoding base, double parameter = 0.0) {
+    uint64_t p_bits;
+    std::memcpy(&p_bits, &parameter, sizeof(p_bits));
+    return static_cast<uint64_t>(base) ^ (p_bits * 0xBF58476D1CE4E5B9ULL);
+}
+
+// Row range of one GetCatalog page over `total` objects, in 64-bit so
+// client-supplied offsets and sizes cannot overflow. Negative values count
+// as 0; page_size 0 returns the rest of the catalog.
+struct CatalogPage {
+    int64_t begin = 0;
+    int64_t end = 0;
+    int64_t next_offset = 0;     // 0 on the last page
+};
+
+inline CatalogPage catalog_page(int64_t total, int64_t page_offset, int64_t page_size) {
+    CatalogPage page;
+    page.begin = std::clamp<int64_t>(page_offset, 0, total);
+    page.end = page_size > 0 ? std::min(total, page.begin + page_size) : total;
+    page.next_offset = page.end < total ? page.end : 0;
+    return page;
+}
+
+// Cache key of a catalog page (timestamp = page offset)
+inline FrameKey catalog_page_key(uint64_t catalog_version, int64_t page_offset, int64_t page_size) {
+    return {catalog_version, static_cast<double>(std::max<int64_t>(page_offset, 0)),
+            frame_encoding(FrameEncoding::CATALOG_PAGE, static_cast<double>(std::max<int64_t>(page_size, 0)))};
+}
+
+// Thread-safe LRU cache of already-encoded frames with a memory budget.
+// Frames are immutable and shared, so a hit costs one refcount increment.
+class FrameCache {
+public:
+    using Frame = std::shared_ptr<const std::string>;
+
+    explicit FrameCache(size_t max_bytes = 256 * 1024 * 1024);
+
+    // Returns nullptr on miss
+    Frame get(const FrameKey& key);
+
+    // Insert (or replace) a frame; evicts least recently used frames over budget
+    void put(const FrameKey& key, std::string payload);
+
+    // Drop all frames encoded against catalogs older than `catalog_version`
+    void invalidate_before(uint64_t catalog_version);
+    void clear();
+
+    void set_max_bytes(size_t max_bytes);
+    size_t max_bytes() const;
+
+    // Statistics
+    struct Stats {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t insertions = 0;
+        size_t evictions = 0;
+        size_t entries = 0;
+        size_t bytes = 0;
+        size_t max_bytes = 0;
+
+        double hit_rate() const {
+            size_t lookups = hits + misses;
+            return lookups > 0 ? static_cast<double>(hits) / lookups : 0.0;
+        }
+    };
+    Stats get_stats() const;
+
+private:
+    struct Entry {
+        FrameKey key;
+        Frame frame;
+        size_t bytes;
+    };
+
+    // Front = most recently used
+    std::list<Entry> lru_;
+    std::unordered_map<FrameKey, std::list<Entry>::iterator, FrameKeyHash> index_;
+
+    size_t max_bytes_;
+    size_t bytes_ = 0;
+    Stats stats_;
+    mutable std::mutex mutex_;
+
+    // Estimated footprint of one cached frame (payload + bookkeeping)
+    static size_t entry_bytes(const std::string& payload) {
+        return payload.capacity() + sizeof(Entry) + sizeof(std::string) + 64;
+    }
+
+    void evict_to_budget();
+};
+
+} // namespace orbitops
@@ -10,9 +10,28 @@
 
 namespace orbitops {
 
+// Server tuning options
+struct ServerConfig {
+    size_t frame_cache_bytes = 256 * 1024 * 1024;  // Memory budget for encoded frames
+    size_t stream_window = 4;                       // Outstanding frames per stream before skipping
+
+    // Standing conjunction screener (started by the first alert subscriber)
+    double monitor_horizon_hours = 168.0;
+    double monitor_step_seconds = 30.0;
+    double monitor_threshold_km = 10.0;
+    double monitor_interval_seconds = 30.0;         // Period for screening newly entered slices
+
+    uint16_t metrics_port = 0;                      // Prometheus endpoint on 127.0.0.1 (0 = off)
+
+    // Slow-request flight recorder
+    double slow_request_ms = 1000.0;                // Latency SLO per request / stream step
+    std::string flight_recorder_dir = "flight_recorder";
+};
+
 class OrbitOpsServer {
 public:
-    OrbitOpsServer(const std::string& tle_file, uint16_t port = 50051);
+    OrbitOpsServer(const std::string& tle_file, uint16_t port = 50051,
+                   const ServerConfig& config = {});
     ~OrbitOpsServer();
 
     // Run the server (blocking)
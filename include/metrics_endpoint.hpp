@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace orbitops {
+
+// Minimal HTTP endpoint on the loopback interface serving a Prometheus text
+// page at GET /metrics, plus any extra pages added with add_route(). One
+// connection is handled at a time; pages are rendered per request.
+class MetricsEndpoint {
+public:
+    using Render = std::function<std::string()>;
+
+    // Port 0 binds an ephemeral port (see port())
+    MetricsEndpoint(uint16_t port, Render render);
+    ~MetricsEndpoint();
+
+    MetricsEndpoint(const MetricsEndpoint&) = delete;
+    MetricsEndpoint& operator=(const MetricsEndpoint&) = delete;
+
+    // Serve `render` at GET `path` (call before start())
+    void add_route(const std::string& path, const std::string& content_type, Render render);
+
+    // Bind and start serving; returns false if the port cannot be bound
+    bool start();
+    void stop();
+
+    uint16_t port() const { return port_; }
+    bool running() const { return running_.load(); }
+
+private:
+    struct Route {
+        std::string path;
+        std::string content_type;
+        Render render;
+    };
+
+    uint16_t port_;
+    std::vector<Route> routes_;
+    int listen_fd_ = -1;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+
+    void serve();
+    void handle(int fd);
+};
+
+} // namespace orbitops
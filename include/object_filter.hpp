@@ -0,0 +1,74 @@
+#pragma once
+
+#include "satellite_system.hpp"
+#include "orbit_interval_index.hpp"
+#include <vector>
+#include <cstdint>
+#include <limits>
+
+namespace orbitops {
+
+// Half-space n·p + d >= 0 in ECI coordinates (km); a camera frustum is 6 of these
+struct HalfSpace {
+    double nx = 0.0;
+    double ny = 0.0;
+    double nz = 0.0;
+    double d = 0.0;
+};
+
+// Request-level predicates for position streams (ROI filtering).
+// All predicates are ANDed; an unset predicate passes everything.
+struct ObjectFilter {
+    std::vector<int> ids;                  // Object indices (empty = all)
+
+    double min_altitude_km = -std::numeric_limits<double>::infinity();
+    double max_altitude_km = std::numeric_limits<double>::infinity();
+    double min_inclination_deg = -std::numeric_limits<double>::infinity();
+    double max_inclination_deg = std::numeric_limits<double>::infinity();
+
+    // Orbit crossing band: the perigee-apogee altitude range intersects it
+    double min_orbit_altitude_km = -std::numeric_limits<double>::infinity();
+    double max_orbit_altitude_km = std::numeric_limits<double>::infinity();
+
+    uint8_t class_mask = 0;                // ObjectClass bits (0 = all classes)
+
+    // Geocentric latitude/longitude box (degrees, min_lon > max_lon wraps the antimeridian)
+    bool has_geo_box = false;
+    double min_lat_deg = -90.0;
+    double max_lat_deg = 90.0;
+    double min_lon_deg = -180.0;
+    double max_lon_deg = 180.0;
+
+    std::vector<HalfSpace> frustum;       // Empty = no view culling
+
+    // True when no predicate is set (stream the full catalog)
+    bool is_pass_through() const;
+
+    // Stable hash of all predicates (used to key cached frames)
+    uint64_t hash() const;
+};
+
+// Evaluate all predicates into a byte mask (1 = keep) over the SoA.
+// Positions must already be propagated; `gmst_rad` rotates ECI to Earth-fixed
+// longitude for the geo box. The orbit crossing band is answered by `bands`
+// when given (it must be in sync with `sys`), else from the elements.
+void evaluate_filter_mask(
+    const SatelliteSystem& sys,
+    const ObjectFilter& filter,
+    double gmst_rad,
+    uint8_t* mask,
+    const OrbitIntervalIndex* bands = nullptr
+);
+
+// Indices of objects that pass the filter, in ascending order
+std::vector<uint32_t> select_filtered(
+    const SatelliteSystem& sys,
+    const ObjectFilter& filter,
+    double gmst_rad,
+    const OrbitIntervalIndex* bands = nullptr
+);
+
+// Greenwich mean sidereal time (radians) for a Unix timestamp
+double gmst_from_unix(double unix_seconds);
+
+} // namespace orbitops
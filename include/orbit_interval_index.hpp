@@ -0,0 +1,64 @@
+#pragma once
+
+#include "satellite_system.hpp"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace orbitops {
+
+// Radial shells of the interval index. The first shell also holds
+// everything below min_radius_km and the last everything above
+// max_radius_km, so queries outside the range stay correct (only slower).
+struct OrbitIntervalConfig {
+    double min_radius_km = 6478.137;     // 100 km altitude
+    double max_radius_km = 8378.137;     // 2000 km altitude
+    double shell_km = 10.0;
+};
+
+// Index over each object's [perigee, apogee] radius range (from a0 and
+// ecc) for the whole catalog. One bitmap per radial shell marks the
+// objects whose range touches it; a range query ORs the bitmaps of the
+// shells it spans, then refines the candidates against the exact
+// endpoints. Objects are re-indexed individually, so catalog updates only
+// touch the objects whose elements changed. Not thread-safe: callers
+// serialize with the catalog.
+class OrbitIntervalIndex {
+public:
+    explicit OrbitIntervalIndex(const OrbitIntervalConfig& config = {});
+
+    void build(const SatelliteSystem& sys);
+
+    // Bring the index up to date with `sys`: objects whose range changed
+    // are re-indexed in place; a different object count rebuilds. Returns
+    // the number of objects re-indexed.
+    size_t sync(const SatelliteSystem& sys);
+
+    size_t count() const { return perigee_.size(); }
+    size_t shell_count() const { return shells_; }
+    double perigee_radius_km(uint32_t i) const { return perigee_[i]; }
+    double apogee_radius_km(uint32_t i) const { return apogee_[i]; }
+
+    // Objects whose radius range intersects [min_radius_km, max_radius_km],
+    // in ascending order
+    std::vector<uint32_t> query(double min_radius_km, double max_radius_km) const;
+
+    // AND the same predicate into a byte mask over the catalog
+    void and_mask(double min_radius_km, double max_radius_km, uint8_t* mask) const;
+
+private:
+    OrbitIntervalConfig config_;
+    size_t shells_ = 0;
+    size_t words_ = 0;                    // 64-bit words per shell bitmap
+    std::vector<double> perigee_;         // km (radius)
+    std::vector<double> apogee_;
+    std::vector<uint64_t> bits_;          // [shell][word]
+
+    size_t shell_of(double radius_km) const;
+    void mark(uint32_t i, bool set);
+
+    // OR of the shell bitmaps covering the range, for word w
+    uint64_t candidates(size_t first_shell, size_t last_shell, size_t w) const;
+};
+
+} // namespace orbitops
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "satellite_system.hpp"
+#include "cancellation.hpp"
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace orbitops {
+
+// Adaptive sampling controls for orbit path rendering
+struct OrbitPathSampling {
+    double tolerance_km = 1.0;     // Max deviation of a straight segment from the arc
+    double max_turn_deg = 5.0;     // Max change of flight direction per segment
+    double min_step_s = 1.0;
+    double max_step_s = 600.0;
+    size_t max_samples = 2048;     // Per path; raises the minimum step for long windows
+};
+
+// One object's sampled path (ECI, km)
+struct SampledPath {
+    uint32_t index = 0;
+    std::vector<double> times_minutes;   // Minutes from epoch
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+};
+
+// Sample the paths of the selected objects between start and end (minutes
+// from epoch). Only the selected objects are propagated. The step follows
+// local path curvature, so eccentric orbits are dense near perigee and sparse
+// near apogee. If end <= start, each path covers one revolution of its object.
+// Out-of-range indices yield empty paths; a tripped token leaves the
+// remaining paths empty.
+std::vector<SampledPath> sample_orbit_paths(
+    const SatelliteSystem& sys,
+    const std::vector<uint32_t>& indices,
+    double start_minutes,
+    double end_minutes,
+    const OrbitPathSampling& sampling = {},
+    const CancellationToken* cancel = nullptr
+);
+
+} // namespace orbitops
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+namespace orbitops {
+
+// Per-stream write pressure statistics
+struct PacedWriterStats {
+    size_t frames_written = 0;
+    size_t frames_dropped = 0;        // Intermediate frames skipped for a slow client
+    size_t queue_depth = 0;           // Frames currently outstanding
+    size_t max_queue_depth = 0;
+    double oldest_frame_age_ms = 0.0; // Lag of the oldest outstanding frame
+    double max_write_latency_ms = 0.0;
+    double total_write_time_ms = 0.0;
+};
+
+// Decouples frame production from blocking network writes.
+//
+// The producer pushes frames into a bounded window that a dedicated writer
+// thread drains through `sink`. When the window is full, a droppable frame
+// (an intermediate position frame) replaces the newest droppable frame still
+// queued, so a slow client skips ahead instead of stalling the producer.
+// Non-droppable frames (conjunction events) are never skipped; the producer
+// waits for space instead. Written frames are recycled through `acquire()`
+// so their allocations are reused.
+template <typename Frame>
+class PacedWriter {
+public:
+    using Sink = std::function<bool(const Frame&)>;
+
+    explicit PacedWriter(Sink sink, size_t window = 4)
+        : sink_(std::move(sink)), window_(std::max<size_t>(window, 1))
+    {
+        thread_ = std::thread([this] { write_loop(); });
+    }
+
+    ~PacedWriter() { close(); }
+
+    PacedWriter(const PacedWriter&) = delete;
+    PacedWriter& operator=(const PacedWriter&) = delete;
+
+    // Get an empty-or-recycled frame (callers clear it before filling)
+    std::unique_ptr<Frame> acquire() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pool_.empty()) return std::make_unique<Frame>();
+        auto frame = std::move(pool_.back());
+        pool_.pop_back();
+        return frame;
+    }
+
+    // Queue a frame for writing. Returns false once the sink has failed
+    // (client disconnected); the frame is discarded in that case.
+    bool push(std::unique_ptr<Frame> frame, bool droppable) {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        if (queue_.size() >= window_ && droppable && !failed_) {
+            // Skip the newest queued intermediate frame in favour of this one
+            for (auto it = queue_.rbegin(); it != queue_.rend(); ++it) {
+                if (it->droppable) {
+                    recycle(std::move(it->frame));
+                    queue_.erase(std::next(it).base());
+                    stats_.frames_dropped++;
+                    break;
+                }
+            }
+        }
+
+        space_cv_.wait(lock, [this] { return failed_ || queue_.size() < window_; });
+        if (failed_) return false;
+
+        queue_.push_back({std::move(frame), droppable, std::chrono::steady_clock::now()});
+        stats_.max_queue_depth = std::max(stats_.max_queue_depth, queue_.size());
+        work_cv_.notify_one();
+        return true;
+    }
+
+    // Flush outstanding frames and stop the writer thread.
+    // Returns false if any write failed.
+    bool close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        work_cv_.notify_one();
+        if (thread_.joinable()) thread_.join();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        return !failed_;
+    }
+
+    PacedWriterStats get_stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        PacedWriterStats stats = stats_;
+        stats.queue_depth = queue_.size();
+        if (!queue_.empty()) {
+            stats.oldest_frame_age_ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - queue_.front().enqueued).count();
+        }
+        return stats;
+    }
+
+private:
+    struct Pending {
+        std::unique_ptr<Frame> frame;
+        bool droppable;
+        std::chrono::steady_clock::time_point enqueued;
+    };
+
+    Sink sink_;
+    size_t window_;
+
+    std::deque<Pending> queue_;
+    std::vector<std::unique_ptr<Frame>> pool_;
+    bool closed_ = false;
+    bool failed_ = false;
+    PacedWriterStats stats_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable space_cv_;
+    std::thread thread_;
+
+    // Caller holds mutex_; keeps at most window + 1 spare frames
+    void recycle(std::unique_ptr<Frame> frame) {
+        if (pool_.size() <= window_) pool_.push_back(std::move(frame));
+    }
+
+    void write_loop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        while (true) {
+            work_cv_.wait(lock, [this] { return closed_ || !queue_.empty(); });
+            if (queue_.empty()) break;  // Closed and drained
+
+            Pending pending = std::move(queue_.front());
+            queue_.pop_front();
+            lock.unlock();
+
+            // Blocking network write happens outside the lock
+            auto start = std::chrono::steady_clock::now();
+            bool ok = sink_(*pending.frame);
+            double latency_ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+
+            lock.lock();
+            stats_.total_write_time_ms += latency_ms;
+            stats_.max_write_latency_ms = std::max(stats_.max_write_latency_ms, latency_ms);
+            recycle(std::move(pending.frame));
+
+            if (ok) {
+                stats_.frames_written++;
+            } else {
+                failed_ = true;
+                queue_.clear();
+            }
+            space_cv_.notify_all();
+        }
+    }
+};
+
+} // namespace orbitops
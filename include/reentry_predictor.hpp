@@ -0,0 +1,76 @@
+#pragma once
+
+#include "atmosphere.hpp"
+#include "cancellation.hpp"
+#include "orbit_interval_index.hpp"
+#include "satellite_system.hpp"
+#include "types.hpp"
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace orbitops {
+
+// Batch reentry prediction settings
+struct ReentryConfig {
+    double max_perigee_altitude_km = 300.0;   // Candidates: perigee below this
+    double cutoff_altitude_km = 120.0;        // Reentry once the perigee falls below this
+    double horizon_days = 365.0;              // Members still in orbit after this never reenter
+    double step_days = 1.0;                   // Solar flux update interval
+    double max_decay_per_scale_height = 0.05;
+    SolarCycle solar;                         // Flux versus years after the element epoch
+
+    size_t ensemble_size = 16;                // Member 0 is the nominal (unperturbed) case
+    double ballistic_sigma = 0.3;             // Lognormal spread of Cd A/m (from B*)
+    double f107_sigma = 0.15;                 // Relative spread of the solar flux
+    double window_low = 0.1;                  // Window quantiles over the members
+    double window_high = 0.9;
+    uint64_t seed = 7;
+};
+
+// Reentry estimate for one object, in days after its element epoch
+struct ReentryPrediction {
+    uint32_t index = 0;                       // Object index in the SatelliteSystem
+    int catalog_number = 0;
+    double perigee_altitude_km = 0.0;
+    bool reenters = false;                    // Nominal member reenters within the horizon
+    double nominal_days = -1.0;               // -1 when the nominal member survives the horizon
+    double mean_days = 0.0;                   // Over the members that reenter
+    double sigma_days = 0.0;
+    double window_start_days = 0.0;           // window_low quantile
+    double window_end_days = 0.0;             // window_high quantile (horizon if not reached)
+    bool window_complete = false;             // The window_high member reenters within the horizon
+    size_t members_reentered = 0;
+};
+
+struct ReentryReport {
+    bool success = false;
+    std::string error_message;
+    size_t candidates = 0;
+    std::vector<ReentryPrediction> predictions;   // Ascending object index
+};
+
+// Predict reentry for every object whose perigee is below the candidate
+// altitude. Each candidate runs a small ensemble (perturbed ballistic
+// coefficient and solar flux, seeded per object so results do not depend
+// on the thread count); all (object, member) pairs integrate the
+// orbit-averaged drag decay in one parallel batch. Candidates come from
+// `bands` when given (it must be in sync with `sys`).
+ReentryReport predict_reentries(
+    const SatelliteSystem& sys,
+    const ReentryConfig& config = {},
+    const OrbitIntervalIndex* bands = nullptr,
+    const CancellationToken* cancel = nullptr
+);
+
+// Catalog numbers of objects whose whole reentry window has passed by
+// `now_jd` (element epoch + window end). `tles` must be in `sys` order. A
+// fresher element set moves the epoch forward and revives the object.
+std::vector<int> decayed_catalog_numbers(
+    const ReentryReport& report,
+    const std::vector<TLE>& tles,
+    double now_jd
+);
+
+} // namespace orbitops
@@ -2,11 +2,19 @@
 
 #include "types.hpp"
 #include <vector>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 
 namespace orbitops {
 
+// Object class bits (computed once at ingest)
+enum ObjectClass : uint8_t {
+    OBJECT_PAYLOAD     = 1 << 0,
+    OBJECT_DEBRIS      = 1 << 1,
+    OBJECT_ROCKET_BODY = 1 << 2,
+};
+
 // Structure of Arrays (SoA) for cache-efficient satellite data
 // All position/velocity arrays are contiguous for SIMD and cache optimization
 struct SatelliteSystem {
@@ -33,6 +41,7 @@ struct SatelliteSystem {
     // Cold data - rarely accessed
     std::vector<int> catalog_numbers;
     std::vector<std::string> names;
+    std::vector<uint8_t> object_class;       // ObjectClass bit per object
 
     SatelliteSystem() = default;
     ~SatelliteSystem() { deallocate(); }
@@ -52,6 +61,7 @@ struct SatelliteSystem {
             a0 = other.a0; bstar = other.bstar;
             catalog_numbers = std::move(other.catalog_numbers);
             names = std::move(other.names);
+            object_class = std::move(other.object_class);
             other.count = 0;
             other.x = other.y = other.z = nullptr;
             other.vx = other.vy = other.vz = nullptr;
@@ -85,6 +95,7 @@ struct SatelliteSystem {
         bstar = static_cast<double*>(std::aligned_alloc(64, alloc_size));
         catalog_numbers.resize(n);
         names.resize(n);
+        object_class.assign(n, OBJECT_PAYLOAD);
         
         // Zero initialize
         std::memset(x, 0, n * sizeof(double));
@@ -112,6 +123,7 @@ struct SatelliteSystem {
         if (bstar) { std::free(bstar); bstar = nullptr; }
         catalog_numbers.clear();
         names.clear();
+        object_class.clear();
         count = 0;
     }
 };
@@ -119,5 +131,12 @@ struct SatelliteSystem {
 // Convert from AoS (vector<TLE>) to SoA
 SatelliteSystem create_satellite_system(const std::vector<TLE>& tles);
 
+// Copy of `sys` with `extra` zeroed objects appended (catalog growth, e.g.
+// injected fragments)
+SatelliteSystem extend_satellite_system(const SatelliteSystem& sys, size_t extra);
+
+// Classify an object from its catalog name (payload, debris or rocket body)
+uint8_t classify_object(const TLE& tle);
+
 } // namespace orbitops
 
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "satellite_system.hpp"
+#include "cancellation.hpp"
+#include "collision_optimized.hpp"
+#include "conjunction_monitor.hpp"
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace orbitops {
+
+// Rolling-horizon catalog-vs-catalog screening.
+//
+// Keeps the event table covering [now, now + horizon] on a fixed time lattice.
+// As wall time advances only the newly entered slices are screened (one
+// propagation + grid pass each). A catalog update re-screens only new and
+// changed objects over the already-screened window, probing the grid around
+// each of them per slice; larger update batches re-screen everything.
+class ScreeningHorizon {
+public:
+    ScreeningHorizon(ConjunctionEventTable& table, const MonitorConfig& config = {});
+
+    // Start over with a catalog; the slice lattice is anchored at `now_minutes`
+    void reset(SatelliteSystem sys, double now_minutes);
+
+    // Expire passed events, then screen newly entered slices up to
+    // now + horizon (at most `max_slices`, 0 = no limit). Returns the number
+    // of slices screened; stops early if `cancel` trips.
+    size_t advance(double now_minutes, size_t max_slices = 0,
+                   const CancellationToken* cancel = nullptr);
+
+    // Swap in an updated catalog. Objects are matched by catalog number so
+    // existing events keep their ids across re-layouts. Returns the number of
+    // objects re-screened (the whole catalog if most objects changed).
+    size_t update_catalog(SatelliteSystem sys, double now_minutes,
+                          const CancellationToken* cancel = nullptr);
+
+    const SatelliteSystem& catalog() const { return sys_; }
+    bool has_catalog() const { return sys_.count > 0; }
+    double screened_until() const { return screened_until_; }   // Minutes from epoch
+
+    struct Stats {
+        size_t slices_screened = 0;
+        size_t objects_rescreened = 0;
+        size_t full_rescreens = 0;
+    };
+    Stats get_stats() const { return stats_; }
+
+private:
+    ConjunctionEventTable& table_;
+    MonitorConfig config_;
+    double step_minutes_;
+
+    SatelliteSystem sys_;
+    SpatialGrid grid_;
+    EncounterTracker tracker_;
+
+    double origin_minutes_ = 0.0;       // Slice lattice anchor
+    double screened_until_ = 0.0;       // Last screened slice
+    bool screened_any_ = false;
+    Stats stats_;
+
+    // First lattice time at or after t
+    double slice_at_or_after(double t_minutes) const;
+
+    // Full screen of one slice into `tracker`
+    bool screen_slice(double t_minutes, EncounterTracker& tracker, const CancellationToken* cancel);
+
+    // Re-screen flagged objects over [from, screened_until_]
+    bool rescreen_objects(const std::vector<uint8_t>& changed, double from_minutes,
+                          const CancellationToken* cancel);
+
+    // Re-screen the whole catalog over [from, screened_until_]
+    bool rescreen_all(double from_minutes, const CancellationToken* cancel);
+};
+
+} // namespace orbitops
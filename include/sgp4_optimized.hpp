@@ -1,12 +1,61 @@
 #pragma once
 
 #include "satellite_system.hpp"
+#include "cancellation.hpp"
+#include <vector>
+#include <cstdint>
 
 namespace orbitops {
 
 // Optimized SGP4 propagator using SoA layout and OpenMP
-// Propagates all satellites in parallel
-void propagate_all_optimized(SatelliteSystem& sys, double time_minutes);
+// Propagates all satellites in parallel; stops early (leaving the remaining
+// chunks unpropagated) when `cancel` trips
+void propagate_all_optimized(SatelliteSystem& sys, double time_minutes,
+                             const CancellationToken* cancel = nullptr);
+
+// Propagate a single object without touching the SoA position arrays
+void propagate_state(const SatelliteSystem& sys, size_t index, double time_minutes,
+                     Vec3& position, Vec3& velocity);
+
+// Inverse of propagate_state: set object `index`'s elements so that it
+// passes through (position, velocity) at `time_minutes` under this
+// propagator's two-body + J2 secular model. Returns false (elements
+// untouched) for unbound or degenerate states.
+bool set_elements_from_state(SatelliteSystem& sys, size_t index, double time_minutes,
+                             const Vec3& position, const Vec3& velocity);
+
+// One (object, time) state lookup
+struct StateQuery {
+    uint32_t index;
+    double time_minutes;
+};
+
+// Caller-owned output arrays, one element per query (ECI, km and km/s)
+struct StateArrays {
+    double* x;
+    double* y;
+    double* z;
+    double* vx;
+    double* vy;
+    double* vz;
+};
+
+// Evaluate arbitrary (object, time) pairs in parallel, touching only the
+// queried objects. Queries are grouped by object and time so each object's
+// elements stay hot; a repeated pair copies the previous result unless it
+// falls at the start of a new chunk, where it is re-evaluated. Out-of-range
+// indices produce NaN states. Returns false if `cancel` tripped (outputs are
+// then incomplete).
+bool propagate_states(const SatelliteSystem& sys, const std::vector<StateQuery>& queries,
+                      const StateArrays& out, const CancellationToken* cancel = nullptr);
+
+// Propagate the listed objects to `time_minutes` and write their positions,
+// multiplied by `scale`, as interleaved float32 xyz (3 floats per index)
+// into caller-owned memory; the SoA state arrays are not touched. Returns
+// false if `cancel` tripped (output then incomplete).
+bool propagate_positions_f32(const SatelliteSystem& sys, const uint32_t* indices, size_t n,
+                             double time_minutes, double scale, float* xyz,
+                             const CancellationToken* cancel = nullptr);
 
 } // namespace orbitops
 
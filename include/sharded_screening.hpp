@@ -0,0 +1,56 @@
+#pragma once
+
+#include "satellite_system.hpp"
+#include "cancellation.hpp"
+#include "conjunction_monitor.hpp"
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace orbitops {
+
+// Settings for splitting a long screening window across local worker processes
+struct ShardingConfig {
+    size_t workers = 4;
+    std::string worker_executable;     // Empty = orbitops_shard_worker next to this executable
+    size_t threads_per_worker = 0;     // OMP_NUM_THREADS for workers (0 = cores / workers)
+    double overlap_minutes = -1.0;     // Shard overlap for boundary encounters (< 0 = TCA match + step)
+};
+
+struct ShardedScreeningResult {
+    bool success = false;
+    std::string error_message;
+    std::vector<MonitoredConjunction> events;   // Merged, sorted by TCA then pair
+    size_t shards = 0;
+    size_t duplicates_merged = 0;               // Boundary encounters reported by two shards
+};
+
+// Screen [start, end] (minutes from epoch) across worker processes, one time
+// slice each. The catalog elements are written once to an unlinked temporary
+// file that every worker maps read-only and propagates from in place (only
+// the state arrays are per worker); tasks and results travel over a Unix
+// socket pair per worker. Workers are separate executables rather than plain
+// forks because the OpenMP runtime does not survive fork().
+ShardedScreeningResult screen_sharded(
+    const SatelliteSystem& sys,
+    double start_minutes,
+    double end_minutes,
+    const MonitorConfig& config,
+    const ShardingConfig& sharding = {},
+    const CancellationToken* cancel = nullptr
+);
+
+// Merge per-shard event lists: the same pair within the TCA match window is
+// one encounter, keeping the closer approach. Returns events sorted by TCA.
+std::vector<MonitoredConjunction> merge_shard_events(
+    const std::vector<std::vector<MonitoredConjunction>>& shards,
+    double tca_match_minutes,
+    size_t* duplicates = nullptr
+);
+
+// Worker side: read one task from `socket_fd`, screen it against the catalog
+// mapped from `catalog_fd`, reply and return a process exit code
+int run_shard_worker(int socket_fd, int catalog_fd);
+
+} // namespace orbitops
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "debris_system.hpp"
+#include "satellite_system.hpp"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace orbitops {
+
+// Histogram layout for shell densities: altitude shells, optionally split
+// into inclination bands over [0, 180] degrees
+struct ShellBinning {
+    double min_altitude_km = 200.0;
+    double max_altitude_km = 2000.0;
+    double shell_thickness_km = 50.0;
+    size_t inclination_bins = 1;        // 1 = altitude only
+    bool current_altitude = false;      // Bin by |r| from propagated positions instead of mean altitude
+
+    size_t altitude_bins() const;
+
+    bool operator==(const ShellBinning& other) const {
+        return min_altitude_km == other.min_altitude_km && max_altitude_km == other.max_altitude_km &&
+               shell_thickness_km == other.shell_thickness_km &&
+               inclination_bins == other.inclination_bins && current_altitude == other.current_altitude;
+    }
+};
+
+// Debris counts, spatial density and flux per (shell, inclination band),
+// laid out shell-major: cell = shell * inclination_bins + band
+struct ShellDensityTable {
+    ShellBinning binning;
+    uint64_t catalog_version = 0;
+    double epoch_minutes = 0.0;         // Position epoch (current-altitude binning only)
+
+    std::vector<uint32_t> counts;
+    std::vector<double> spatial_density;    // Objects per km³ of the whole shell
+    std::vector<double> flux;               // Objects crossing per m² per year
+
+    // Cell for an altitude and inclination, or -1 outside the table
+    long cell(double altitude_km, double inclination_deg = 0.0) const;
+
+    // Flux summed over inclination bands of the shell containing `altitude_km`
+    double shell_flux(double altitude_km) const;
+};
+
+// Build the histogram in one parallel pass over the debris rows
+ShellDensityTable build_shell_density_table(
+    const DebrisSystem& debris,
+    const SatelliteSystem& sys,
+    const ShellBinning& binning
+);
+
+} // namespace orbitops
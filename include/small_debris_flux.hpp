@@ -0,0 +1,89 @@
+#pragma once
+
+#include "debris_system.hpp"
+#include "satellite_system.hpp"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace orbitops {
+
+// Grid and population scaling for the statistical small-debris model
+struct SmallDebrisFluxConfig {
+    double min_altitude_km = 200.0;
+    double max_altitude_km = 2000.0;
+    double altitude_step_km = 25.0;
+    size_t inclination_bins = 18;         // Over [0, 180] degrees
+    size_t direction_bins = 12;           // Impact azimuth from the ram direction, [-180, 180)
+    size_t raan_samples = 36;             // Relative node angles integrated per cell
+
+    double reference_density = 1e-8;      // Particles per km³ in the densest shell
+    double reference_size_m = 1e-3;       // Particle size the densities refer to
+    double size_exponent = 2.6;           // Cumulative size distribution N(>d) ~ d^-exponent
+};
+
+// Sub-trackable debris flux on an (altitude, inclination, direction) grid.
+// The population follows the tracked debris distribution in altitude and
+// inclination, scaled so the densest shell holds `reference_density`. Each
+// cell integrates crossing geometry over relative node angles for a
+// circular orbit at that altitude and inclination. Built once per catalog
+// load; evaluation is bilinear interpolation between cell centres.
+class SmallDebrisFluxTable {
+public:
+    void build(const DebrisSystem& debris, const SatelliteSystem& sys, const SmallDebrisFluxConfig& config);
+
+    bool empty() const { return omni_.empty(); }
+    const SmallDebrisFluxConfig& config() const { return config_; }
+
+    // Flux of particles above the reference size (per m² per year); zero
+    // outside the altitude range
+    double flux(double altitude_km, double inclination_deg) const;
+
+    // Batch form over parallel arrays (vectorized)
+    void flux_batch(const double* altitude_km, const double* inclination_deg, size_t n, double* out) const;
+
+    // Add the flux per impact-azimuth bin to `out` (direction_bins values)
+    void accumulate_directional(double altitude_km, double inclination_deg, double* out) const;
+
+    // Fraction of reference-size particles larger than `size_m`
+    double size_fraction(double size_m) const;
+
+private:
+    SmallDebrisFluxConfig config_;
+    size_t altitude_bins_ = 0;
+    std::vector<double> omni_;            // [altitude][inclination]
+    std::vector<double> directional_;     // [altitude][inclination][direction]
+
+    // Bilinear weights between cell centres; false outside the altitude range
+    bool locate(double altitude_km, double inclination_deg, size_t cell[4], double weight[4]) const;
+};
+
+// Orbit-averaged small-debris exposure of one object
+struct SmallDebrisAssessment {
+    uint32_t index = 0;                   // Object index in the SatelliteSystem
+    double mean_flux = 0.0;               // Reference-size particles per m² per year
+    double peak_flux = 0.0;
+    std::vector<double> directional_flux; // Orbit-averaged, per impact-azimuth bin
+    double expected_penetrations = 0.0;   // Over the exposure window
+    double penetration_probability = 0.0; // 1 - exp(-expected)
+};
+
+// Exposure parameters for a fleet assessment
+struct SmallDebrisExposure {
+    double start_minutes = 0.0;
+    size_t samples_per_orbit = 64;
+    double area_m2 = 10.0;                // Exposed cross-section
+    double ballistic_limit_m = 1e-3;      // Smallest particle that penetrates
+    double duration_years = 1.0;
+};
+
+// Sample every fleet member over one orbit (batched state queries) and
+// average the interpolated flux along the ephemeris
+std::vector<SmallDebrisAssessment> assess_small_debris(
+    const SatelliteSystem& sys,
+    const std::vector<uint32_t>& fleet,
+    const SmallDebrisFluxTable& table,
+    const SmallDebrisExposure& exposure = {}
+);
+
+} // namespace orbitops
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace orbitops {
+
+// Raw timestamp for stage timing: the TSC on x86 (invariant on every CPU we
+// deploy on), steady_clock nanoseconds elsewhere
+inline uint64_t cycle_count() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// Convert a cycle_count() difference to seconds (calibrated once per process)
+double cycles_to_seconds(uint64_t cycles);
+
+// Stages of one conjunction screening step
+enum class Stage : uint8_t {
+    PROPAGATE = 0,
+    GRID_BUILD,
+    PAIR_TEST,
+    MONTE_CARLO,
+    SERIALIZE,       // Encoding a new frame, or decoding a cached one
+};
+constexpr size_t STAGE_COUNT = 5;
+
+enum class StageCounter : uint8_t {
+    CANDIDATES_TESTED = 0,   // Pair distance tests in the grid
+    HITS,                    // Pairs within the threshold
+    PC_SAMPLES,              // Monte Carlo samples drawn
+    BYTES_WRITTEN,           // Encoded frame bytes sent
+};
+constexpr size_t STAGE_COUNTER_COUNT = 4;
+
+const char* stage_name(Stage stage);
+const char* stage_counter_name(StageCounter counter);
+
+// Timings and counters for one screening step
+struct StageTimings {
+    std::array<uint64_t, STAGE_COUNT> cycles{};
+    std::array<uint64_t, STAGE_COUNTER_COUNT> counters{};
+
+    void add(StageCounter counter, uint64_t n) { counters[static_cast<size_t>(counter)] += n; }
+    uint64_t count(StageCounter counter) const { return counters[static_cast<size_t>(counter)]; }
+    double seconds(Stage stage) const { return cycles_to_seconds(cycles[static_cast<size_t>(stage)]); }
+};
+
+// Adds the cycles spent in its scope to one stage
+class ScopedStageTimer {
+public:
+    ScopedStageTimer(StageTimings& timings, Stage stage)
+        : slot_(timings.cycles[static_cast<size_t>(stage)]), start_(cycle_count()) {}
+    ~ScopedStageTimer() { slot_ += cycle_count() - start_; }
+
+    ScopedStageTimer(const ScopedStageTimer&) = delete;
+    ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+private:
+    uint64_t& slot_;
+    uint64_t start_;
+};
+
+// Lock-free latency histogram with fixed buckets from 10 us to 10 s
+class LatencyHistogram {
+public:
+    static constexpr size_t BUCKETS = 19;   // Finite upper bounds; +Inf is implicit
+    static const std::array<double, BUCKETS>& bounds();
+
+    void observe(double seconds);
+
+    struct Snapshot {
+        std::array<uint64_t, BUCKETS + 1> counts{};   // Per bucket, last = above every bound
+        uint64_t count = 0;
+        double sum_seconds = 0.0;
+    };
+    Snapshot snapshot() const;
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKETS + 1> counts_{};
+    std::atomic<uint64_t> sum_ns_{0};
+};
+
+// Process-wide aggregation of per-step stage timings, rendered in the
+// Prometheus text exposition format
+class StageMetrics {
+public:
+    // Stages that did not run in this step (zero cycles) are not observed
+    void record(const StageTimings& timings);
+
+    uint64_t steps() const { return steps_.load(std::memory_order_relaxed); }
+    uint64_t total(StageCounter counter) const {
+        return counters_[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+    }
+    LatencyHistogram::Snapshot histogram(Stage stage) const {
+        return stages_[static_cast<size_t>(stage)].snapshot();
+    }
+
+    // Append the histograms and counter totals to `out`
+    void render_prometheus(std::string& out) const;
+
+private:
+    std::array<LatencyHistogram, STAGE_COUNT> stages_;
+    std::array<std::atomic<uint64_t>, STAGE_COUNTER_COUNT> counters_{};
+    std::atomic<uint64_t> steps_{0};
+};
+
+// Append one gauge or counter sample with its HELP/TYPE header
+void append_prometheus_metric(std::string& out, const char* name, const char* type,
+                              const char* help, double value);
+
+} // namespace orbitops
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "stage_metrics.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Span tracing for the core pipelines, compiled in with -DORBITOPS_TRACING=1
+// (CMake option ORBITOPS_TRACING). When off, the ORBITOPS_TRACE_* macros
+// expand to nothing, so the pipelines record no spans; Scope and record()
+// used directly still record.
+#ifndef ORBITOPS_TRACING
+#define ORBITOPS_TRACING 0
+#endif
+
+namespace orbitops {
+namespace trace {
+
+constexpr bool ENABLED = ORBITOPS_TRACING != 0;
+
+// One completed span; names must be string literals
+struct Event {
+    const char* name = nullptr;
+    uint64_t start = 0;     // cycle_count()
+    uint64_t end = 0;
+    int64_t arg = -1;       // Optional size argument (-1 = none)
+};
+
+// Fixed-size ring written only by its owning thread. Recording is a store
+// plus a release increment; readers copy the ring and discard the slots the
+// writer may have lapped while they were copying.
+class ThreadRing {
+public:
+    static constexpr size_t CAPACITY = 8192;   // Power of two
+
+    explicit ThreadRing(uint32_t tid);
+
+    void push(const Event& event) {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        events_[head & (CAPACITY - 1)] = event;
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    // Append the events still held, oldest first
+    void snapshot(std::vector<Event>& out) const;
+    void clear() { tail_.store(head_.load(std::memory_order_acquire), std::memory_order_release); }
+
+    uint32_t tid() const { return tid_; }
+
+    // Hand the ring to a new thread: fresh tid, previous spans dropped, so
+    // one tid never covers two threads. Only call while no thread owns it.
+    void reassign(uint32_t tid) {
+        tid_ = tid;
+        clear();
+    }
+
+private:
+    uint32_t tid_;
+    std::atomic<uint64_t> head_{0};
+    std::atomic<uint64_t> tail_{0};             // Events before this were cleared
+    std::unique_ptr<Event[]> events_;
+};
+
+// Record a span on the calling thread's ring
+void record(const char* name, uint64_t start, uint64_t end, int64_t arg = -1);
+
+// Buffered spans of every thread that ended at or after `since_cycles`, as
+// Chrome trace-event JSON (loads in chrome://tracing and the Perfetto UI)
+std::string chrome_json(uint64_t since_cycles = 0);
+
+// Write chrome_json() to a file; returns false on I/O failure
+bool write_chrome_json(const std::string& path, uint64_t since_cycles = 0);
+
+// Forget every buffered span
+void clear();
+
+// Records its lifetime as a span
+class Scope {
+public:
+    explicit Scope(const char* name, int64_t arg = -1)
+        : name_(name), arg_(arg), start_(cycle_count()) {}
+    ~Scope() { record(name_, start_, cycle_count(), arg_); }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char* name_;
+    int64_t arg_;
+    uint64_t start_;
+};
+
+} // namespace trace
+} // namespace orbitops
+
+#if ORBITOPS_TRACING
+#define ORBITOPS_TRACE_CONCAT_(a, b) a##b
+#define ORBITOPS_TRACE_CONCAT(a, b) ORBITOPS_TRACE_CONCAT_(a, b)
+#define ORBITOPS_TRACE_SCOPE(name) \
+    ::orbitops::trace::Scope ORBITOPS_TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#define ORBITOPS_TRACE_SCOPE_ARG(name, arg) \
+    ::orbitops::trace::Scope ORBITOPS_TRACE_CONCAT(trace_scope_, __LINE__)(name, static_cast<int64_t>(arg))
+#else
+#define ORBITOPS_TRACE_SCOPE(name) ((void)0)
+#define ORBITOPS_TRACE_SCOPE_ARG(name, arg) ((void)0)
+#endif
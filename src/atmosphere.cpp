@@ -0,0 +1,112 @@
+#include "atmosphere.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace orbitops {
+
+namespace {
+    constexpr double RE = 6378.137;                  // km
+    constexpr double MU = 398600.4418;               // km^3/s^2
+    constexpr double SECONDS_PER_DAY = 86400.0;
+    constexpr double BSTAR_RHO0 = 0.15696615;        // kg/m²/ER (SGP4 reference density)
+    constexpr double REFERENCE_F107 = 150.0;
+    constexpr int MAX_SUBSTEPS = 1000;               // Per integrate_drag_decay call
+
+    // Base altitude (km), nominal density (kg/m³), scale height (km)
+    struct AtmosphereLayer {
+        double base_km;
+        double density;
+        double scale_height_km;
+    };
+
+    constexpr AtmosphereLayer LAYERS[] = {
+        {100.0, 5.297e-7, 5.877},   {110.0, 9.661e-8, 7.263},   {120.0, 2.438e-8, 9.473},
+        {130.0, 8.484e-9, 12.636},  {140.0, 3.845e-9, 16.149},  {150.0, 2.070e-9, 22.523},
+        {180.0, 5.464e-10, 29.740}, {200.0, 2.789e-10, 37.105}, {250.0, 7.248e-11, 45.546},
+        {300.0, 2.418e-11, 53.628}, {350.0, 9.518e-12, 53.298}, {400.0, 3.725e-12, 58.515},
+        {450.0, 1.585e-12, 60.828}, {500.0, 6.967e-13, 63.822}, {600.0, 1.454e-13, 71.835},
+        {700.0, 3.614e-14, 88.667}, {800.0, 1.170e-14, 124.64}, {900.0, 5.245e-15, 181.05},
+        {1000.0, 3.019e-15, 268.00},
+    };
+    constexpr size_t LAYER_COUNT = sizeof(LAYERS) / sizeof(LAYERS[0]);
+
+    // exp(-x) I0(x) and exp(-x) I1(x) (Abramowitz & Stegun 9.8.1-9.8.4)
+    void scaled_bessel(double x, double& i0, double& i1) {
+        if (x <= 3.75) {
+            const double t = (x / 3.75) * (x / 3.75);
+            const double s = std::exp(-x);
+            i0 = s * (1.0 + t * (3.5156229 + t * (3.0899424 + t * (1.2067492 +
+                     t * (0.2659732 + t * (0.0360768 + t * 0.0045813))))));
+            i1 = s * x * (0.5 + t * (0.87890594 + t * (0.51498869 + t * (0.15084934 +
+                     t * (0.02658733 + t * (0.00301532 + t * 0.00032411))))));
+        } else {
+            const double t = 3.75 / x;
+            const double s = 1.0 / std::sqrt(x);
+            i0 = s * (0.39894228 + t * (0.01328592 + t * (0.00225319 + t * (-0.00157565 +
+                     t * (0.00916281 + t * (-0.02057706 + t * (0.02635537 +
+                     t * (-0.01647633 + t * 0.00392377))))))));
+            i1 = s * (0.39894228 + t * (-0.03988024 + t * (-0.00362018 + t * (0.00163801 +
+                     t * (-0.01031555 + t * (0.02282967 + t * (-0.02895312 +
+                     t * (0.01787654 - t * 0.00420059))))))));
+        }
+    }
+}
+
+double SolarCycle::f107(double years) const {
+    return mean_f107 + amplitude * std::sin(2.0 * M_PI * (years - phase_years) / period_years);
+}
+
+double atmospheric_density(double altitude_km, double f107, double* scale_height_km) {
+    // Layer with the highest base at or below the altitude (exponential
+    // extrapolation below 100 km and above 1000 km)
+    size_t layer = 0;
+    while (layer + 1 < LAYER_COUNT && altitude_km >= LAYERS[layer + 1].base_km) ++layer;
+    const AtmosphereLayer& l = LAYERS[layer];
+
+    // Solar activity heats and expands the thermosphere; the response
+    // grows with altitude up to about 600 km
+    const double sensitivity = 0.002 + 0.01 * std::clamp((altitude_km - 100.0) / 500.0, 0.0, 1.0);
+    const double solar = std::exp(sensitivity * (f107 - REFERENCE_F107));
+
+    if (scale_height_km) *scale_height_km = l.scale_height_km;
+    return l.density * std::exp(-(altitude_km - l.base_km) / l.scale_height_km) * solar;
+}
+
+double ballistic_coefficient_from_bstar(double bstar) {
+    return 2.0 * std::abs(bstar) / BSTAR_RHO0;
+}
+
+DecayRates drag_decay_rates(double a_km, double e, double ballistic_m2_per_kg, double f107) {
+    DecayRates rates;
+    const double perigee_alt = a_km * (1.0 - e) - RE;
+    const double rho = atmospheric_density(perigee_alt, f107, &rates.scale_height_km);
+
+    // B rho in 1/km; c = ae/H
+    const double drag = ballistic_m2_per_kg * rho * 1000.0;
+    const double c = a_km * e / rates.scale_height_km;
+    double i0, i1;
+    scaled_bessel(c, i0, i1);
+    const double i2 = c > 1e-6 ? i0 - 2.0 * i1 / c : c * c / 8.0;
+
+    rates.da_km_per_day = -drag * std::sqrt(MU * a_km) * (i0 + 2.0 * e * i1) * SECONDS_PER_DAY;
+    rates.de_per_day = -drag * std::sqrt(MU / a_km) * (i1 + 0.5 * e * (i0 + i2)) * SECONDS_PER_DAY;
+    return rates;
+}
+
+double integrate_drag_decay(double& a_km, double& e, double ballistic_m2_per_kg, double f107,
+                            double days, double cutoff_radius_km, double max_decay_per_scale_height) {
+    double elapsed = 0.0;
+    for (int s = 0; s < MAX_SUBSTEPS && elapsed < days && a_km * (1.0 - e) >= cutoff_radius_km; ++s) {
+        const DecayRates rates = drag_decay_rates(a_km, e, ballistic_m2_per_kg, f107);
+        double h = days - elapsed;
+        const double limit = max_decay_per_scale_height * rates.scale_height_km;
+        if (-rates.da_km_per_day * h > limit) h = limit / -rates.da_km_per_day;
+
+        a_km += rates.da_km_per_day * h;
+        e = std::max(0.0, e + rates.de_per_day * h);
+        elapsed += h;
+    }
+    return elapsed;
+}
+
+} // namespace orbitops
@@ -0,0 +1,214 @@
+#include "breakup_model.hpp"
+#include "sgp4_optimized.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace orbitops {
+
+namespace {
+    constexpr double TWOPI = 2.0 * M_PI;
+    constexpr double RE = 6378.137;                    // km (propagator radius)
+    constexpr double CATASTROPHIC_ENERGY = 40.0;       // J/g
+    constexpr size_t SAMPLE_CHUNK = 4096;              // Fragments per seeded engine
+
+    // B* = (Cd A/m) rho0 / 2 with rho0 = 0.15696615 kg/m²/ER
+    constexpr double DRAG_COEFFICIENT = 2.2;
+    constexpr double BSTAR_RHO0 = 0.15696615;
+
+    // Piecewise-linear helper: y0 below x0, y1 above x1, linear between
+    inline double ramp(double x, double x0, double y0, double x1, double y1) {
+        if (x <= x0) return y0;
+        if (x >= x1) return y1;
+        return y0 + (y1 - y0) * (x - x0) / (x1 - x0);
+    }
+
+    // log10(A/m) for one fragment of characteristic length lc (m). Above
+    // 11 cm the distribution is bimodal (spacecraft or rocket body tables);
+    // below it is a single normal.
+    double sample_log_area_to_mass(double lc, bool rocket_body, std::mt19937_64& rng,
+                                   std::normal_distribution<double>& normal,
+                                   std::uniform_real_distribution<double>& uniform) {
+        const double lambda = std::log10(lc);
+
+        if (lc < 0.11) {
+            const double mu = ramp(lambda, -1.75, -0.3, -1.25, -1.0);
+            const double sigma = lambda <= -3.5 ? 0.2 : 0.2 + 0.1333 * (lambda + 3.5);
+            return mu + sigma * normal(rng);
+        }
+
+        double alpha, mu1, sigma1, mu2, sigma2;
+        if (rocket_body) {
+            alpha = ramp(lambda, -1.4, 1.0, 0.0, 0.5);
+            mu1 = ramp(lambda, -0.5, -0.45, 0.0, -0.9);
+            sigma1 = 0.55;
+            mu2 = -0.9;
+            sigma2 = ramp(lambda, -1.0, 0.28, 0.1, 0.1);
+        } else {
+            alpha = ramp(lambda, -1.95, 0.0, 0.55, 1.0);
+            mu1 = ramp(lambda, -1.1, -0.6, 0.0, -0.95);
+            sigma1 = ramp(lambda, -1.3, 0.1, -0.3, 0.3);
+            mu2 = ramp(lambda, -0.7, -1.2, -0.1, -2.0);
+            sigma2 = ramp(lambda, -0.5, 0.5, -0.3, 0.3);
+        }
+
+        const bool first = uniform(rng) < alpha;
+        return first ? mu1 + sigma1 * normal(rng) : mu2 + sigma2 * normal(rng);
+    }
+
+    // Cross-section (m²) from characteristic length (m)
+    inline double area_from_length(double lc) {
+        return lc < 0.00167 ? 0.540424 * lc * lc : 0.556945 * std::pow(lc, 2.0047077);
+    }
+}
+
+size_t breakup_fragment_count(const BreakupEvent& event) {
+    if (!(event.min_length_m > 0.0)) return 0;
+    const double lc = event.min_length_m;
+    double n = 0.0;
+
+    if (event.kind == BreakupKind::EXPLOSION) {
+        n = 6.0 * event.scale_factor * std::pow(lc, -1.6);
+    } else {
+        // Specific energy of the projectile relative to the target (J/g)
+        const double v_m_s = event.impact_velocity_km_s * 1000.0;
+        const double energy = 0.5 * event.projectile_mass_kg * v_m_s * v_m_s /
+                              (std::max(event.target_mass_kg, 1e-9) * 1000.0);
+        const double mass = energy > CATASTROPHIC_ENERGY
+            ? event.target_mass_kg + event.projectile_mass_kg
+            : event.projectile_mass_kg * event.impact_velocity_km_s * event.impact_velocity_km_s;
+        n = 0.1 * std::pow(mass, 0.75) * std::pow(lc, -1.71);
+    }
+
+    return std::min(static_cast<size_t>(n), event.max_fragments);
+}
+
+BreakupResult simulate_breakup(const SatelliteSystem& sys, const BreakupEvent& event) {
+    ORBITOPS_TRACE_SCOPE("breakup.simulate");
+    BreakupResult result;
+
+    if (event.parent >= sys.count) {
+        result.error_message = "Parent index out of range";
+        return result;
+    }
+    if (!(event.min_length_m > 0.0) || !(event.max_length_m > event.min_length_m)) {
+        result.error_message = "Invalid characteristic length range";
+        return result;
+    }
+
+    FragmentCloud& cloud = result.fragments;
+    cloud.time_minutes = event.time_minutes;
+    propagate_state(sys, event.parent, event.time_minutes, cloud.parent_position, cloud.parent_velocity);
+
+    const size_t n = breakup_fragment_count(event);
+    cloud.count = n;
+    cloud.length_m.resize(n);
+    cloud.area_to_mass.resize(n);
+    cloud.mass_kg.resize(n);
+    cloud.dvx.resize(n);
+    cloud.dvy.resize(n);
+    cloud.dvz.resize(n);
+
+    // Power-law size distribution truncated to [min, max], sampled by
+    // inverting its CDF
+    const double beta = event.kind == BreakupKind::EXPLOSION ? 1.6 : 1.71;
+    const double lo = std::pow(event.min_length_m, -beta);
+    const double hi = std::pow(event.max_length_m, -beta);
+
+    // log10(delta-v in m/s) ~ N(a chi + b, 0.4), chi = log10(A/m)
+    const double dv_slope = event.kind == BreakupKind::EXPLOSION ? 0.2 : 0.9;
+    const double dv_offset = event.kind == BreakupKind::EXPLOSION ? 1.85 : 2.9;
+
+    const size_t chunks = (n + SAMPLE_CHUNK - 1) / SAMPLE_CHUNK;
+
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (size_t c = 0; c < chunks; ++c) {
+        std::mt19937_64 rng(event.seed ^ (0x9E3779B97F4A7C15ULL * (c + 1)));
+        std::normal_distribution<double> normal(0.0, 1.0);
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+        const size_t begin = c * SAMPLE_CHUNK;
+        const size_t end = std::min(n, begin + SAMPLE_CHUNK);
+        for (size_t k = begin; k < end; ++k) {
+            const double lc = std::pow(lo - uniform(rng) * (lo - hi), -1.0 / beta);
+            const double chi = sample_log_area_to_mass(lc, event.parent_is_rocket_body, rng, normal, uniform);
+            const double area_to_mass = std::pow(10.0, chi);
+            const double dv = std::pow(10.0, dv_slope * chi + dv_offset + 0.4 * normal(rng)) * 1e-3;  // km/s
+
+            // Isotropic direction
+            const double cos_theta = 2.0 * uniform(rng) - 1.0;
+            const double sin_theta = std::sqrt(std::max(0.0, 1.0 - cos_theta * cos_theta));
+            const double phi = TWOPI * uniform(rng);
+
+            cloud.length_m[k] = static_cast<float>(lc);
+            cloud.area_to_mass[k] = static_cast<float>(area_to_mass);
+            cloud.mass_kg[k] = static_cast<float>(area_from_length(lc) / area_to_mass);
+            cloud.dvx[k] = dv * sin_theta * std::cos(phi);
+            cloud.dvy[k] = dv * sin_theta * std::sin(phi);
+            cloud.dvz[k] = dv * cos_theta;
+        }
+    }
+
+    result.success = true;
+    return result;
+}
+
+size_t inject_fragments(
+    SatelliteSystem& sys,
+    const FragmentCloud& cloud,
+    const std::string& parent_name,
+    int first_catalog_number,
+    double min_perigee_km
+) {
+    ORBITOPS_TRACE_SCOPE_ARG("breakup.inject", cloud.count);
+    const size_t n = cloud.count;
+    if (n == 0) return 0;
+
+    // Fit elements into a scratch system first; only surviving fragments are appended
+    SatelliteSystem fitted;
+    fitted.allocate(n);
+    std::vector<uint8_t> keep(n, 0);
+    const Vec3 r = cloud.parent_position;
+    const double min_perigee = RE + min_perigee_km;
+
+    #pragma omp parallel for schedule(static)
+    for (size_t k = 0; k < n; ++k) {
+        const Vec3 v{cloud.parent_velocity.x + cloud.dvx[k],
+                     cloud.parent_velocity.y + cloud.dvy[k],
+                     cloud.parent_velocity.z + cloud.dvz[k]};
+        if (!set_elements_from_state(fitted, k, cloud.time_minutes, r, v)) continue;
+        if (fitted.a0[k] * (1.0 - fitted.ecc[k]) < min_perigee) continue;
+
+        fitted.bstar[k] = 0.5 * DRAG_COEFFICIENT * cloud.area_to_mass[k] * BSTAR_RHO0;
+        keep[k] = 1;
+    }
+
+    size_t kept = 0;
+    for (uint8_t k : keep) kept += k;
+    if (kept == 0) return 0;
+
+    SatelliteSystem grown = extend_satellite_system(sys, kept);
+    const std::string name = parent_name + " DEB";
+    size_t slot = sys.count;
+    for (size_t k = 0; k < n; ++k) {
+        if (!keep[k]) continue;
+        grown.incl[slot] = fitted.incl[k];
+        grown.raan0[slot] = fitted.raan0[k];
+        grown.ecc[slot] = fitted.ecc[k];
+        grown.argp0[slot] = fitted.argp0[k];
+        grown.M0[slot] = fitted.M0[k];
+        grown.n0[slot] = fitted.n0[k];
+        grown.a0[slot] = fitted.a0[k];
+        grown.bstar[slot] = fitted.bstar[k];
+        grown.catalog_numbers[slot] = first_catalog_number + static_cast<int>(slot - sys.count);
+        grown.names[slot] = name;
+        grown.object_class[slot] = OBJECT_DEBRIS;
+        ++slot;
+    }
+
+    sys = std::move(grown);
+    return kept;
+}
+
+} // namespace orbitops
@@ -1,7 +1,9 @@
 #include "collision_optimized.hpp"
 #include "simd_utils.hpp"
+#include "trace.hpp"
 #include <cmath>
 #include <algorithm>
+#include <cstdlib>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -13,24 +15,48 @@ SpatialGrid::SpatialGrid(double cell_size_km)
     : cell_size(cell_size_km), inv_cell_size(1.0 / cell_size_km) {}
 
 void SpatialGrid::build(const SatelliteSystem& sys) {
-    grid.clear();
-    grid.reserve(sys.count / 8);
-    
+    ORBITOPS_TRACE_SCOPE_ARG("grid.build", sys.count);
+    clear(sys.count);
     for (size_t i = 0; i < sys.count; ++i) {
-        int64_t cx = pos_to_cell(sys.x[i]);
-        int64_t cy = pos_to_cell(sys.y[i]);
-        int64_t cz = pos_to_cell(sys.z[i]);
-        uint64_t key = pack_cell(cx, cy, cz);
-        grid[key].push_back(i);
+        insert(sys, i);
     }
 }
 
-std::vector<Conjunction> SpatialGrid::find_conjunctions(
+void SpatialGrid::build(const SatelliteSystem& sys, const std::vector<uint32_t>& indices) {
+    ORBITOPS_TRACE_SCOPE_ARG("grid.build", indices.size());
+    clear(indices.size());
+    for (uint32_t i : indices) {
+        if (i < sys.count) insert(sys, i);
+    }
+}
+
+void SpatialGrid::clear(size_t expected_count) {
+    grid.clear();
+    grid.reserve(expected_count / 8);
+    
+    cell_min[0] = cell_min[1] = cell_min[2] = INT64_MAX;
+    cell_max[0] = cell_max[1] = cell_max[2] = INT64_MIN;
+}
+
+void SpatialGrid::insert(const SatelliteSystem& sys, size_t i) {
+    int64_t cx = pos_to_cell(sys.x[i]);
+    int64_t cy = pos_to_cell(sys.y[i]);
+    int64_t cz = pos_to_cell(sys.z[i]);
+    uint64_t key = pack_cell(cx, cy, cz);
+    grid[key].push_back(i);
+    
+    cell_min[0] = std::min(cell_min[0], cx); cell_max[0] = std::max(cell_max[0], cx);
+    cell_min[1] = std::min(cell_min[1], cy); cell_max[1] = std::max(cell_max[1], cy);
+    cell_min[2] = std::min(cell_min[2], cz); cell_max[2] = std::max(cell_max[2], cz);
+}
+
+std::vector<ClosePair> SpatialGrid::find_close_pairs(
     const SatelliteSystem& sys,
     double threshold_km,
-    double time_minutes
+    const CancellationToken* cancel
 ) {
-    std::vector<Conjunction> conjunctions;
+    ORBITOPS_TRACE_SCOPE_ARG("grid.find_close_pairs", grid.size());
+    std::vector<ClosePair> conjunctions;
     const double threshold_sq = threshold_km * threshold_km;
     
     // Collect all cell keys for parallel iteration
@@ -50,19 +76,37 @@ std::vector<Conjunction> SpatialGrid::find_conjunctions(
 
     // Thread-local conjunction storage for parallel collection
     #ifdef _OPENMP
-    std::vector<std::vector<Conjunction>> thread_conjunctions(omp_get_max_threads());
+    std::vector<std::vector<ClosePair>> thread_conjunctions(omp_get_max_threads());
     #endif
 
-    #pragma omp parallel
+    size_t candidates = 0;
+
+    #pragma omp parallel reduction(+:candidates)
     {
+        ORBITOPS_TRACE_SCOPE("grid.find_close_pairs.worker");
         #ifdef _OPENMP
         auto& local_conj = thread_conjunctions[omp_get_thread_num()];
         #else
         auto& local_conj = conjunctions;
         #endif
 
+        // Check the token every CELLS_PER_CHECK cells; once it trips this
+        // thread skips its remaining cells
+        constexpr size_t CELLS_PER_CHECK = 64;
+        size_t cells_since_check = 0;
+        bool stopped = false;
+
         #pragma omp for schedule(dynamic, 16) nowait
         for (size_t cell_idx = 0; cell_idx < cell_keys.size(); ++cell_idx) {
+            if (stopped) continue;
+            if (cancel && ++cells_since_check >= CELLS_PER_CHECK) {
+                cells_since_check = 0;
+                if (cancel->is_cancelled()) {
+                    stopped = true;
+                    continue;
+                }
+            }
+
             uint64_t cell_key = cell_keys[cell_idx];
             const auto& indices = grid.at(cell_key);
             
@@ -72,6 +116,7 @@ std::vector<Conjunction> SpatialGrid::find_conjunctions(
             int64_t cz = static_cast<int64_t>(cell_key & 0x1FFFFF) - (1 << 20);
 
             // Check pairs within same cell
+            candidates += indices.size() * (indices.size() - 1) / 2;
             for (size_t a = 0; a < indices.size(); ++a) {
                 size_t i = indices[a];
                 double xi = sys.x[i], yi = sys.y[i], zi = sys.z[i];
@@ -89,12 +134,7 @@ std::vector<Conjunction> SpatialGrid::find_conjunctions(
                                                             sys.x[j], sys.y[j], sys.z[j]);
                     
                     if (dist_sq < threshold_sq) [[unlikely]] {
-                        local_conj.push_back({
-                            sys.catalog_numbers[i],
-                            sys.catalog_numbers[j],
-                            std::sqrt(dist_sq),
-                            time_minutes
-                        });
+                        local_conj.push_back({i, j, std::sqrt(dist_sq)});
                     }
                 }
             }
@@ -106,6 +146,7 @@ std::vector<Conjunction> SpatialGrid::find_conjunctions(
                 if (it == grid.end()) [[likely]] continue;
                 
                 const auto& neighbor_indices = it->second;
+                candidates += indices.size() * neighbor_indices.size();
                 
                 for (size_t i : indices) {
                     double xi = sys.x[i], yi = sys.y[i], zi = sys.z[i];
@@ -115,12 +156,7 @@ std::vector<Conjunction> SpatialGrid::find_conjunctions(
                                                                 sys.x[j], sys.y[j], sys.z[j]);
                         
                         if (dist_sq < threshold_sq) [[unlikely]] {
-                            local_conj.push_back({
-                                sys.catalog_numbers[i],
-                                sys.catalog_numbers[j],
-                                std::sqrt(dist_sq),
-                                time_minutes
-                            });
+                            local_conj.push_back({i, j, std::sqrt(dist_sq)});
                         }
                     }
                 }
@@ -135,9 +171,164 @@ std::vector<Conjunction> SpatialGrid::find_conjunctions(
     }
     #endif
     
+    last_candidates_tested = candidates;
+    return conjunctions;
+}
+
+std::vector<Conjunction> SpatialGrid::find_conjunctions(
+    const SatelliteSystem& sys,
+    double threshold_km,
+    double time_minutes,
+    const CancellationToken* cancel
+) {
+    ORBITOPS_TRACE_SCOPE("grid.find_conjunctions");
+    auto pairs = find_close_pairs(sys, threshold_km, cancel);
+    
+    std::vector<Conjunction> conjunctions;
+    conjunctions.reserve(pairs.size());
+    for (const auto& pair : pairs) {
+        conjunctions.push_back({
+            sys.catalog_numbers[pair.i],
+            sys.catalog_numbers[pair.j],
+            pair.distance_km,
+            time_minutes
+        });
+    }
     return conjunctions;
 }
 
+std::vector<Neighbor> SpatialGrid::query_radius(
+    const SatelliteSystem& sys,
+    const Vec3& point,
+    double radius_km,
+    size_t exclude
+) const {
+    std::vector<Neighbor> result;
+    if (grid.empty() || radius_km < 0.0) return result;
+    
+    const double radius_sq = radius_km * radius_km;
+    auto test_cell = [&](const std::vector<size_t>& indices) {
+        for (size_t i : indices) {
+            if (i == exclude) continue;
+            double dist_sq = simd::distance_squared(point.x, point.y, point.z,
+                                                    sys.x[i], sys.y[i], sys.z[i]);
+            if (dist_sq <= radius_sq) {
+                result.push_back({i, std::sqrt(dist_sq)});
+            }
+        }
+    };
+    
+    // Cell box covering the sphere, clipped to occupied cells
+    int64_t lo[3] = {pos_to_cell(point.x - radius_km), pos_to_cell(point.y - radius_km),
+                     pos_to_cell(point.z - radius_km)};
+    int64_t hi[3] = {pos_to_cell(point.x + radius_km), pos_to_cell(point.y + radius_km),
+                     pos_to_cell(point.z + radius_km)};
+    double box_cells = 1.0;
+    for (int a = 0; a < 3; ++a) {
+        lo[a] = std::max(lo[a], cell_min[a]);
+        hi[a] = std::min(hi[a], cell_max[a]);
+        if (lo[a] > hi[a]) return result;
+        box_cells *= static_cast<double>(hi[a] - lo[a] + 1);
+    }
+    
+    if (box_cells > static_cast<double>(grid.size())) {
+        // Large radius: scanning occupied cells is cheaper than probing the box
+        for (const auto& [key, indices] : grid) test_cell(indices);
+    } else {
+        for (int64_t cx = lo[0]; cx <= hi[0]; ++cx) {
+            for (int64_t cy = lo[1]; cy <= hi[1]; ++cy) {
+                for (int64_t cz = lo[2]; cz <= hi[2]; ++cz) {
+                    auto it = grid.find(pack_cell(cx, cy, cz));
+                    if (it != grid.end()) test_cell(it->second);
+                }
+            }
+        }
+    }
+    
+    std::sort(result.begin(), result.end(),
+              [](const Neighbor& a, const Neighbor& b) { return a.distance_km < b.distance_km; });
+    return result;
+}
+
+std::vector<Neighbor> SpatialGrid::query_knn(
+    const SatelliteSystem& sys,
+    const Vec3& point,
+    size_t k,
+    size_t exclude
+) const {
+    std::vector<Neighbor> best;  // Max-heap on distance, at most k entries
+    if (grid.empty() || k == 0) return best;
+    best.reserve(k + 1);
+    
+    auto closer = [](const Neighbor& a, const Neighbor& b) { return a.distance_km < b.distance_km; };
+    auto test_cell = [&](const std::vector<size_t>& indices) {
+        for (size_t i : indices) {
+            if (i == exclude) continue;
+            double dist = std::sqrt(simd::distance_squared(point.x, point.y, point.z,
+                                                           sys.x[i], sys.y[i], sys.z[i]));
+            if (best.size() < k) {
+                best.push_back({i, dist});
+                std::push_heap(best.begin(), best.end(), closer);
+            } else if (dist < best.front().distance_km) {
+                std::pop_heap(best.begin(), best.end(), closer);
+                best.back() = {i, dist};
+                std::push_heap(best.begin(), best.end(), closer);
+            }
+        }
+    };
+    
+    const int64_t c[3] = {pos_to_cell(point.x), pos_to_cell(point.y), pos_to_cell(point.z)};
+    int64_t max_ring = 0;
+    for (int a = 0; a < 3; ++a) {
+        max_ring = std::max({max_ring, c[a] - cell_min[a], cell_max[a] - c[a]});
+    }
+    
+    auto chebyshev = [&c](int64_t x, int64_t y, int64_t z) {
+        return std::max({std::abs(x - c[0]), std::abs(y - c[1]), std::abs(z - c[2])});
+    };
+    auto occupied = [this](int64_t v, int a) { return v >= cell_min[a] && v <= cell_max[a]; };
+    
+    size_t probes = 0;
+    for (int64_t ring = 0; ring <= max_ring; ++ring) {
+        // Once probing the next shell would cost more than scanning every
+        // occupied cell, finish with a scan of the cells not yet visited
+        size_t shell_cells = ring == 0 ? 1 : static_cast<size_t>(24 * ring * ring + 2);
+        if (probes + shell_cells > grid.size()) {
+            for (const auto& [key, indices] : grid) {
+                int64_t x = static_cast<int64_t>((key >> 42) & 0x1FFFFF) - (1 << 20);
+                int64_t y = static_cast<int64_t>((key >> 21) & 0x1FFFFF) - (1 << 20);
+                int64_t z = static_cast<int64_t>(key & 0x1FFFFF) - (1 << 20);
+                if (chebyshev(x, y, z) >= ring) test_cell(indices);
+            }
+            break;
+        }
+        probes += shell_cells;
+        
+        // Visit the cells at Chebyshev distance `ring` from the centre cell
+        for (int64_t dx = -ring; dx <= ring; ++dx) {
+            if (!occupied(c[0] + dx, 0)) continue;
+            for (int64_t dy = -ring; dy <= ring; ++dy) {
+                if (!occupied(c[1] + dy, 1)) continue;
+                const bool on_face = std::abs(dx) == ring || std::abs(dy) == ring;
+                const int64_t dz_step = (on_face || ring == 0) ? 1 : 2 * ring;
+                for (int64_t dz = -ring; dz <= ring; dz += dz_step) {
+                    if (!occupied(c[2] + dz, 2)) continue;
+                    auto it = grid.find(pack_cell(c[0] + dx, c[1] + dy, c[2] + dz));
+                    if (it != grid.end()) test_cell(it->second);
+                }
+            }
+        }
+        
+        // Every cell beyond this ring is at least ring * cell_size away
+        if (best.size() == k && best.front().distance_km <= static_cast<double>(ring) * cell_size) {
+            break;
+        }
+    }
+    
+    std::sort_heap(best.begin(), best.end(), closer);
+    return best;
+}
+
 std::vector<Conjunction> detect_collisions_optimized(
     const SatelliteSystem& sys,
     double threshold_km,
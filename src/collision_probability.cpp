@@ -1,4 +1,5 @@
 #include "collision_probability.hpp"
+#include "trace.hpp"
 #include <cmath>
 #include <algorithm>
 #include <numeric>
@@ -93,12 +94,16 @@ ConjunctionProbability CollisionProbabilityCalculator::calculate_quick(
 std::vector<ConjunctionProbability> CollisionProbabilityCalculator::calculate_all(
     const SatelliteSystem& sys,
     const std::vector<Conjunction>& conjunctions,
-    const std::vector<TLE>& tles
+    const std::vector<TLE>& tles,
+    const CancellationToken* cancel
 ) {
+    ORBITOPS_TRACE_SCOPE_ARG("probability.calculate_all", conjunctions.size());
     std::vector<ConjunctionProbability> results;
     results.reserve(conjunctions.size());
     
     for (const auto& conj : conjunctions) {
+        if (is_cancelled(cancel)) break;
+
         size_t i1 = static_cast<size_t>(conj.sat1_id);
         size_t i2 = static_cast<size_t>(conj.sat2_id);
         
@@ -119,6 +124,7 @@ std::vector<ConjunctionProbability> CollisionProbabilityCalculator::calculate_al
         std::string name1 = i1 < tles.size() ? tles[i1].name : "";
         std::string name2 = i2 < tles.size() ? tles[i2].name : "";
         
+        ORBITOPS_TRACE_SCOPE("probability.monte_carlo");
         auto prob = calculate(pos1, vel1, cov1, pos2, vel2, cov2,
                              conj.sat1_id, conj.sat2_id,
                              name1, name2, conj.time_minutes);
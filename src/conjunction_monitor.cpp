@@ -0,0 +1,400 @@
+#include "conjunction_monitor.hpp"
+#include "sgp4_optimized.hpp"
+#include "collision_optimized.hpp"
+#include "collision_probability.hpp"
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+namespace orbitops {
+
+namespace {
+    inline uint64_t pair_key(uint32_t a, uint32_t b) {
+        return (static_cast<uint64_t>(a) << 32) | b;
+    }
+
+    // Refine TCA with linear relative motion around the sample, limited to
+    // half a step either side, and fill miss distance, velocity and Pc
+    MonitoredConjunction sample_encounter(uint32_t i, uint32_t j, double t_minutes,
+                                          const double r[3], const double v[3],
+                                          const MonitorConfig& config) {
+        const double v_sq = v[0]*v[0] + v[1]*v[1] + v[2]*v[2];
+
+        double dt = v_sq > 0.0 ? -(r[0]*v[0] + r[1]*v[1] + r[2]*v[2]) / v_sq : 0.0;  // seconds
+        dt = std::clamp(dt, -0.5 * config.step_seconds, 0.5 * config.step_seconds);
+
+        const Vec3 miss = {r[0] + v[0]*dt, r[1] + v[1]*dt, r[2] + v[2]*dt};
+
+        MonitoredConjunction event;
+        event.sat1_id = std::min(i, j);
+        event.sat2_id = std::max(i, j);
+        event.tca_minutes = t_minutes + dt / 60.0;
+        event.miss_distance_km = miss.magnitude();
+        event.relative_velocity_km_s = std::sqrt(v_sq);
+
+        const PositionCovariance cov = estimate_covariance(24.0);
+        event.collision_probability = CollisionProbabilityCalculator::calculate_foster(
+            {0.0, 0.0, 0.0}, miss, {0.0, 0.0, 0.0}, {v[0], v[1], v[2]}, cov, cov,
+            config.collision_radius_km);
+        return event;
+    }
+
+    inline bool by_tca(const MonitoredConjunction& a, const MonitoredConjunction& b) {
+        return a.tca_minutes < b.tca_minutes;
+    }
+}
+
+EncounterTracker::EncounterTracker(const MonitorConfig& config)
+    : config_(config), gap_minutes_(1.5 * config.step_seconds / 60.0) {}
+
+void EncounterTracker::observe(const SatelliteSystem& sys, const std::vector<ClosePair>& pairs,
+                               double t_minutes) {
+    for (const auto& pair : pairs) {
+        const size_t i = pair.i, j = pair.j;
+        const double r[3] = {sys.x[j] - sys.x[i], sys.y[j] - sys.y[i], sys.z[j] - sys.z[i]};
+        const double v[3] = {sys.vx[j] - sys.vx[i], sys.vy[j] - sys.vy[i], sys.vz[j] - sys.vz[i]};
+        observe_pair(static_cast<uint32_t>(i), static_cast<uint32_t>(j), t_minutes, r, v);
+    }
+}
+
+void EncounterTracker::observe_pair(uint32_t i, uint32_t j, double t_minutes,
+                                    const double rel_pos[3], const double rel_vel[3]) {
+    MonitoredConjunction sample = sample_encounter(i, j, t_minutes, rel_pos, rel_vel, config_);
+    uint64_t key = pair_key(sample.sat1_id, sample.sat2_id);
+
+    auto it = open_.find(key);
+    if (it == open_.end()) {
+        open_.emplace(key, OpenEncounter{sample, t_minutes});
+        return;
+    }
+
+    OpenEncounter& encounter = it->second;
+    if (t_minutes - encounter.last_seen_minutes > gap_minutes_) {
+        // Previous encounter of this pair ended; start a new one
+        finished_.push_back(encounter.best);
+        encounter.best = sample;
+    } else if (sample.miss_distance_km < encounter.best.miss_distance_km) {
+        encounter.best = sample;
+    }
+    encounter.last_seen_minutes = t_minutes;
+}
+
+std::vector<MonitoredConjunction> EncounterTracker::close_before(double t_minutes) {
+    std::vector<MonitoredConjunction> closed = std::move(finished_);
+    finished_.clear();
+
+    for (auto it = open_.begin(); it != open_.end();) {
+        if (it->second.last_seen_minutes < t_minutes) {
+            closed.push_back(it->second.best);
+            it = open_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    std::sort(closed.begin(), closed.end(), by_tca);
+    return closed;
+}
+
+std::vector<MonitoredConjunction> EncounterTracker::open_events() const {
+    std::vector<MonitoredConjunction> events;
+    events.reserve(open_.size());
+    for (const auto& [key, encounter] : open_) events.push_back(encounter.best);
+    return events;
+}
+
+std::vector<MonitoredConjunction> EncounterTracker::flush() {
+    return close_before(std::numeric_limits<double>::infinity());
+}
+
+void EncounterTracker::drop(const std::vector<uint8_t>& objects) {
+    auto flagged = [&objects](const MonitoredConjunction& e) {
+        return (e.sat1_id < objects.size() && objects[e.sat1_id]) ||
+               (e.sat2_id < objects.size() && objects[e.sat2_id]);
+    };
+    for (auto it = open_.begin(); it != open_.end();) {
+        it = flagged(it->second.best) ? open_.erase(it) : std::next(it);
+    }
+    finished_.erase(std::remove_if(finished_.begin(), finished_.end(), flagged), finished_.end());
+}
+
+void EncounterTracker::remap(const std::vector<int64_t>& old_to_new) {
+    auto renumber = [&old_to_new](MonitoredConjunction& e) {
+        if (e.sat1_id >= old_to_new.size() || e.sat2_id >= old_to_new.size()) return false;
+        int64_t a = old_to_new[e.sat1_id], b = old_to_new[e.sat2_id];
+        if (a < 0 || b < 0) return false;
+        e.sat1_id = static_cast<uint32_t>(std::min(a, b));
+        e.sat2_id = static_cast<uint32_t>(std::max(a, b));
+        return true;
+    };
+
+    std::unordered_map<uint64_t, OpenEncounter> remapped;
+    for (auto& [key, encounter] : open_) {
+        if (renumber(encounter.best)) {
+            remapped.emplace(pair_key(encounter.best.sat1_id, encounter.best.sat2_id), encounter);
+        }
+    }
+    open_ = std::move(remapped);
+
+    std::vector<MonitoredConjunction> finished;
+    for (auto& e : finished_) {
+        if (renumber(e)) finished.push_back(e);
+    }
+    finished_ = std::move(finished);
+}
+
+void EncounterTracker::merge(EncounterTracker&& other) {
+    for (auto& [key, encounter] : other.open_) open_[key] = encounter;
+    finished_.insert(finished_.end(), other.finished_.begin(), other.finished_.end());
+    other.open_.clear();
+    other.finished_.clear();
+}
+
+std::vector<MonitoredConjunction> screen_window(
+    SatelliteSystem& sys,
+    double start_minutes,
+    double end_minutes,
+    const MonitorConfig& config,
+    const CancellationToken* cancel
+) {
+    EncounterTracker tracker(config);
+    SpatialGrid grid(config.threshold_km * 2);  // Cell size = 2x threshold
+
+    const double step_minutes = config.step_seconds / 60.0;
+    for (double t = start_minutes; t <= end_minutes; t += step_minutes) {
+        propagate_all_optimized(sys, t, cancel);
+        grid.build(sys);
+        auto pairs = grid.find_close_pairs(sys, config.threshold_km, cancel);
+        if (is_cancelled(cancel)) return {};
+
+        tracker.observe(sys, pairs, t);
+    }
+
+    return tracker.flush();
+}
+
+ConjunctionEventTable::ConjunctionEventTable(const MonitorConfig& config)
+    : config_(config) {}
+
+bool ConjunctionEventTable::materially_changed(const MonitoredConjunction& before,
+                                               const MonitoredConjunction& after) const {
+    auto relative = [](double a, double b) {
+        double scale = std::max(std::abs(a), std::abs(b));
+        return scale > 0.0 ? std::abs(a - b) / scale : 0.0;
+    };
+    return relative(before.miss_distance_km, after.miss_distance_km) > config_.change_fraction ||
+           relative(before.collision_probability, after.collision_probability) > config_.change_fraction ||
+           std::abs(before.tca_minutes - after.tca_minutes) > 0.5 * config_.tca_match_minutes;
+}
+
+std::vector<ConjunctionUpdate> ConjunctionEventTable::apply(
+    const std::vector<MonitoredConjunction>& screened,
+    double from_minutes,
+    double to_minutes,
+    const std::vector<uint8_t>* objects,
+    const std::vector<MonitoredConjunction>* open
+) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<ConjunctionUpdate> updates;
+
+    std::unordered_map<uint64_t, double> open_tca;   // Pair key -> TCA so far
+    if (open) {
+        for (const auto& e : *open) open_tca.emplace(pair_key(e.sat1_id, e.sat2_id), e.tca_minutes);
+    }
+
+    auto in_scope = [objects](const MonitoredConjunction& e) {
+        if (objects == nullptr) return true;
+        return (e.sat1_id < objects->size() && (*objects)[e.sat1_id]) ||
+               (e.sat2_id < objects->size() && (*objects)[e.sat2_id]);
+    };
+
+    // Existing events in range, by pair; matched ones are removed
+    std::unordered_multimap<uint64_t, uint64_t> candidates;
+    for (const auto& [id, event] : events_) {
+        if (event.tca_minutes >= from_minutes && event.tca_minutes <= to_minutes && in_scope(event)) {
+            candidates.emplace(pair_key(event.sat1_id, event.sat2_id), id);
+        }
+    }
+
+    for (const auto& fresh : screened) {
+        // Closest existing TCA of the same pair within the match window
+        auto range = candidates.equal_range(pair_key(fresh.sat1_id, fresh.sat2_id));
+        auto match = candidates.end();
+        double best_gap = config_.tca_match_minutes;
+        for (auto it = range.first; it != range.second; ++it) {
+            double gap = std::abs(events_[it->second].tca_minutes - fresh.tca_minutes);
+            if (gap <= best_gap) {
+                best_gap = gap;
+                match = it;
+            }
+        }
+
+        if (match == candidates.end()) {
+            MonitoredConjunction event = fresh;
+            event.event_id = next_event_id_++;
+            event.revision = 0;
+            events_[event.event_id] = event;
+            updates.push_back({UpdateKind::NEW, event});
+            continue;
+        }
+
+        MonitoredConjunction& existing = events_[match->second];
+        auto held = held_.find(match->first);
+        if (held != held_.end() && held->second == match->second) held_.erase(held);
+        candidates.erase(match);
+
+        if (materially_changed(existing, fresh)) {
+            uint64_t id = existing.event_id;
+            uint32_t revision = existing.revision + 1;
+            existing = fresh;
+            existing.event_id = id;
+            existing.revision = revision;
+            updates.push_back({UpdateKind::CHANGED, existing});
+        }
+    }
+
+    // In range but no longer predicted, unless the pair's encounter is
+    // still open: it is settled when that encounter closes
+    for (const auto& [key, id] : candidates) {
+        auto it = open_tca.find(key);
+        if (it != open_tca.end() && std::abs(events_[id].tca_minutes - it->second) <= config_.tca_match_minutes) {
+            held_[key] = id;
+            continue;
+        }
+        auto held = held_.find(key);
+        if (held != held_.end() && held->second == id) held_.erase(held);
+        updates.push_back({UpdateKind::RESOLVED, events_[id]});
+        events_.erase(id);
+    }
+
+    if (!updates.empty()) generation_++;
+    return updates;
+}
+
+std::vector<ConjunctionUpdate> ConjunctionEventTable::add(
+    const std::vector<MonitoredConjunction>& screened
+) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<ConjunctionUpdate> updates;
+    updates.reserve(screened.size());
+
+    for (const auto& fresh : screened) {
+        auto held = held_.find(pair_key(fresh.sat1_id, fresh.sat2_id));
+        if (held != held_.end()) {
+            const uint64_t id = held->second;
+            held_.erase(held);
+            auto it = events_.find(id);
+            if (it != events_.end()) {
+                MonitoredConjunction& existing = it->second;
+                if (std::abs(existing.tca_minutes - fresh.tca_minutes) <= config_.tca_match_minutes) {
+                    if (materially_changed(existing, fresh)) {
+                        const uint32_t revision = existing.revision + 1;
+                        existing = fresh;
+                        existing.event_id = id;
+                        existing.revision = revision;
+                        updates.push_back({UpdateKind::CHANGED, existing});
+                    }
+                    continue;
+                }
+                updates.push_back({UpdateKind::RESOLVED, existing});
+                events_.erase(it);
+            }
+        }
+
+        MonitoredConjunction event = fresh;
+        event.event_id = next_event_id_++;
+        event.revision = 0;
+        events_[event.event_id] = event;
+        updates.push_back({UpdateKind::NEW, event});
+    }
+
+    if (!updates.empty()) generation_++;
+    return updates;
+}
+
+std::vector<ConjunctionUpdate> ConjunctionEventTable::remap(const std::vector<int64_t>& old_to_new) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<ConjunctionUpdate> updates;
+
+    for (auto it = events_.begin(); it != events_.end();) {
+        MonitoredConjunction& event = it->second;
+        int64_t a = event.sat1_id < old_to_new.size() ? old_to_new[event.sat1_id] : -1;
+        int64_t b = event.sat2_id < old_to_new.size() ? old_to_new[event.sat2_id] : -1;
+
+        if (a < 0 || b < 0) {
+            updates.push_back({UpdateKind::RESOLVED, event});
+            it = events_.erase(it);
+            continue;
+        }
+
+        uint32_t sat1 = static_cast<uint32_t>(std::min(a, b));
+        uint32_t sat2 = static_cast<uint32_t>(std::max(a, b));
+        if (sat1 != event.sat1_id || sat2 != event.sat2_id) {
+            event.sat1_id = sat1;
+            event.sat2_id = sat2;
+            event.revision++;
+            updates.push_back({UpdateKind::CHANGED, event});
+        }
+        ++it;
+    }
+
+    // Held events follow their renumbered pair
+    std::unordered_map<uint64_t, uint64_t> held;
+    for (const auto& [key, id] : held_) {
+        auto it = events_.find(id);
+        if (it != events_.end()) held.emplace(pair_key(it->second.sat1_id, it->second.sat2_id), id);
+    }
+    held_ = std::move(held);
+
+    if (!updates.empty()) generation_++;
+    return updates;
+}
+
+size_t ConjunctionEventTable::expire_before(double now_minutes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    size_t expired = 0;
+    for (auto it = events_.begin(); it != events_.end();) {
+        if (it->second.tca_minutes < now_minutes) {
+            auto held = held_.find(pair_key(it->second.sat1_id, it->second.sat2_id));
+            if (held != held_.end() && held->second == it->first) held_.erase(held);
+            it = events_.erase(it);
+            expired++;
+        } else {
+            ++it;
+        }
+    }
+    if (expired > 0) generation_++;
+    return expired;
+}
+
+void ConjunctionEventTable::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    held_.clear();
+    if (events_.empty()) return;
+    events_.clear();
+    generation_++;
+}
+
+ConjunctionEventTable::Events ConjunctionEventTable::events() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (view_generation_ != generation_ || !view_) {
+        auto view = std::make_shared<std::vector<MonitoredConjunction>>();
+        view->reserve(events_.size());
+        for (const auto& [id, event] : events_) view->push_back(event);
+        std::sort(view->begin(), view->end(),
+                  [](const MonitoredConjunction& a, const MonitoredConjunction& b) {
+                      return a.tca_minutes < b.tca_minutes;
+                  });
+        view_ = std::move(view);
+        view_generation_ = generation_;
+    }
+    return view_;
+}
+
+uint64_t ConjunctionEventTable::generation() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return generation_;
+}
+
+} // namespace orbitops
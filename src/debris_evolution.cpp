@@ -0,0 +1,207 @@
+#include "debris_evolution.hpp"
+#include "debris_system.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace orbitops {
+
+namespace {
+    constexpr double RE = 6378.137;              // km (propagator radius, drag perigee heights)
+    constexpr double EARTH_RADIUS = 6371.0;      // km (debris altitude convention, statistics)
+    constexpr double MU = 398600.4418;           // km^3/s^2
+    constexpr double DAYS_PER_YEAR = 365.25;
+
+    // Evolving elements (SoA); rows are initial objects then fragments
+    struct Population {
+        std::vector<double> a;                   // km
+        std::vector<double> e;
+        std::vector<double> incl;                // radians
+        std::vector<double> bstar;
+        std::vector<double> ballistic;           // Cd A/m, m²/kg
+        std::vector<float> reentry_days;
+
+        void push(double a_km, double ecc, double incl_rad, double b) {
+            a.push_back(a_km);
+            e.push_back(ecc);
+            incl.push_back(incl_rad);
+            bstar.push_back(b);
+            ballistic.push_back(ballistic_coefficient_from_bstar(b));
+            reentry_days.push_back(-1.0f);
+        }
+    };
+
+    EvolutionSnapshot take_snapshot(const Population& pop, const std::vector<uint32_t>& active,
+                                    const ShellBinning& binning, double time_days, double f107,
+                                    size_t reentered, size_t injected, size_t broken_up) {
+        EvolutionSnapshot snap;
+        snap.time_days = time_days;
+        snap.f107 = f107;
+        snap.population = active.size();
+        snap.reentered = reentered;
+        snap.injected = injected;
+        snap.broken_up = broken_up;
+        snap.shell_counts.assign(binning.altitude_bins(), 0);
+
+        double altitude_sum = 0.0;
+        for (uint32_t row : active) {
+            const double altitude = pop.a[row] - EARTH_RADIUS;
+            altitude_sum += altitude;
+
+            switch (classify_orbit_regime(altitude, pop.e[row])) {
+                case OrbitRegime::LEO: ++snap.leo; break;
+                case OrbitRegime::MEO: ++snap.meo; break;
+                case OrbitRegime::GEO: ++snap.geo; break;
+                case OrbitRegime::HEO: ++snap.heo; break;
+            }
+            if (altitude >= binning.min_altitude_km && altitude < binning.max_altitude_km) {
+                const auto shell = static_cast<size_t>((altitude - binning.min_altitude_km) /
+                                                       binning.shell_thickness_km);
+                if (shell < snap.shell_counts.size()) ++snap.shell_counts[shell];
+            }
+        }
+        snap.mean_altitude_km = active.empty() ? 0.0 : altitude_sum / active.size();
+        return snap;
+    }
+}
+
+EvolutionResult evolve_debris_environment(
+    const SatelliteSystem& sys,
+    const std::vector<uint32_t>& objects,
+    const EvolutionConfig& config,
+    const std::vector<ScheduledBreakup>& breakups,
+    const CancellationToken* cancel
+) {
+    ORBITOPS_TRACE_SCOPE_ARG("evolution.run", objects.size());
+    EvolutionResult result;
+
+    if (!(config.step_days > 0.0) || !(config.duration_years >= 0.0) ||
+        !(config.snapshot_interval_days > 0.0)) {
+        result.error_message = "Invalid step, duration or snapshot interval";
+        return result;
+    }
+
+    Population pop;
+    pop.a.reserve(objects.size());
+    for (uint32_t i : objects) {
+        if (i >= sys.count) {
+            result.error_message = "Object index out of range";
+            return result;
+        }
+        pop.push(sys.a0[i], sys.ecc[i], sys.incl[i], sys.bstar[i]);
+    }
+    result.initial_count = objects.size();
+
+    std::vector<uint32_t> active(objects.size());
+    std::iota(active.begin(), active.end(), 0u);
+
+    // Breakups in time order
+    std::vector<size_t> schedule(breakups.size());
+    std::iota(schedule.begin(), schedule.end(), size_t{0});
+    std::stable_sort(schedule.begin(), schedule.end(), [&](size_t l, size_t r) {
+        return breakups[l].time_days < breakups[r].time_days;
+    });
+    size_t next_breakup = 0;
+
+    const double duration = config.duration_years * DAYS_PER_YEAR;
+    const double cutoff = RE + config.reentry_altitude_km;
+    const double max_decay = config.max_decay_per_scale_height;
+    size_t reentered = 0;
+    size_t injected = 0;
+    size_t broken_up = 0;
+
+    result.snapshots.push_back(take_snapshot(pop, active, config.binning, 0.0,
+                                             config.solar.f107(0.0), 0, 0, 0));
+    double next_snapshot = config.snapshot_interval_days;
+
+    for (double t = 0.0; t < duration; ) {
+        if (is_cancelled(cancel)) {
+            result.error_message = "Cancelled";
+            break;   // Snapshots so far are kept
+        }
+        const double dt = std::min(config.step_days, duration - t);
+
+        // Fragment parents still in orbit at the start of the step in which
+        // their breakup falls
+        while (next_breakup < schedule.size() && breakups[schedule[next_breakup]].time_days < t + dt) {
+            const ScheduledBreakup& scheduled = breakups[schedule[next_breakup++]];
+            const uint32_t o = scheduled.object;
+            if (o >= pop.a.size()) {
+                result.error_message = "Breakup object index out of range";
+                return result;
+            }
+            if (pop.reentry_days[o] >= 0.0f || std::find(active.begin(), active.end(), o) == active.end()) {
+                continue;   // Already reentered or broken up
+            }
+
+            // Parent at its current orbit; orientation angles do not matter
+            // for the decay model
+            SatelliteSystem parent;
+            parent.allocate(1);
+            parent.incl[0] = pop.incl[o];
+            parent.raan0[0] = parent.argp0[0] = parent.M0[0] = 0.0;
+            parent.ecc[0] = pop.e[o];
+            parent.a0[0] = pop.a[o];
+            parent.n0[0] = std::sqrt(MU / (pop.a[o] * pop.a[o] * pop.a[o])) * 60.0;
+            parent.bstar[0] = pop.bstar[o];
+
+            BreakupEvent event = scheduled.event;
+            event.parent = 0;
+            event.time_minutes = 0.0;
+            BreakupResult cloud = simulate_breakup(parent, event);
+            if (!cloud.success) {
+                result.error_message = cloud.error_message;
+                return result;
+            }
+            const size_t added = inject_fragments(parent, cloud.fragments, "", 0, config.reentry_altitude_km);
+
+            active.erase(std::find(active.begin(), active.end(), o));
+            for (size_t k = 1; k <= added; ++k) {
+                active.push_back(static_cast<uint32_t>(pop.a.size()));
+                pop.push(parent.a0[k], parent.ecc[k], parent.incl[k], parent.bstar[k]);
+            }
+            injected += added;
+            ++broken_up;
+        }
+
+        const double f107 = config.solar.f107((t + 0.5 * dt) / DAYS_PER_YEAR);
+        double* __restrict a = pop.a.data();
+        double* __restrict e = pop.e.data();
+        const double* __restrict ballistic = pop.ballistic.data();
+        float* __restrict reentry = pop.reentry_days.data();
+        const uint32_t* rows = active.data();
+        const size_t n = active.size();
+
+        #pragma omp parallel for schedule(dynamic, 1024)
+        for (size_t k = 0; k < n; ++k) {
+            const uint32_t row = rows[k];
+            double ak = a[row];
+            double ek = e[row];
+            const double elapsed = integrate_drag_decay(ak, ek, ballistic[row], f107, dt, cutoff, max_decay);
+
+            a[row] = ak;
+            e[row] = ek;
+            if (ak * (1.0 - ek) < cutoff) {
+                reentry[row] = static_cast<float>(t + elapsed);
+            }
+        }
+
+        const size_t before = active.size();
+        std::erase_if(active, [&](uint32_t row) { return reentry[row] >= 0.0f; });
+        reentered += before - active.size();
+        t += dt;
+
+        if (t >= next_snapshot || t >= duration) {
+            result.snapshots.push_back(take_snapshot(pop, active, config.binning, t, f107,
+                                                     reentered, injected, broken_up));
+            while (next_snapshot <= t) next_snapshot += config.snapshot_interval_days;
+        }
+    }
+
+    result.reentry_days = std::move(pop.reentry_days);
+    result.success = result.error_message.empty();
+    return result;
+}
+
+} // namespace orbitops
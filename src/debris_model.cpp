@@ -1,17 +1,13 @@
 #include "debris_model.hpp"
+#include "sgp4_optimized.hpp"
+#include "trace.hpp"
 #include <algorithm>
-#include <cstring>
-#include <regex>
+#include <cctype>
 #include <map>
+#include <unordered_map>
 
 namespace orbitops {
 
-// Known debris-related keywords in TLE names
-static const std::vector<std::string> DEBRIS_KEYWORDS = {
-    "DEB", "DEBRIS", "R/B", "ROCKET", "FRAG", "FRAGMENT",
-    "COOLANT", "NaK", "TANK", "PLATFORM", "OBJECT"
-};
-
 // Known fragmentation event parent objects (partial catalog numbers)
 static const std::vector<int> KNOWN_DEBRIS_PARENTS = {
     13552,   // Cosmos 954 (nuclear reactor debris)
@@ -22,109 +18,168 @@ static const std::vector<int> KNOWN_DEBRIS_PARENTS = {
     40258,   // Cosmos 1408 (Russian ASAT test 2021)
 };
 
-DebrisModel::DebrisModel() : config_() {}
+namespace {
+    constexpr double EARTH_RADIUS = 6371.0;   // km
 
-DebrisModel::DebrisModel(const DebrisConfig& config) : config_(config) {}
+    // Debris-related keywords in TLE names, one bit each
+    enum NameKeyword : uint32_t {
+        KW_DEB      = 1u << 0,    // Also matches DEBRIS
+        KW_RB       = 1u << 1,
+        KW_ROCKET   = 1u << 2,
+        KW_FRAG     = 1u << 3,    // Also matches FRAGMENT
+        KW_COOLANT  = 1u << 4,
+        KW_NAK      = 1u << 5,
+        KW_TANK     = 1u << 6,
+        KW_PLATFORM = 1u << 7,
+        KW_OBJECT   = 1u << 8,
+    };
 
-bool DebrisModel::is_debris(const TLE& tle) {
-    // Check name for debris keywords
-    std::string upper_name = tle.name;
-    std::transform(upper_name.begin(), upper_name.end(), upper_name.begin(), ::toupper);
-    
-    for (const auto& keyword : DEBRIS_KEYWORDS) {
-        if (upper_name.find(keyword) != std::string::npos) {
-            return true;
+    struct KeywordEntry {
+        const char* text;
+        uint32_t bit;
+    };
+
+    const KeywordEntry NAME_KEYWORDS[] = {
+        {"DEB", KW_DEB}, {"R/B", KW_RB}, {"ROCKET", KW_ROCKET}, {"FRAG", KW_FRAG},
+        {"COOLANT", KW_COOLANT}, {"NAK", KW_NAK}, {"TANK", KW_TANK},
+        {"PLATFORM", KW_PLATFORM}, {"OBJECT", KW_OBJECT},
+    };
+
+    // Uppercase the name once and collect every keyword it contains
+    uint32_t name_keywords(const std::string& name) {
+        std::string upper_name = name;
+        for (auto& c : upper_name) {
+            c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
         }
-    }
-    
-    // Check international designator for debris indicators
-    // Format: YYNNNXX where XX can indicate debris piece
-    if (tle.intl_designator.length() >= 7) {
-        char piece = tle.intl_designator.back();
-        // Pieces beyond 'Z' or numbered fragments indicate debris
-        if (piece >= 'B' && tle.intl_designator.find("DEB") == std::string::npos) {
-            // Multiple pieces from same launch could be debris
-            int piece_count = piece - 'A';
-            if (piece_count > 5) {
-                return true;  // Likely debris if many pieces
+
+        uint32_t bits = 0;
+        for (const auto& keyword : NAME_KEYWORDS) {
+            if (upper_name.find(keyword.text) != std::string::npos) {
+                bits |= keyword.bit;
             }
         }
+        return bits;
     }
-    
-    // High B* drag term indicates small, high-drag object (possible debris)
-    if (std::abs(tle.bstar) > 0.01) {
-        return true;
-    }
-    
-    return false;
-}
 
-DebrisType DebrisModel::classify_debris(const TLE& tle) {
-    std::string upper_name = tle.name;
-    std::transform(upper_name.begin(), upper_name.end(), upper_name.begin(), ::toupper);
-    
-    if (upper_name.find("R/B") != std::string::npos ||
-        upper_name.find("ROCKET") != std::string::npos) {
-        return DebrisType::ROCKET_BODY;
+    // Mean altitude from mean motion (rev/day)
+    double mean_altitude_from_tle(const TLE& tle) {
+        double a = 42241.122 / std::pow(tle.mean_motion, 2.0/3.0);
+        return a - EARTH_RADIUS;
     }
-    
-    if (upper_name.find("FRAG") != std::string::npos ||
-        upper_name.find("FRAGMENT") != std::string::npos) {
-        return DebrisType::FRAGMENTATION;
-    }
-    
-    if (upper_name.find("DEB") != std::string::npos) {
-        // Could be from mission or fragmentation
-        // Check if it's from a known fragmentation event
-        for (int parent : KNOWN_DEBRIS_PARENTS) {
-            if (std::abs(tle.catalog_number - parent) < 5000) {
-                return DebrisType::FRAGMENTATION;
+
+    bool is_debris_from(uint32_t keywords, const TLE& tle) {
+        if (keywords != 0) {
+            return true;
+        }
+        
+        // Check international designator for debris indicators
+        // Format: YYNNNXX where XX can indicate debris piece
+        if (tle.intl_designator.length() >= 7) {
+            char piece = tle.intl_designator.back();
+            // Pieces beyond 'Z' or numbered fragments indicate debris
+            if (piece >= 'B' && tle.intl_designator.find("DEB") == std::string::npos) {
+                // Multiple pieces from same launch could be debris
+                int piece_count = piece - 'A';
+                if (piece_count > 5) {
+                    return true;  // Likely debris if many pieces
+                }
             }
         }
-        return DebrisType::PAYLOAD_DEBRIS;
-    }
-    
-    if (upper_name.find("COOLANT") != std::string::npos ||
-        upper_name.find("NAK") != std::string::npos ||
-        upper_name.find("TANK") != std::string::npos) {
-        return DebrisType::MISSION_DEBRIS;
+        
+        // High B* drag term indicates small, high-drag object (possible debris)
+        return std::abs(tle.bstar) > 0.01;
     }
-    
-    return DebrisType::UNKNOWN;
-}
 
-DebrisSize DebrisModel::estimate_size(const TLE& tle) {
-    // Estimate based on B* drag term and mean motion
-    // Higher B* and faster decay = smaller/lighter object
-    
-    double a = 42241.122 / std::pow(tle.mean_motion * 1440 / (2 * M_PI), 2.0/3.0);
-    double altitude = a - 6371.0;
-    
-    // Objects in very low orbits with high B* are typically small
-    if (altitude < 300 && std::abs(tle.bstar) > 0.001) {
-        return DebrisSize::SMALL;
+    DebrisType type_from(uint32_t keywords, int catalog_number) {
+        if (keywords & (KW_RB | KW_ROCKET)) {
+            return DebrisType::ROCKET_BODY;
+        }
+        
+        if (keywords & KW_FRAG) {
+            return DebrisType::FRAGMENTATION;
+        }
+        
+        if (keywords & KW_DEB) {
+            // Could be from mission or fragmentation
+            // Check if it's from a known fragmentation event
+            for (int parent : KNOWN_DEBRIS_PARENTS) {
+                if (std::abs(catalog_number - parent) < 5000) {
+                    return DebrisType::FRAGMENTATION;
+                }
+            }
+            return DebrisType::PAYLOAD_DEBRIS;
+        }
+        
+        if (keywords & (KW_COOLANT | KW_NAK | KW_TANK)) {
+            return DebrisType::MISSION_DEBRIS;
+        }
+        
+        return DebrisType::UNKNOWN;
     }
-    
-    // Rocket bodies are typically large
-    std::string upper_name = tle.name;
-    std::transform(upper_name.begin(), upper_name.end(), upper_name.begin(), ::toupper);
-    if (upper_name.find("R/B") != std::string::npos) {
+
+    DebrisSize size_from(uint32_t keywords, double altitude_km, double bstar) {
+        // Higher B* and faster decay = smaller/lighter object
+        
+        // Objects in very low orbits with high B* are typically small
+        if (altitude_km < 300 && std::abs(bstar) > 0.001) {
+            return DebrisSize::SMALL;
+        }
+        
+        // Rocket bodies are typically large
+        if (keywords & KW_RB) {
+            return DebrisSize::LARGE;
+        }
+        
+        // Most tracked debris is medium to large (small is not typically tracked)
+        if (std::abs(bstar) > 0.005) {
+            return DebrisSize::MEDIUM;
+        }
+        
         return DebrisSize::LARGE;
     }
-    
-    // Most tracked debris is medium to large (small is not typically tracked)
-    if (std::abs(tle.bstar) > 0.005) {
-        return DebrisSize::MEDIUM;
+
+    // Baseline hazard to other objects from size and regime; CRITICAL is
+    // left to encounter assessment
+    DebrisRisk baseline_risk(DebrisSize size, OrbitRegime regime, int decay_days) {
+        if (decay_days >= 0 && decay_days < 30) return DebrisRisk::NEGLIGIBLE;
+        if (regime != OrbitRegime::LEO) return DebrisRisk::LOW;
+        switch (size) {
+            case DebrisSize::LARGE:  return DebrisRisk::HIGH;
+            case DebrisSize::MEDIUM: return DebrisRisk::MEDIUM;
+            default:                 return DebrisRisk::LOW;
+        }
     }
-    
-    return DebrisSize::LARGE;
+
+    // YYNNN launch prefix of an international designator (0 if malformed)
+    uint32_t launch_key(const std::string& designator) {
+        if (designator.length() < 5) return 0;
+        uint32_t key = 0;
+        for (size_t i = 0; i < 5; ++i) {
+            if (!std::isdigit(static_cast<unsigned char>(designator[i]))) return 0;
+            key = key * 10 + static_cast<uint32_t>(designator[i] - '0');
+        }
+        return key;
+    }
+}
+
+DebrisModel::DebrisModel() : config_() {}
+
+DebrisModel::DebrisModel(const DebrisConfig& config) : config_(config) {}
+
+bool DebrisModel::is_debris(const TLE& tle) {
+    return is_debris_from(name_keywords(tle.name), tle);
+}
+
+DebrisType DebrisModel::classify_debris(const TLE& tle) {
+    return type_from(name_keywords(tle.name), tle.catalog_number);
+}
+
+DebrisSize DebrisModel::estimate_size(const TLE& tle) {
+    return size_from(name_keywords(tle.name), mean_altitude_from_tle(tle), tle.bstar);
 }
 
-double DebrisModel::estimate_rcs(const TLE& tle) {
+double DebrisModel::estimate_rcs(DebrisSize size, DebrisType type) {
     // Rough estimate based on debris type and size
-    DebrisSize size = estimate_size(tle);
-    DebrisType type = classify_debris(tle);
-    
     double base_rcs = 0.01;  // 0.01 m² default
     
     switch (size) {
@@ -147,13 +202,7 @@ double DebrisModel::estimate_rcs(const TLE& tle) {
     return base_rcs;
 }
 
-int DebrisModel::estimate_decay_days(const TLE& tle) {
-    // Calculate semi-major axis
-    double n_rad_min = tle.mean_motion;
-    double n_rev_day = n_rad_min * 1440 / (2 * M_PI);
-    double a = 42241.122 / std::pow(n_rev_day, 2.0/3.0);
-    double altitude_km = a - 6371.0;
-    
+int DebrisModel::estimate_decay_days(double altitude_km, double bstar) {
     // Very rough decay estimate based on altitude and B*
     if (altitude_km > 800) {
         return -1;  // Essentially permanent
@@ -165,197 +214,370 @@ int DebrisModel::estimate_decay_days(const TLE& tle) {
     
     // Rough lifetime formula: L ≈ H / (k * B* * rho)
     // where H is scale height, k is constant, rho is density
-    double bstar_abs = std::abs(tle.bstar) + 1e-10;
+    double bstar_abs = std::abs(bstar) + 1e-10;
     double decay_years = std::pow(altitude_km / 100.0, 2.5) / (bstar_abs * 1e6);
     
     return static_cast<int>(decay_years * 365);
 }
 
-void DebrisModel::load_from_tles(const std::vector<TLE>& tles) {
+void DebrisModel::load(const std::vector<TLE>& tles, const SatelliteSystem& sys) {
     debris_.clear();
+    catalog_version_++;
     
-    int debris_id = 0;
-    for (const auto& tle : tles) {
-        if (!is_debris(tle)) {
+    const size_t n = std::min(tles.size(), sys.count);
+    for (size_t i = 0; i < n; ++i) {
+        const TLE& tle = tles[i];
+        
+        // Name keywords are scanned once per object and reused by every classifier
+        const uint32_t keywords = name_keywords(tle.name);
+        if (!is_debris_from(keywords, tle)) {
             continue;
         }
         
-        if (static_cast<int>(debris_.size()) >= config_.max_debris_objects) {
+        if (debris_.count >= static_cast<size_t>(std::max(config_.max_debris_objects, 0))) {
             break;
         }
         
-        DebrisObject obj;
-        obj.id = debris_id++;
-        obj.name = tle.name;
-        obj.origin = tle.intl_designator;
-        obj.type = classify_debris(tle);
-        obj.size = estimate_size(tle);
-        obj.rcs = estimate_rcs(tle);
-        
-        // Estimate mass from RCS (very rough)
-        obj.estimated_mass_kg = obj.rcs * 10.0;  // 10 kg/m² average
-        
-        // Calculate orbital parameters
-        double n_rad_min = tle.mean_motion;
-        double n_rev_day = n_rad_min * 1440 / (2 * M_PI);
-        double a = 42241.122 / std::pow(n_rev_day, 2.0/3.0);
-        
-        obj.apogee_km = a * (1 + tle.eccentricity) - 6371.0;
-        obj.perigee_km = a * (1 - tle.eccentricity) - 6371.0;
-        obj.altitude_km = (obj.apogee_km + obj.perigee_km) / 2.0;
-        obj.inclination_deg = tle.inclination * 180.0 / M_PI;
-        obj.decay_days = estimate_decay_days(tle);
-        obj.created_epoch = tle.epoch_jd;
-        
-        // Position will be updated separately
-        obj.position = {0, 0, 0};
-        obj.velocity = {0, 0, 0};
+        // Orbital parameters from the SoA elements
+        const double a = sys.a0[i];
+        const double apogee = a * (1 + sys.ecc[i]) - EARTH_RADIUS;
+        const double perigee = a * (1 - sys.ecc[i]) - EARTH_RADIUS;
+        const double altitude = a - EARTH_RADIUS;
         
         // Apply altitude filter
-        if (obj.perigee_km < config_.min_altitude_km ||
-            obj.apogee_km > config_.max_altitude_km) {
+        if (perigee < config_.min_altitude_km || apogee > config_.max_altitude_km) {
             continue;
         }
         
+        const DebrisType type = type_from(keywords, tle.catalog_number);
+        
         // Type filter
-        if (obj.type == DebrisType::ROCKET_BODY && !config_.include_rocket_bodies) {
+        if (type == DebrisType::ROCKET_BODY && !config_.include_rocket_bodies) {
             continue;
         }
-        if ((obj.type == DebrisType::FRAGMENTATION || 
-             obj.type == DebrisType::PAYLOAD_DEBRIS) && !config_.include_fragments) {
+        if ((type == DebrisType::FRAGMENTATION ||
+             type == DebrisType::PAYLOAD_DEBRIS) && !config_.include_fragments) {
             continue;
         }
         
-        debris_.push_back(obj);
+        const DebrisSize size = size_from(keywords, altitude, sys.bstar[i]);
+        const OrbitRegime regime = classify_orbit_regime(altitude, sys.ecc[i]);
+        const int decay_days = estimate_decay_days(altitude, sys.bstar[i]);
+        const double rcs = estimate_rcs(size, type);
+        
+        debris_.index.push_back(static_cast<uint32_t>(i));
+        debris_.flags.push_back(debris_flag(type) | debris_flag(size) |
+                                debris_flag(baseline_risk(size, regime, decay_days)) |
+                                debris_flag(regime));
+        debris_.mean_altitude_km.push_back(altitude);
+        debris_.perigee_km.push_back(perigee);
+        debris_.apogee_km.push_back(apogee);
+        debris_.rcs_m2.push_back(static_cast<float>(rcs));
+        debris_.mass_kg.push_back(static_cast<float>(rcs * 10.0));  // 10 kg/m² average
+        debris_.decay_days.push_back(decay_days);
+        debris_.launch.push_back(launch_key(tle.intl_designator));
+        debris_.designator.push_back(tle.intl_designator);
+        debris_.epoch_jd.push_back(tle.epoch_jd);
+        debris_.count++;
+    }
+    
+    predicted_reentries_ = 0;
+    row_of_.assign(sys.count, -1);
+    for (uint32_t row = 0; row < debris_.count; ++row) {
+        row_of_[debris_.index[row]] = static_cast<int32_t>(row);
     }
     
     identify_debris_fields();
+    render_buffer_.build(debris_, catalog_version_);
+    
+    small_debris_flux_ = SmallDebrisFluxTable();
+    if (config_.include_small_debris) {
+        SmallDebrisFluxConfig flux_config;
+        flux_config.reference_density = config_.small_debris_density;
+        small_debris_flux_.build(debris_, sys, flux_config);
+    }
 }
 
-void DebrisModel::update_positions(const SatelliteSystem& sys, const std::vector<TLE>& tles) {
-    // Match debris objects to satellite system positions by catalog number
-    for (auto& obj : debris_) {
-        // Find matching TLE by name
-        for (size_t i = 0; i < sys.count && i < tles.size(); ++i) {
-            if (tles[i].name == obj.name) {
-                obj.position = {sys.x[i], sys.y[i], sys.z[i]};
-                obj.velocity = {sys.vx[i], sys.vy[i], sys.vz[i]};
-                double r = obj.position.magnitude();
-                obj.altitude_km = r - 6371.0;
-                break;
-            }
+std::vector<SmallDebrisAssessment> DebrisModel::assess_small_debris(
+    const SatelliteSystem& sys,
+    const std::vector<uint32_t>& fleet,
+    const SmallDebrisExposure& exposure
+) const {
+    return orbitops::assess_small_debris(sys, fleet, small_debris_flux_, exposure);
+}
+
+EvolutionResult DebrisModel::evolve_environment(
+    const SatelliteSystem& sys,
+    const EvolutionConfig& config,
+    const std::vector<ScheduledBreakup>& breakups,
+    const CancellationToken* cancel
+) const {
+    return evolve_debris_environment(sys, debris_.index, config, breakups, cancel);
+}
+
+size_t DebrisModel::apply_reentry_predictions(const ReentryReport& report, const SatelliteSystem& sys) {
+    std::unordered_map<int, const ReentryPrediction*> by_catalog;
+    by_catalog.reserve(report.predictions.size());
+    for (const auto& pred : report.predictions) {
+        if (pred.reenters) by_catalog.emplace(pred.catalog_number, &pred);
+    }
+    
+    size_t updated = 0;
+    for (size_t row = 0; row < debris_.count && !by_catalog.empty(); ++row) {
+        const uint32_t i = debris_.index[row];
+        if (i >= sys.catalog_numbers.size()) continue;
+        const auto it = by_catalog.find(sys.catalog_numbers[i]);
+        if (it == by_catalog.end()) continue;
+        
+        const int decay_days = static_cast<int>(std::ceil(it->second->nominal_days));
+        const uint32_t flags = debris_.flags[row];
+        debris_.decay_days[row] = decay_days;
+        debris_.flags[row] = (flags & ~DEBRIS_RISK_MASK) |
+                             debris_flag(baseline_risk(debris_size(flags), orbit_regime(flags), decay_days));
+        ++updated;
+    }
+    predicted_reentries_ = updated;
+    return updated;
+}
+
+DebrisObject DebrisModel::get_object(uint32_t row, const SatelliteSystem& sys) const {
+    const uint32_t i = debris_.index[row];
+    const uint32_t flags = debris_.flags[row];
+    
+    DebrisObject obj;
+    obj.id = static_cast<int>(row);
+    obj.name = i < sys.names.size() ? sys.names[i] : std::string();
+    obj.origin = debris_.designator[row];
+    obj.type = debris_type(flags);
+    obj.size = debris_size(flags);
+    obj.rcs = debris_.rcs_m2[row];
+    obj.estimated_mass_kg = debris_.mass_kg[row];
+    obj.position = {0, 0, 0};
+    obj.velocity = {0, 0, 0};
+    obj.altitude_km = debris_.mean_altitude_km[row];
+    obj.inclination_deg = 0.0;
+    if (i < sys.count) {
+        obj.position = {sys.x[i], sys.y[i], sys.z[i]};
+        obj.velocity = {sys.vx[i], sys.vy[i], sys.vz[i]};
+        obj.inclination_deg = sys.incl[i] * 180.0 / M_PI;
+        const double r = obj.position.magnitude();
+        if (r > 0.1) {
+            obj.altitude_km = r - EARTH_RADIUS;   // Current altitude once propagated
         }
     }
+    obj.apogee_km = debris_.apogee_km[row];
+    obj.perigee_km = debris_.perigee_km[row];
+    obj.decay_days = debris_.decay_days[row];
+    obj.created_epoch = debris_.epoch_jd[row];
+    return obj;
+}
+
+bool DebrisModel::get_objects_at(const std::vector<uint32_t>& rows, const SatelliteSystem& sys, double time_minutes,
+                                 std::vector<DebrisObject>& objects, const CancellationToken* cancel) const {
+    const size_t n = rows.size();
+    std::vector<StateQuery> queries(n);
+    for (size_t k = 0; k < n; ++k) {
+        queries[k] = {debris_.index[rows[k]], time_minutes};
+    }
+    std::vector<double> state(6 * n);
+    const StateArrays out{state.data(), state.data() + n, state.data() + 2 * n,
+                          state.data() + 3 * n, state.data() + 4 * n, state.data() + 5 * n};
+    if (!propagate_states(sys, queries, out, cancel)) return false;
+    
+    objects.clear();
+    objects.reserve(n);
+    for (size_t k = 0; k < n; ++k) {
+        DebrisObject obj = get_object(rows[k], sys);
+        obj.position = {out.x[k], out.y[k], out.z[k]};
+        obj.velocity = {out.vx[k], out.vy[k], out.vz[k]};
+        const double r = obj.position.magnitude();
+        if (r > 0.1) {
+            obj.altitude_km = r - EARTH_RADIUS;
+        }
+        objects.push_back(std::move(obj));
+    }
+    return true;
 }
 
 void DebrisModel::identify_debris_fields() {
     debris_fields_.clear();
     
-    // Group debris by international designator prefix (YYNNN)
-    std::map<std::string, std::vector<int>> designator_groups;
-    
-    for (size_t i = 0; i < debris_.size(); ++i) {
-        if (debris_[i].origin.length() >= 5) {
-            std::string prefix = debris_[i].origin.substr(0, 5);
-            designator_groups[prefix].push_back(static_cast<int>(i));
-        }
+    // Group debris by international designator prefix (YYNNN): rows sorted
+    // by launch key, then one pass over the runs
+    std::vector<uint32_t> order;
+    order.reserve(debris_.count);
+    for (uint32_t row = 0; row < debris_.count; ++row) {
+        if (debris_.launch[row] != 0) order.push_back(row);
     }
+    std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+        return debris_.launch[a] < debris_.launch[b];
+    });
     
-    // Create debris fields for groups with multiple objects
+    // Create debris fields for groups with multiple objects; statistics
+    // wait for the first propagated epoch
     int field_id = 0;
-    for (const auto& [prefix, indices] : designator_groups) {
-        if (indices.size() >= 3) {  // At least 3 pieces to be a "field"
+    for (size_t begin = 0; begin < order.size();) {
+        size_t end = begin;
+        while (end < order.size() && debris_.launch[order[end]] == debris_.launch[order[begin]]) {
+            ++end;
+        }
+        
+        if (end - begin >= 3) {  // At least 3 pieces to be a "field"
             DebrisField field;
             field.event_id = field_id++;
-            field.event_name = "Debris from " + prefix;
-            field.debris_ids = indices;
-            field.total_fragments = static_cast<int>(indices.size());
-            
-            // Calculate average position and spread
-            Vec3 center = {0, 0, 0};
-            for (int idx : indices) {
-                center.x += debris_[idx].position.x;
-                center.y += debris_[idx].position.y;
-                center.z += debris_[idx].position.z;
-            }
-            center.x /= indices.size();
-            center.y /= indices.size();
-            center.z /= indices.size();
-            field.event_location = center;
-            
-            double max_dist = 0;
-            for (int idx : indices) {
-                Vec3 diff = debris_[idx].position - center;
-                max_dist = std::max(max_dist, diff.magnitude());
-            }
-            field.spread_radius_km = max_dist;
-            
-            debris_fields_.push_back(field);
+            field.event_name = "Debris from " + debris_.designator[order[begin]].substr(0, 5);
+            field.event_date = 0.0;
+            field.debris_ids.assign(order.begin() + begin, order.begin() + end);
+            field.indices.reserve(end - begin);
+            for (int row : field.debris_ids) field.indices.push_back(debris_.index[row]);
+            field.total_fragments = static_cast<int>(end - begin);
+            debris_fields_.push_back(std::move(field));
         }
+        begin = end;
     }
 }
 
-std::vector<DebrisObject> DebrisModel::get_debris_in_shell(double min_alt, double max_alt) const {
-    std::vector<DebrisObject> result;
-    for (const auto& obj : debris_) {
-        if (obj.altitude_km >= min_alt && obj.altitude_km <= max_alt) {
-            result.push_back(obj);
+void DebrisModel::update_field_statistics(const SatelliteSystem& sys, double epoch_minutes) {
+    ORBITOPS_TRACE_SCOPE_ARG("debris.field_statistics", debris_fields_.size());
+    const double* __restrict x = sys.x;
+    const double* __restrict y = sys.y;
+    const double* __restrict z = sys.z;
+    const double* __restrict vx = sys.vx;
+    const double* __restrict vy = sys.vy;
+    const double* __restrict vz = sys.vz;
+    
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (size_t f = 0; f < debris_fields_.size(); ++f) {
+        DebrisField& field = debris_fields_[f];
+        if (field.has_statistics && field.stats_epoch_minutes == epoch_minutes) continue;
+        
+        const uint32_t* idx = field.indices.data();
+        const size_t n = field.indices.size();
+        
+        // First and second position moments, mean velocity, the r.v moment
+        // and the sum of unit orbit normals, all in one pass
+        double sx = 0, sy = 0, sz = 0, sr2 = 0, srv = 0;
+        double svx = 0, svy = 0, svz = 0;
+        double snx = 0, sny = 0, snz = 0;
+        #pragma omp simd reduction(+:sx, sy, sz, sr2, srv, svx, svy, svz, snx, sny, snz)
+        for (size_t k = 0; k < n; ++k) {
+            const uint32_t i = idx[k];
+            const double px = x[i], py = y[i], pz = z[i];
+            const double ux = vx[i], uy = vy[i], uz = vz[i];
+            sx += px; sy += py; sz += pz;
+            sr2 += px * px + py * py + pz * pz;
+            srv += px * ux + py * uy + pz * uz;
+            svx += ux; svy += uy; svz += uz;
+            
+            const double hx = py * uz - pz * uy;
+            const double hy = pz * ux - px * uz;
+            const double hz = px * uy - py * ux;
+            const double h = std::sqrt(hx * hx + hy * hy + hz * hz);
+            const double inv = h > 0.0 ? 1.0 / h : 0.0;
+            snx += hx * inv; sny += hy * inv; snz += hz * inv;
         }
+        
+        const double inv_n = n > 0 ? 1.0 / n : 0.0;
+        const Vec3 centroid{sx * inv_n, sy * inv_n, sz * inv_n};
+        const double variance = sr2 * inv_n - (centroid.x * centroid.x + centroid.y * centroid.y +
+                                               centroid.z * centroid.z);
+        const double spread = std::sqrt(std::max(variance, 0.0));
+        const double resultant = std::sqrt(snx * snx + sny * sny + snz * snz) * inv_n;
+        
+        // d(spread)/dt = mean((r - c).(v - v_mean)) / spread, from this
+        // epoch's states alone
+        const Vec3 mean_velocity{svx * inv_n, svy * inv_n, svz * inv_n};
+        const double covariance = srv * inv_n - (centroid.x * mean_velocity.x + centroid.y * mean_velocity.y +
+                                                 centroid.z * mean_velocity.z);
+        field.spread_rate_km_per_day = spread > 0.0 ? covariance / spread * 86400.0 : 0.0;
+        field.centroid = centroid;
+        field.mean_velocity = mean_velocity;
+        field.spread_radius_km = spread;
+        field.plane_dispersion_deg = std::acos(std::min(resultant, 1.0)) * 180.0 / M_PI;
+        field.stats_epoch_minutes = epoch_minutes;
+        field.has_statistics = true;
     }
-    return result;
 }
 
-std::vector<DebrisObject> DebrisModel::get_debris_by_type(DebrisType type) const {
-    std::vector<DebrisObject> result;
-    for (const auto& obj : debris_) {
-        if (obj.type == type) {
-            result.push_back(obj);
-        }
+std::vector<uint32_t> DebrisModel::get_debris_in_shell(double min_alt, double max_alt) const {
+    return select_debris_in_shell(debris_, min_alt, max_alt);
+}
+
+std::vector<uint32_t> DebrisModel::get_debris_by_type(DebrisType type) const {
+    return select_debris(debris_, debris_flag(type));
+}
+
+std::vector<uint32_t> DebrisModel::get_debris_by_risk(DebrisRisk risk) const {
+    return select_debris(debris_, debris_flag(risk));
+}
+
+std::vector<uint32_t> DebrisModel::get_debris_crossing(const OrbitIntervalIndex& bands,
+                                                      double min_alt, double max_alt) const {
+    std::vector<uint32_t> rows;
+    if (bands.count() != row_of_.size()) return rows;
+    
+    // Catalog indices ascend, and rows keep catalog order, so rows ascend too
+    for (uint32_t i : bands.query(EARTH_RADIUS + min_alt, EARTH_RADIUS + max_alt)) {
+        if (row_of_[i] >= 0) rows.push_back(static_cast<uint32_t>(row_of_[i]));
     }
-    return result;
+    return rows;
 }
 
-std::vector<DebrisObject> DebrisModel::get_debris_by_risk(DebrisRisk risk) const {
-    // This would require satellite positions to calculate - return all for now
-    return debris_;
+std::vector<DebrisModel::ShellDensity> DebrisModel::calculate_shell_densities(
+    const SatelliteSystem& sys,
+    double shell_thickness
+) const {
+    ShellBinning binning;
+    binning.shell_thickness_km = shell_thickness;
+    auto table = shell_densities(sys, binning);
+    
+    std::vector<ShellDensity> densities(table->counts.size());
+    for (size_t s = 0; s < densities.size(); ++s) {
+        ShellDensity& shell = densities[s];
+        shell.min_altitude_km = binning.min_altitude_km + s * shell_thickness;
+        shell.max_altitude_km = std::min(shell.min_altitude_km + shell_thickness, binning.max_altitude_km);
+        shell.debris_count = static_cast<int>(table->counts[s]);
+        shell.spatial_density = table->spatial_density[s];
+        shell.flux = table->flux[s];
+    }
+    
+    return densities;
 }
 
-std::vector<DebrisModel::ShellDensity> DebrisModel::calculate_shell_densities(double shell_thickness) const {
-    std::vector<ShellDensity> densities;
+std::shared_ptr<const ShellDensityTable> DebrisModel::shell_densities(
+    const SatelliteSystem& sys,
+    const ShellBinning& binning,
+    double epoch_minutes
+) const {
+    const double epoch = binning.current_altitude ? epoch_minutes : 0.0;
+    
+    std::lock_guard<std::mutex> lock(density_mutex_);
+    auto it = std::find_if(density_tables_.begin(), density_tables_.end(), [&](const auto& table) {
+        return table->binning == binning;
+    });
+    if (it != density_tables_.end() &&
+        (*it)->catalog_version == catalog_version_ && (*it)->epoch_minutes == epoch) {
+        return *it;
+    }
     
-    // Calculate from 200 km to 2000 km (LEO)
-    for (double alt = 200; alt < 2000; alt += shell_thickness) {
-        ShellDensity shell;
-        shell.min_altitude_km = alt;
-        shell.max_altitude_km = alt + shell_thickness;
-        shell.debris_count = 0;
-        
-        for (const auto& obj : debris_) {
-            if (obj.altitude_km >= shell.min_altitude_km &&
-                obj.altitude_km < shell.max_altitude_km) {
-                shell.debris_count++;
-            }
+    auto table = std::make_shared<ShellDensityTable>(build_shell_density_table(debris_, sys, binning));
+    table->binning = binning;
+    table->catalog_version = catalog_version_;
+    table->epoch_minutes = epoch;
+    
+    if (it != density_tables_.end()) {
+        *it = table;
+    } else {
+        if (density_tables_.size() >= MAX_DENSITY_TABLES) {
+            density_tables_.erase(density_tables_.begin());
         }
-        
-        // Calculate shell volume
-        double r_inner = 6371.0 + shell.min_altitude_km;
-        double r_outer = 6371.0 + shell.max_altitude_km;
-        double volume = (4.0/3.0) * M_PI * (r_outer*r_outer*r_outer - r_inner*r_inner*r_inner);
-        
-        shell.spatial_density = shell.debris_count / volume;
-        
-        // Flux estimate (simplified)
-        // F = n * v_avg where v_avg ≈ 7.5 km/s for LEO
-        double avg_velocity = 7.5;  // km/s
-        shell.flux = shell.spatial_density * avg_velocity * 1e6 * 3.15e7;  // per m² per year
-        
-        densities.push_back(shell);
+        density_tables_.push_back(table);
     }
-    
-    return densities;
+    return table;
 }
 
 DebrisModel::DebrisRiskAssessment DebrisModel::assess_risk(
+    const SatelliteSystem& sys,
     int satellite_id,
     const Vec3& sat_position,
     double altitude_km
@@ -363,19 +585,26 @@ DebrisModel::DebrisRiskAssessment DebrisModel::assess_risk(
     DebrisRiskAssessment assessment;
     assessment.satellite_id = satellite_id;
     assessment.nearby_debris_count = 0;
+    assessment.estimated_flux = 0.0;
     
     // Find nearby debris
     std::vector<std::pair<int, double>> debris_distances;
     
-    for (const auto& obj : debris_) {
-        if (obj.position.magnitude() < 0.1) continue;  // Skip if position not set
+    for (size_t row = 0; row < debris_.count; ++row) {
+        const uint32_t i = debris_.index[row];
+        if (i >= sys.count) continue;
         
-        Vec3 diff = obj.position - sat_position;
-        double dist = diff.magnitude();
+        const double px = sys.x[i], py = sys.y[i], pz = sys.z[i];
+        if (px * px + py * py + pz * pz < 0.01) continue;  // Skip if position not set
         
-        if (dist < 100.0) {  // Within 100 km
+        const double dx = px - sat_position.x;
+        const double dy = py - sat_position.y;
+        const double dz = pz - sat_position.z;
+        const double dist_sq = dx * dx + dy * dy + dz * dz;
+        
+        if (dist_sq < config_.neighborhood_km * config_.neighborhood_km) {
             assessment.nearby_debris_count++;
-            debris_distances.push_back({obj.id, dist});
+            debris_distances.push_back({static_cast<int>(row), std::sqrt(dist_sq)});
         }
     }
     
@@ -383,45 +612,115 @@ DebrisModel::DebrisRiskAssessment DebrisModel::assess_risk(
     std::sort(debris_distances.begin(), debris_distances.end(),
               [](const auto& a, const auto& b) { return a.second < b.second; });
     
-    if (debris_distances.size() > 10) {
-        debris_distances.resize(10);
+    if (debris_distances.size() > config_.closest_count) {
+        debris_distances.resize(config_.closest_count);
     }
     assessment.closest_debris = debris_distances;
     
-    // Calculate flux at this altitude
-    auto densities = calculate_shell_densities(50.0);
-    for (const auto& shell : densities) {
-        if (altitude_km >= shell.min_altitude_km && altitude_km < shell.max_altitude_km) {
-            assessment.estimated_flux = shell.flux;
-            break;
+    // Flux at this altitude from the cached histogram
+    assessment.estimated_flux = shell_densities(sys)->shell_flux(altitude_km);
+    
+    assessment.overall_risk = classify_risk(assessment);
+    return assessment;
+}
+
+std::vector<DebrisModel::DebrisRiskAssessment> DebrisModel::assess_risk_fleet(
+    const SatelliteSystem& sys,
+    const std::vector<uint32_t>& fleet,
+    double epoch_minutes
+) const {
+    std::vector<DebrisRiskAssessment> assessments(fleet.size());
+    if (fleet.empty()) return assessments;
+    
+    auto index = position_index(sys, epoch_minutes);
+    auto densities = shell_densities(sys);
+    
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (size_t f = 0; f < fleet.size(); ++f) {
+        DebrisRiskAssessment& assessment = assessments[f];
+        const uint32_t i = fleet[f];
+        assessment.satellite_id = static_cast<int>(i);
+        assessment.nearby_debris_count = 0;
+        assessment.estimated_flux = 0.0;
+        if (i >= sys.count) {
+            assessment.overall_risk = DebrisRisk::NEGLIGIBLE;
+            continue;
         }
+        
+        // Neighbourhood query, sorted by distance; a debris fleet member skips itself
+        const Vec3 position{sys.x[i], sys.y[i], sys.z[i]};
+        const auto neighbors = index->grid.query_radius(sys, position, config_.neighborhood_km, i);
+        
+        assessment.nearby_debris_count = static_cast<int>(neighbors.size());
+        const size_t closest = std::min(neighbors.size(), config_.closest_count);
+        assessment.closest_debris.reserve(closest);
+        for (size_t k = 0; k < closest; ++k) {
+            assessment.closest_debris.push_back({index->row_of[neighbors[k].index], neighbors[k].distance_km});
+        }
+        
+        assessment.estimated_flux = densities->shell_flux(position.magnitude() - EARTH_RADIUS);
+        assessment.overall_risk = classify_risk(assessment);
+    }
+    
+    return assessments;
+}
+
+std::shared_ptr<const DebrisModel::PositionIndex> DebrisModel::position_index(
+    const SatelliteSystem& sys,
+    double epoch_minutes
+) const {
+    std::lock_guard<std::mutex> lock(index_mutex_);
+    if (position_index_ && position_index_->catalog_version == catalog_version_ &&
+        position_index_->epoch_minutes == epoch_minutes) {
+        return position_index_;
+    }
+    
+    // One neighbourhood per cell keeps radius queries to a 3x3x3 block
+    auto index = std::make_shared<PositionIndex>(config_.neighborhood_km);
+    index->catalog_version = catalog_version_;
+    index->epoch_minutes = epoch_minutes;
+    index->row_of.assign(sys.count, -1);
+    
+    std::vector<uint32_t> indexed;
+    indexed.reserve(debris_.count);
+    for (size_t row = 0; row < debris_.count; ++row) {
+        const uint32_t i = debris_.index[row];
+        if (i >= sys.count) continue;
+        if (sys.x[i] * sys.x[i] + sys.y[i] * sys.y[i] + sys.z[i] * sys.z[i] < 0.01) continue;  // Not propagated
+        index->row_of[i] = static_cast<int32_t>(row);
+        indexed.push_back(i);
     }
+    index->grid.build(sys, indexed);
     
-    // Determine overall risk
-    if (!debris_distances.empty() && debris_distances[0].second < 1.0) {
-        assessment.overall_risk = DebrisRisk::CRITICAL;
-    } else if (!debris_distances.empty() && debris_distances[0].second < 10.0) {
-        assessment.overall_risk = DebrisRisk::HIGH;
+    position_index_ = index;
+    return position_index_;
+}
+
+DebrisRisk DebrisModel::classify_risk(const DebrisRiskAssessment& assessment) {
+    const auto& closest = assessment.closest_debris;
+    if (!closest.empty() && closest[0].second < 1.0) {
+        return DebrisRisk::CRITICAL;
+    } else if (!closest.empty() && closest[0].second < 10.0) {
+        return DebrisRisk::HIGH;
     } else if (assessment.nearby_debris_count > 10) {
-        assessment.overall_risk = DebrisRisk::MEDIUM;
+        return DebrisRisk::MEDIUM;
     } else if (assessment.nearby_debris_count > 0) {
-        assessment.overall_risk = DebrisRisk::LOW;
-    } else {
-        assessment.overall_risk = DebrisRisk::NEGLIGIBLE;
+        return DebrisRisk::LOW;
     }
-    
-    return assessment;
+    return DebrisRisk::NEGLIGIBLE;
 }
 
 DebrisModel::Statistics DebrisModel::get_statistics() const {
     Statistics stats = {};
-    stats.total_debris = static_cast<int>(debris_.size());
+    stats.total_debris = static_cast<int>(debris_.count);
+    stats.predicted_reentries = static_cast<int>(predicted_reentries_);
     
     double alt_sum = 0;
     std::map<int, int> alt_histogram;  // 50km bins
     
-    for (const auto& obj : debris_) {
-        switch (obj.type) {
+    for (size_t row = 0; row < debris_.count; ++row) {
+        const double altitude_km = debris_.mean_altitude_km[row];
+        switch (debris_type(debris_.flags[row])) {
             case DebrisType::ROCKET_BODY:
                 stats.rocket_bodies++;
                 break;
@@ -435,21 +734,21 @@ DebrisModel::Statistics DebrisModel::get_statistics() const {
                 break;
         }
         
-        if (obj.altitude_km < 2000) {
+        if (altitude_km < 2000) {
             stats.leo_debris++;
-        } else if (obj.altitude_km < 35786) {
+        } else if (altitude_km < 35786) {
             stats.meo_debris++;
         } else {
             stats.geo_debris++;
         }
         
-        alt_sum += obj.altitude_km;
-        int bin = static_cast<int>(obj.altitude_km / 50);
+        alt_sum += altitude_km;
+        int bin = static_cast<int>(altitude_km / 50);
         alt_histogram[bin]++;
     }
     
-    if (!debris_.empty()) {
-        stats.average_altitude_km = alt_sum / debris_.size();
+    if (debris_.count > 0) {
+        stats.average_altitude_km = alt_sum / debris_.count;
         
         // Find max density altitude
         int max_bin = 0;
@@ -466,63 +765,5 @@ DebrisModel::Statistics DebrisModel::get_statistics() const {
     return stats;
 }
 
-DebrisVisualizationData prepare_debris_for_visualization(
-    const std::vector<DebrisObject>& debris,
-    double scale_factor
-) {
-    DebrisVisualizationData data;
-    data.positions.reserve(debris.size() * 3);
-    data.colors.reserve(debris.size() * 3);
-    data.sizes.reserve(debris.size());
-    data.ids.reserve(debris.size());
-    
-    for (const auto& obj : debris) {
-        // Position
-        data.positions.push_back(static_cast<float>(obj.position.x * scale_factor));
-        data.positions.push_back(static_cast<float>(obj.position.y * scale_factor));
-        data.positions.push_back(static_cast<float>(obj.position.z * scale_factor));
-        
-        // Color based on type
-        const float* color;
-        switch (obj.type) {
-            case DebrisType::ROCKET_BODY:
-                color = DebrisColors::ROCKET_BODY;
-                break;
-            case DebrisType::PAYLOAD_DEBRIS:
-                color = DebrisColors::PAYLOAD_DEBRIS;
-                break;
-            case DebrisType::FRAGMENTATION:
-                color = DebrisColors::FRAGMENTATION;
-                break;
-            case DebrisType::MISSION_DEBRIS:
-                color = DebrisColors::MISSION_DEBRIS;
-                break;
-            default:
-                color = DebrisColors::UNKNOWN;
-        }
-        data.colors.push_back(color[0]);
-        data.colors.push_back(color[1]);
-        data.colors.push_back(color[2]);
-        
-        // Size based on debris size
-        float size;
-        switch (obj.size) {
-            case DebrisSize::LARGE:
-                size = 3.0f;
-                break;
-            case DebrisSize::MEDIUM:
-                size = 2.0f;
-                break;
-            default:
-                size = 1.0f;
-        }
-        data.sizes.push_back(size);
-        
-        data.ids.push_back(obj.id);
-    }
-    
-    return data;
-}
-
 } // namespace orbitops
 
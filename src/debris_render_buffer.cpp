@@ -0,0 +1,98 @@
+#include "debris_render_buffer.hpp"
+#include "sgp4_optimized.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace orbitops {
+
+namespace {
+    const float* type_color(DebrisType type) {
+        switch (type) {
+            case DebrisType::ROCKET_BODY:    return DebrisColors::ROCKET_BODY;
+            case DebrisType::PAYLOAD_DEBRIS: return DebrisColors::PAYLOAD_DEBRIS;
+            case DebrisType::FRAGMENTATION:  return DebrisColors::FRAGMENTATION;
+            case DebrisType::MISSION_DEBRIS: return DebrisColors::MISSION_DEBRIS;
+            default:                         return DebrisColors::UNKNOWN;
+        }
+    }
+
+    float point_size(DebrisSize size) {
+        switch (size) {
+            case DebrisSize::LARGE:  return 3.0f;
+            case DebrisSize::MEDIUM: return 2.0f;
+            default:                 return 1.0f;
+        }
+    }
+}
+
+void DebrisRenderBuffer::build(const DebrisSystem& debris, uint64_t catalog_version, double scale_factor) {
+    ORBITOPS_TRACE_SCOPE_ARG("debris_render.build", debris.count);
+    const size_t n = debris.count;
+    catalog_version_ = catalog_version;
+    scale_factor_ = scale_factor;
+    positions_valid_ = false;
+    epoch_minutes_ = 0.0;
+
+    index_ = debris.index;
+    ids_.resize(n);
+    positions_.assign(3 * n, 0.0f);
+    colors_.resize(3 * n);
+    sizes_.resize(n);
+
+    #pragma omp parallel for schedule(static)
+    for (size_t row = 0; row < n; ++row) {
+        const uint32_t flags = debris.flags[row];
+        const float* color = type_color(debris_type(flags));
+        ids_[row] = static_cast<int32_t>(row);
+        colors_[3 * row] = color[0];
+        colors_[3 * row + 1] = color[1];
+        colors_[3 * row + 2] = color[2];
+        sizes_[row] = point_size(debris_size(flags));
+    }
+
+    max_altitude_km_ = n > 0 ? *std::max_element(debris.mean_altitude_km.begin(), debris.mean_altitude_km.end()) : 0.0;
+}
+
+bool DebrisRenderBuffer::update_positions(const SatelliteSystem& sys, double time_minutes,
+                                          const CancellationToken* cancel) {
+    if (positions_valid_ && epoch_minutes_ == time_minutes) return true;
+
+    positions_valid_ = propagate_positions_f32(sys, index_.data(), index_.size(), time_minutes,
+                                               scale_factor_, positions_.data(), cancel);
+    epoch_minutes_ = time_minutes;
+    return positions_valid_;
+}
+
+void DebrisRenderBuffer::gather(const std::vector<uint32_t>& rows, int32_t* ids, float* positions,
+                                float* colors, float* sizes) const {
+    const size_t n = rows.size();
+
+    // Every row in order: the arrays are already laid out for the client
+    if (n == count()) {
+        if (ids) std::memcpy(ids, ids_.data(), n * sizeof(int32_t));
+        if (positions) std::memcpy(positions, positions_.data(), 3 * n * sizeof(float));
+        if (colors) std::memcpy(colors, colors_.data(), 3 * n * sizeof(float));
+        if (sizes) std::memcpy(sizes, sizes_.data(), n * sizeof(float));
+        return;
+    }
+
+    #pragma omp parallel for simd schedule(static)
+    for (size_t k = 0; k < n; ++k) {
+        const uint32_t row = rows[k];
+        if (ids) ids[k] = ids_[row];
+        if (positions) {
+            positions[3 * k] = positions_[3 * row];
+            positions[3 * k + 1] = positions_[3 * row + 1];
+            positions[3 * k + 2] = positions_[3 * row + 2];
+        }
+        if (colors) {
+            colors[3 * k] = colors_[3 * row];
+            colors[3 * k + 1] = colors_[3 * row + 1];
+            colors[3 * k + 2] = colors_[3 * row + 2];
+        }
+        if (sizes) sizes[k] = sizes_[row];
+    }
+}
+
+} // namespace orbitops
@@ -0,0 +1,126 @@
+#include "debris_system.hpp"
+#include <bit>
+
+namespace orbitops {
+
+namespace {
+    constexpr double HEO_ECCENTRICITY = 0.25;
+
+    // Position of the single set bit of a flag group
+    inline uint32_t group_value(uint32_t flags, uint32_t mask, uint32_t shift) {
+        const uint32_t group = (flags & mask) >> shift;
+        return group ? static_cast<uint32_t>(std::countr_zero(group)) : 0u;
+    }
+
+    // Compact a byte mask into ascending indices
+    std::vector<uint32_t> compact(const std::vector<uint8_t>& mask) {
+        size_t selected = 0;
+        for (uint8_t m : mask) {
+            selected += m;
+        }
+
+        std::vector<uint32_t> rows;
+        rows.reserve(selected);
+        for (size_t i = 0; i < mask.size(); ++i) {
+            if (mask[i]) rows.push_back(static_cast<uint32_t>(i));
+        }
+        return rows;
+    }
+}
+
+DebrisType debris_type(uint32_t flags) {
+    return static_cast<DebrisType>(group_value(flags, DEBRIS_TYPE_MASK, DEBRIS_TYPE_SHIFT));
+}
+
+DebrisSize debris_size(uint32_t flags) {
+    return static_cast<DebrisSize>(group_value(flags, DEBRIS_SIZE_MASK, DEBRIS_SIZE_SHIFT));
+}
+
+DebrisRisk debris_risk(uint32_t flags) {
+    return static_cast<DebrisRisk>(group_value(flags, DEBRIS_RISK_MASK, DEBRIS_RISK_SHIFT));
+}
+
+OrbitRegime orbit_regime(uint32_t flags) {
+    return static_cast<OrbitRegime>(group_value(flags, DEBRIS_REGIME_MASK, DEBRIS_REGIME_SHIFT));
+}
+
+OrbitRegime classify_orbit_regime(double mean_altitude_km, double eccentricity) {
+    if (eccentricity > HEO_ECCENTRICITY) return OrbitRegime::HEO;
+    if (mean_altitude_km < 2000.0) return OrbitRegime::LEO;
+    if (mean_altitude_km < 35586.0) return OrbitRegime::MEO;
+    return OrbitRegime::GEO;
+}
+
+void DebrisSystem::clear() {
+    count = 0;
+    index.clear();
+    flags.clear();
+    mean_altitude_km.clear();
+    perigee_km.clear();
+    apogee_km.clear();
+    rcs_m2.clear();
+    mass_kg.clear();
+    decay_days.clear();
+    launch.clear();
+    designator.clear();
+    epoch_jd.clear();
+}
+
+void DebrisSystem::reserve(size_t n) {
+    index.reserve(n);
+    flags.reserve(n);
+    mean_altitude_km.reserve(n);
+    perigee_km.reserve(n);
+    apogee_km.reserve(n);
+    rcs_m2.reserve(n);
+    mass_kg.reserve(n);
+    decay_days.reserve(n);
+    launch.reserve(n);
+    designator.reserve(n);
+    epoch_jd.reserve(n);
+}
+
+std::vector<uint32_t> select_debris(const DebrisSystem& debris, uint32_t mask) {
+    const size_t n = debris.count;
+    const uint32_t* __restrict flags = debris.flags.data();
+
+    // A group without requested bits accepts any value
+    const uint32_t type = (mask & DEBRIS_TYPE_MASK) ? (mask & DEBRIS_TYPE_MASK) : DEBRIS_TYPE_MASK;
+    const uint32_t size = (mask & DEBRIS_SIZE_MASK) ? (mask & DEBRIS_SIZE_MASK) : DEBRIS_SIZE_MASK;
+    const uint32_t risk = (mask & DEBRIS_RISK_MASK) ? (mask & DEBRIS_RISK_MASK) : DEBRIS_RISK_MASK;
+    const uint32_t regime = (mask & DEBRIS_REGIME_MASK) ? (mask & DEBRIS_REGIME_MASK) : DEBRIS_REGIME_MASK;
+
+    std::vector<uint8_t> keep(n);
+    uint8_t* __restrict out = keep.data();
+
+    #pragma omp parallel for simd schedule(static)
+    for (size_t i = 0; i < n; ++i) {
+        const uint32_t f = flags[i];
+        out[i] = static_cast<uint8_t>(
+            ((f & type) != 0) & ((f & size) != 0) & ((f & risk) != 0) & ((f & regime) != 0)
+        );
+    }
+
+    return compact(keep);
+}
+
+std::vector<uint32_t> select_debris_in_shell(
+    const DebrisSystem& debris,
+    double min_alt_km,
+    double max_alt_km
+) {
+    const size_t n = debris.count;
+    const double* __restrict alt = debris.mean_altitude_km.data();
+
+    std::vector<uint8_t> keep(n);
+    uint8_t* __restrict out = keep.data();
+
+    #pragma omp parallel for simd schedule(static)
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = static_cast<uint8_t>((alt[i] >= min_alt_km) & (alt[i] <= max_alt_km));
+    }
+
+    return compact(keep);
+}
+
+} // namespace orbitops
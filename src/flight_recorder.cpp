@@ -0,0 +1,231 @@
+#include "flight_recorder.hpp"
+#include "trace.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+namespace orbitops {
+
+namespace {
+    void append_json_string(std::string& out, const std::string& value) {
+        out += '"';
+        for (char c : value) {
+            switch (c) {
+                case '"':  out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char buf[8];
+                        std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                        out += buf;
+                    } else {
+                        out += c;
+                    }
+            }
+        }
+        out += '"';
+    }
+
+    void append_double(std::string& out, double value) {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.6g", value);
+        out += buf;
+    }
+
+    double unix_seconds(std::chrono::system_clock::time_point t) {
+        return std::chrono::duration<double>(t.time_since_epoch()).count();
+    }
+
+    // Summary fields shared by the slow request and its neighbours
+    void append_record(std::string& out, const RequestRecord& record) {
+        out += "{\"id\":" + std::to_string(record.id);
+        out += ",\"method\":";
+        append_json_string(out, record.method);
+        out += ",\"catalog_version\":" + std::to_string(record.catalog_version);
+        out += ",\"start_unix\":";
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.3f", unix_seconds(record.wall_start));
+        out += buf;
+        out += ",\"duration_ms\":";
+        append_double(out, record.duration_ms);
+
+        out += ",\"stages_ms\":{";
+        for (size_t s = 0; s < STAGE_COUNT; ++s) {
+            if (s > 0) out += ',';
+            out += '"';
+            out += stage_name(static_cast<Stage>(s));
+            out += "\":";
+            append_double(out, record.timings.seconds(static_cast<Stage>(s)) * 1e3);
+        }
+        out += "},\"counters\":{";
+        for (size_t c = 0; c < STAGE_COUNTER_COUNT; ++c) {
+            if (c > 0) out += ',';
+            out += '"';
+            out += stage_counter_name(static_cast<StageCounter>(c));
+            out += "\":" + std::to_string(record.timings.counters[c]);
+        }
+        out += '}';
+    }
+}
+
+FlightRecorder::FlightRecorder(const FlightRecorderConfig& config)
+    : config_(config)
+    , writer_([this] { writer_loop(); })
+{}
+
+FlightRecorder::~FlightRecorder() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    pending_cv_.notify_all();
+    if (writer_.joinable()) writer_.join();
+}
+
+FlightRecorder::Request::Request(FlightRecorder& recorder, const char* method,
+                                 uint64_t catalog_version, Describe describe)
+    : recorder_(recorder), describe_(std::move(describe)) {
+    record_.method = method;
+    record_.catalog_version = catalog_version;
+    record_.wall_start = std::chrono::system_clock::now();
+    record_.start_cycles = cycle_count();
+}
+
+FlightRecorder::Request::~Request() {
+    finish();
+}
+
+void FlightRecorder::Request::finish() {
+    if (finished_) return;
+    finished_ = true;
+    recorder_.finish(std::move(record_), describe_);
+}
+
+double FlightRecorder::slo_ms(const std::string& method) const {
+    if (config_.method_slo_ms.empty()) return config_.default_slo_ms;
+    auto it = config_.method_slo_ms.find(method);
+    return it != config_.method_slo_ms.end() ? it->second : config_.default_slo_ms;
+}
+
+void FlightRecorder::finish(RequestRecord&& record, const Describe& describe) {
+    record.duration_ms = cycles_to_seconds(cycle_count() - record.start_cycles) * 1e3;
+    const double slo = slo_ms(record.method);
+    record.slow = record.duration_ms > slo;
+
+    // Only slow requests pay for describing their parameters
+    if (record.slow && describe) {
+        record.params = describe();
+        if (record.params.size() > config_.max_param_bytes) {
+            record.params.resize(config_.max_param_bytes);
+        }
+    }
+
+    bool queued = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        record.id = next_id_++;
+        stats_.requests++;
+
+        if (record.slow) {
+            stats_.slow_requests++;
+            const auto now = std::chrono::steady_clock::now();
+            const bool rate_ok = last_dump_ == std::chrono::steady_clock::time_point{} ||
+                std::chrono::duration<double>(now - last_dump_).count() >= config_.min_dump_interval_seconds;
+            // The slot is reserved when the dump is claimed, so the dump
+            // being written counts against the budget too
+            const bool budget_ok = stats_.dumps_written + in_flight_ < config_.max_dumps;
+
+            if (rate_ok && budget_ok) {
+                pending_.push_back({record, std::vector<RequestRecord>(recent_.begin(), recent_.end()), slo});
+                last_dump_ = now;
+                in_flight_++;
+                queued = true;
+            } else {
+                stats_.dumps_suppressed++;
+            }
+        }
+
+        recent_.push_back(std::move(record));
+        while (recent_.size() > config_.capacity) recent_.pop_front();
+    }
+    if (queued) pending_cv_.notify_one();
+}
+
+std::vector<RequestRecord> FlightRecorder::recent() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::vector<RequestRecord>(recent_.begin(), recent_.end());
+}
+
+void FlightRecorder::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_cv_.wait(lock, [this] { return in_flight_ == 0; });
+}
+
+FlightRecorder::Stats FlightRecorder::get_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void FlightRecorder::writer_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        pending_cv_.wait(lock, [this] { return stop_ || !pending_.empty(); });
+        if (pending_.empty()) break;   // Stopping with nothing left
+
+        Dump dump = std::move(pending_.front());
+        pending_.pop_front();
+
+        lock.unlock();
+        bool written = write_dump(dump);
+        lock.lock();
+
+        in_flight_--;
+        if (written) {
+            stats_.dumps_written++;
+        } else {
+            stats_.dumps_suppressed++;
+        }
+        idle_cv_.notify_all();
+    }
+    idle_cv_.notify_all();
+}
+
+bool FlightRecorder::write_dump(const Dump& dump) const {
+    const RequestRecord& request = dump.request;
+
+    std::string out;
+    append_record(out, request);
+    out += ",\"slo_ms\":";
+    append_double(out, dump.slo_ms);
+    out += ",\"params\":";
+    append_json_string(out, request.params);
+
+    out += ",\"recent\":[";
+    for (size_t i = 0; i < dump.recent.size(); ++i) {
+        if (i > 0) out += ',';
+        append_record(out, dump.recent[i]);
+        out += '}';
+    }
+
+    // Spans from every thread since the request started (no pipeline spans
+    // unless built with ORBITOPS_TRACING)
+    out += "],\"trace\":";
+    out += trace::chrome_json(request.start_cycles);
+    out += "}\n";
+
+    std::error_code ec;
+    std::filesystem::create_directories(config_.dump_directory, ec);
+
+    const auto unix_ms = static_cast<long long>(unix_seconds(request.wall_start) * 1000.0);
+    const std::string path = config_.dump_directory + "/slow-" + std::to_string(unix_ms) + "-" +
+                             request.method + "-" + std::to_string(request.id) + ".json";
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+    file << out;
+    return static_cast<bool>(file);
+}
+
+} // namespace orbitops
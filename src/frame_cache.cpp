@@ -0,0 +1,98 @@
+#include "frame_cache.hpp"
+
+namespace orbitops {
+
+FrameCache::FrameCache(size_t max_bytes) : max_bytes_(max_bytes) {}
+
+FrameCache::Frame FrameCache::get(const FrameKey& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        stats_.misses++;
+        return nullptr;
+    }
+
+    // Move to front (most recently used)
+    lru_.splice(lru_.begin(), lru_, it->second);
+    stats_.hits++;
+    return it->second->frame;
+}
+
+void FrameCache::put(const FrameKey& key, std::string payload) {
+    size_t bytes = entry_bytes(payload);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // A single frame larger than the whole budget is never cached
+    if (bytes > max_bytes_) return;
+
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        bytes_ -= it->second->bytes;
+        lru_.erase(it->second);
+        index_.erase(it);
+    }
+
+    lru_.push_front({key, std::make_shared<const std::string>(std::move(payload)), bytes});
+    index_[key] = lru_.begin();
+    bytes_ += bytes;
+    stats_.insertions++;
+
+    evict_to_budget();
+}
+
+void FrameCache::invalidate_before(uint64_t catalog_version) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (auto it = lru_.begin(); it != lru_.end();) {
+        if (it->key.catalog_version < catalog_version) {
+            bytes_ -= it->bytes;
+            index_.erase(it->key);
+            it = lru_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void FrameCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    index_.clear();
+    bytes_ = 0;
+}
+
+void FrameCache::set_max_bytes(size_t max_bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_bytes_ = max_bytes;
+    evict_to_budget();
+}
+
+size_t FrameCache::max_bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return max_bytes_;
+}
+
+FrameCache::Stats FrameCache::get_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Stats stats = stats_;
+    stats.entries = lru_.size();
+    stats.bytes = bytes_;
+    stats.max_bytes = max_bytes_;
+    return stats;
+}
+
+void FrameCache::evict_to_budget() {
+    // Remove least recently used frames until within budget
+    while (bytes_ > max_bytes_ && !lru_.empty()) {
+        const Entry& victim = lru_.back();
+        bytes_ -= victim.bytes;
+        index_.erase(victim.key);
+        lru_.pop_back();
+        stats_.evictions++;
+    }
+}
+
+} // namespace orbitops
@@ -9,6 +9,18 @@
 #include "history_recorder.hpp"
 #include "tle_updater.hpp"
 #include "debris_model.hpp"
+#include "frame_cache.hpp"
+#include "object_filter.hpp"
+#include "paced_writer.hpp"
+#include "cancellation.hpp"
+#include "orbit_path.hpp"
+#include "conjunction_monitor.hpp"
+#include "screening_horizon.hpp"
+#include "stage_metrics.hpp"
+#include "metrics_endpoint.hpp"
+#include "trace.hpp"
+#include "flight_recorder.hpp"
+#include "reentry_predictor.hpp"
 
 #include <grpcpp/grpcpp.h>
 #include "orbit_ops.grpc.pb.h"
@@ -18,19 +30,36 @@
 #include <iostream>
 #include <mutex>
 #include <ctime>
+#include <map>
+#include <limits>
+#include <algorithm>
+#include <condition_variable>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace orbitops {
 
+// Look-ahead slices screened between alert publishes while filling the window
+constexpr size_t MONITOR_SLICES_PER_PUBLISH = 120;
+
 // Service implementation
 class OrbitOpsServiceImpl final : public OrbitOps::Service {
 public:
-    OrbitOpsServiceImpl(const std::string& tle_file) {
+    OrbitOpsServiceImpl(const std::string& tle_file, const ServerConfig& config)
+        : frame_cache_(config.frame_cache_bytes)
+        , flight_recorder_(make_flight_recorder_config(config))
+        , monitor_table_(make_monitor_config(config))
+        , monitor_config_(make_monitor_config(config))
+        , monitor_interval_(std::chrono::duration<double>(config.monitor_interval_seconds))
+        , stream_window_(config.stream_window)
+    {
         // Load TLEs
         tles_ = parse_tle_file(tle_file);
         std::cout << "[OrbitOps] Loaded " << tles_.size() << " satellites\n";
 
         // Create optimized satellite system
         system_ = create_satellite_system(tles_);
+        orbit_bands_.build(system_);
         std::cout << "[OrbitOps] Initialized satellite system\n";
 
         // Initialize Phase 6 modules
@@ -46,10 +75,13 @@ public:
         tle_updater_->add_source(celestrak::ACTIVE);
         tle_updater_->add_source(celestrak::DEBRIS);
 
-        // Load debris from TLEs
-        debris_model_->load_from_tles(tles_);
+        // Classify debris once over the SoA. A replayed catalog may be old,
+        // so startup only predicts and never tombstones.
+        debris_model_->load(tles_, system_);
+        refresh_reentries(false, nullptr);
         auto debris_stats = debris_model_->get_statistics();
-        std::cout << "[OrbitOps] Identified " << debris_stats.total_debris << " debris objects\n";
+        std::cout << "[OrbitOps] Identified " << debris_stats.total_debris << " debris objects ("
+                  << debris_stats.predicted_reentries << " with predicted reentry)\n";
 
         // Start history recording
         history_recorder_->start();
@@ -61,7 +93,33 @@ public:
         const CatalogRequest* request,
         CatalogResponse* response
     ) override {
-        for (size_t i = 0; i < tles_.size(); ++i) {
+        ORBITOPS_TRACE_SCOPE("rpc.GetCatalog");
+
+        // Version token: a client holding the current catalog gets an empty reply
+        const uint64_t version = catalog_version_;
+        if (request->if_none_match() != 0 && request->if_none_match() == version) {
+            response->set_catalog_version(version);
+            response->set_not_modified(true);
+            return grpc::Status::OK;
+        }
+
+        // Encoded pages are cached per catalog version and invalidated on update
+        FrameKey key = catalog_page_key(version, request->page_offset(), request->page_size());
+        if (auto frame = frame_cache_.get(key)) {
+            response->ParseFromString(*frame);
+            return grpc::Status::OK;
+        }
+
+        std::lock_guard<std::mutex> lock(system_mutex_);
+        key.catalog_version = catalog_version_;
+
+        const int64_t total = static_cast<int64_t>(tles_.size());
+        const CatalogPage page = catalog_page(total, request->page_offset(), request->page_size());
+        const int begin = static_cast<int>(page.begin);
+        const int end = static_cast<int>(page.end);
+
+        response->mutable_satellites()->Reserve(end - begin);
+        for (int i = begin; i < end; ++i) {
             auto* sat = response->add_satellites();
             sat->set_id(static_cast<int32_t>(i));
             sat->set_name(tles_[i].name);
@@ -71,7 +129,11 @@ public:
             sat->set_mean_motion(tles_[i].mean_motion * 1440.0 / (2.0 * M_PI)); // rad/min to rev/day
             sat->set_epoch(tles_[i].epoch_jd);
         }
-        response->set_total_count(static_cast<int32_t>(tles_.size()));
+        response->set_total_count(static_cast<int32_t>(total));
+        response->set_catalog_version(key.catalog_version);
+        response->set_next_page_offset(static_cast<int32_t>(page.next_offset));
+
+        frame_cache_.put(key, response->SerializeAsString());
         return grpc::Status::OK;
     }
 
@@ -80,44 +142,92 @@ public:
         const TimeRange* request,
         grpc::ServerWriter<PositionBatch>* writer
     ) override {
+        ORBITOPS_TRACE_SCOPE("rpc.StreamPositions");
+
         double start = request->start_time();
         double end = request->end_time();
         double step = request->step_seconds();
         
         if (step <= 0) step = 60.0;  // Default 1 minute
         
-        std::lock_guard<std::mutex> lock(system_mutex_);
+        // Request-level ROI filter; filtered frames are cached per filter
+        ObjectFilter filter = to_object_filter(request->filter());
+        const bool filtered = !filter.is_pass_through();
+        uint64_t encoding = frame_encoding(FrameEncoding::POSITION_BATCH);
+        if (filtered) encoding ^= filter.hash();
+        std::vector<uint32_t> indices;
         
-        for (double t = start; t <= end && !context->IsCancelled(); t += step) {
-            // Propagate all satellites
-            propagate_all_optimized(system_, t / 60.0);  // Convert seconds to minutes
-            
-            PositionBatch batch;
-            batch.set_timestamp(t);
+        // Network writes run on the pacer's thread, outside system_mutex_.
+        // Recycled frames keep cleared submessages and name strings.
+        PacedWriter<PositionBatch> pacer(
+            [writer](const PositionBatch& batch) { return writer->Write(batch); },
+            stream_window_);
+        StreamRegistration registration(*this, "StreamPositions", context->peer(),
+            [&pacer] { return pacer.get_stats(); });
+
+        CancellationToken cancel;
+        bind_to_context(cancel, context);
+        
+        for (double t = start; t <= end && !cancel.is_cancelled(); t += step) {
+            auto batch = pacer.acquire();
+            batch->Clear();
             
-            for (size_t i = 0; i < system_.count; ++i) {
-                auto* pos = batch.add_positions();
-                pos->set_id(static_cast<int32_t>(i));
-                pos->set_name(tles_[i].name);
+            // Serve repeated views of the same window from the frame cache
+            FrameKey key{catalog_version_, t, encoding};
+            if (auto frame = frame_cache_.get(key)) {
+                batch->ParseFromString(*frame);
+            } else {
+                // Hold the catalog only while propagating and encoding this step
+                std::lock_guard<std::mutex> lock(system_mutex_);
+                key.catalog_version = catalog_version_;
+                
+                // Propagate all satellites
+                propagate_all_optimized(system_, t / 60.0, &cancel);  // Convert seconds to minutes
+                if (cancel.is_cancelled()) break;  // Partially propagated; never cache
+                debris_model_->update_field_statistics(system_, t / 60.0);
                 
-                auto* position = pos->mutable_position();
-                position->set_x(system_.x[i]);
-                position->set_y(system_.y[i]);
-                position->set_z(system_.z[i]);
+                batch->set_timestamp(t);
                 
-                auto* velocity = pos->mutable_velocity();
-                velocity->set_x(system_.vx[i]);
-                velocity->set_y(system_.vy[i]);
-                velocity->set_z(system_.vz[i]);
+                // Evaluate the filter over the SoA; only matching objects get encoded
+                if (filtered) {
+                    indices = select_filtered(system_, filter, gmst_from_unix(t), &orbit_bands_);
+                } else {
+                    indices.resize(system_.count);
+                    for (size_t i = 0; i < system_.count; ++i) indices[i] = static_cast<uint32_t>(i);
+                }
+                batch->mutable_positions()->Reserve(static_cast<int>(indices.size()));
+                
+                for (uint32_t i : indices) {
+                    auto* pos = batch->add_positions();
+                    pos->set_id(static_cast<int32_t>(i));
+                    pos->set_name(tles_[i].name);
+                    
+                    auto* position = pos->mutable_position();
+                    position->set_x(system_.x[i]);
+                    position->set_y(system_.y[i]);
+                    position->set_z(system_.z[i]);
+                    
+                    auto* velocity = pos->mutable_velocity();
+                    velocity->set_x(system_.vx[i]);
+                    velocity->set_y(system_.vy[i]);
+                    velocity->set_z(system_.vz[i]);
+                    
+                    pos->set_timestamp(t);
+                }
                 
-                pos->set_timestamp(t);
+                frame_cache_.put(key, batch->SerializeAsString());
             }
             
-            if (!writer->Write(batch)) {
+            // Intermediate position frames may be skipped for a slow client
+            if (!pacer.push(std::move(batch), true)) {
                 break;  // Client disconnected
             }
         }
         
+        pacer.close();
+        if (cancel.is_cancelled()) {
+            return grpc::Status(grpc::StatusCode::CANCELLED, "Stream cancelled or deadline exceeded");
+        }
         return grpc::Status::OK;
     }
 
@@ -126,6 +236,8 @@ public:
         const ScreeningParams* request,
         grpc::ServerWriter<ConjunctionBatch>* writer
     ) override {
+        ORBITOPS_TRACE_SCOPE("rpc.StreamConjunctions");
+
         double threshold = request->threshold_km();
         if (threshold <= 0) threshold = 10.0;  // Default 10km
 
@@ -135,33 +247,110 @@ public:
 
         if (step <= 0) step = 60.0;  // Default 1 minute
 
-        std::lock_guard<std::mutex> lock(system_mutex_);
+        const uint64_t encoding = frame_encoding(FrameEncoding::CONJUNCTION_BATCH, threshold);
         SpatialGrid grid(threshold * 2);  // Cell size = 2x threshold
 
-        for (double t = start; t <= end && !context->IsCancelled(); t += step) {
-            // Propagate
-            double time_minutes = t / 60.0;
-            propagate_all_optimized(system_, time_minutes);
+        // Conjunction frames are never skipped: a slow client throttles this
+        // stream only, since the write happens outside system_mutex_
+        PacedWriter<ConjunctionBatch> pacer(
+            [writer](const ConjunctionBatch& batch) { return writer->Write(batch); },
+            stream_window_);
+        StreamRegistration registration(*this, "StreamConjunctions", context->peer(),
+            [&pacer] { return pacer.get_stats(); });
+
+        CancellationToken cancel;
+        bind_to_context(cancel, context);
+
+        const bool attach_diagnostics = request->include_diagnostics();
+
+        for (double t = start; t <= end && !cancel.is_cancelled(); t += step) {
+            ORBITOPS_TRACE_SCOPE("rpc.StreamConjunctions.step");
+            FlightRecorder::Request flight(flight_recorder_, "StreamConjunctions.step", catalog_version_,
+                [request, t] { return request->ShortDebugString() + " step_time: " + std::to_string(t); });
+            StageTimings& timings = flight.timings();
+
+            auto batch = pacer.acquire();
+            batch->Clear();
+
+            // Steps already screened against this catalog skip screening and
+            // Monte Carlo (an empty frame means no conjunctions). History is
+            // still recorded, so it does not depend on what the cache holds.
+            FrameKey key{catalog_version_, t, encoding};
+            if (auto frame = frame_cache_.get(key)) {
+                if (history_recorder_->is_recording()) {
+                    std::lock_guard<std::mutex> lock(system_mutex_);
+                    propagate_all_optimized(system_, t / 60.0, &cancel);
+                    if (cancel.is_cancelled()) break;
+                    debris_model_->update_field_statistics(system_, t / 60.0);
+                    history_recorder_->record_snapshot(system_, tles_, t / 60.0);
+                }
+                if (frame->empty()) continue;
+
+                {
+                    ScopedStageTimer timer(timings, Stage::SERIALIZE);
+                    batch->ParseFromString(*frame);
+                }
+                record_conjunctions(*batch, t / 60.0);
+                timings.add(StageCounter::BYTES_WRITTEN, frame->size());
+                finish_step(*batch, timings, true, attach_diagnostics);
+                flight.finish();   // Client backpressure is not step latency
+                if (!pacer.push(std::move(batch), false)) {
+                    break;
+                }
+                continue;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(system_mutex_);
+                key.catalog_version = catalog_version_;
+
+                // Propagate
+                double time_minutes = t / 60.0;
+                {
+                    ScopedStageTimer timer(timings, Stage::PROPAGATE);
+                    propagate_all_optimized(system_, time_minutes, &cancel);
+                }
+                if (cancel.is_cancelled()) break;
+                debris_model_->update_field_statistics(system_, time_minutes);
 
-            // Record snapshot to history
-            history_recorder_->record_snapshot(system_, tles_, time_minutes);
+                // Record snapshot to history
+                history_recorder_->record_snapshot(system_, tles_, time_minutes);
 
-            // Build spatial grid and detect conjunctions
-            grid.build(system_);
-            auto conjunctions = grid.find_conjunctions(system_, threshold, time_minutes);
+                // Build spatial grid and detect conjunctions
+                {
+                    ScopedStageTimer timer(timings, Stage::GRID_BUILD);
+                    grid.build(system_);
+                }
+                auto conjunctions = [&] {
+                    ScopedStageTimer timer(timings, Stage::PAIR_TEST);
+                    return grid.find_conjunctions(system_, threshold, time_minutes, &cancel);
+                }();
+                if (cancel.is_cancelled()) break;  // Partial screening; never cache
+
+                timings.add(StageCounter::CANDIDATES_TESTED, grid.candidates_tested());
+                timings.add(StageCounter::HITS, conjunctions.size());
+
+                if (conjunctions.empty()) {
+                    frame_cache_.put(key, std::string());
+                    finish_step(*batch, timings, false, false);
+                    continue;
+                }
 
-            if (!conjunctions.empty()) {
-                ConjunctionBatch batch;
-                batch.set_timestamp(t);
-                batch.set_total_screened(static_cast<int32_t>(system_.count));
+                batch->set_timestamp(t);
+                batch->set_total_screened(static_cast<int32_t>(system_.count));
 
                 // Use full Monte Carlo probability calculation
-                auto prob_results = probability_calculator_->calculate_all(system_, conjunctions, tles_);
+                auto prob_results = [&] {
+                    ScopedStageTimer timer(timings, Stage::MONTE_CARLO);
+                    return probability_calculator_->calculate_all(system_, conjunctions, tles_, &cancel);
+                }();
+                if (cancel.is_cancelled()) break;
+                batch->mutable_conjunctions()->Reserve(static_cast<int>(prob_results.size()));
 
                 for (size_t i = 0; i < prob_results.size(); ++i) {
                     const auto& prob = prob_results[i];
-
-                    auto* warning = batch.add_conjunctions();
+                    timings.add(StageCounter::PC_SAMPLES, static_cast<uint64_t>(prob.samples_taken));
+                    auto* warning = batch->add_conjunctions();
                     warning->set_sat1_id(prob.sat1_id);
                     warning->set_sat1_name(prob.sat1_name);
                     warning->set_sat2_id(prob.sat2_id);
@@ -178,27 +367,30 @@ public:
                     warning->set_mean_miss_distance(prob.mean_miss_distance);
                     warning->set_std_miss_distance(prob.std_miss_distance);
                     warning->set_combined_radius(prob.combined_radius);
-
-                    // Record conjunction event to history
-                    ConjunctionEvent event;
-                    event.time_minutes = time_minutes;
-                    event.wall_time = std::chrono::system_clock::now();
-                    event.sat1_id = prob.sat1_id;
-                    event.sat2_id = prob.sat2_id;
-                    event.sat1_name = prob.sat1_name;
-                    event.sat2_name = prob.sat2_name;
-                    event.miss_distance = prob.miss_distance;
-                    event.relative_velocity = prob.relative_velocity;
-                    event.collision_probability = prob.collision_probability;
-                    history_recorder_->record_conjunction(event);
                 }
+                record_conjunctions(*batch, time_minutes);
 
-                if (!writer->Write(batch)) {
-                    break;
+                std::string frame;
+                {
+                    ORBITOPS_TRACE_SCOPE("serialize");
+                    ScopedStageTimer timer(timings, Stage::SERIALIZE);
+                    frame = batch->SerializeAsString();
                 }
+                timings.add(StageCounter::BYTES_WRITTEN, frame.size());
+                frame_cache_.put(key, std::move(frame));
+            }
+
+            finish_step(*batch, timings, false, attach_diagnostics);
+            flight.finish();
+            if (!pacer.push(std::move(batch), false)) {
+                break;
             }
         }
 
+        pacer.close();
+        if (cancel.is_cancelled()) {
+            return grpc::Status(grpc::StatusCode::CANCELLED, "Stream cancelled or deadline exceeded");
+        }
         return grpc::Status::OK;
     }
 
@@ -207,6 +399,10 @@ public:
         const ManeuverRequest* request,
         ManeuverResponse* response
     ) override {
+        ORBITOPS_TRACE_SCOPE("rpc.SimulateManeuver");
+        FlightRecorder::Request flight(flight_recorder_, "SimulateManeuver", catalog_version_,
+                                       [request] { return request->ShortDebugString(); });
+
         int sat_id = request->satellite_id();
 
         if (sat_id < 0 || sat_id >= static_cast<int>(tles_.size())) {
@@ -243,11 +439,14 @@ public:
             }
         }
 
+        CancellationToken cancel;
+        bind_to_context(cancel, context);
+
         // Create a separate system for simulation
         SatelliteSystem sim_system = create_satellite_system(tles_);
 
         // Propagate to burn time
-        propagate_all_optimized(sim_system, burn_time / 60.0);
+        propagate_all_optimized(sim_system, burn_time / 60.0, &cancel);
 
         // Apply delta-v
         sim_system.vx[sat_id] += dvx;
@@ -267,7 +466,10 @@ public:
         double min_miss_distance = std::numeric_limits<double>::max();
 
         for (double t = burn_time; t <= burn_time + orbital_period_sec; t += step) {
-            propagate_all_optimized(sim_system, t / 60.0);
+            propagate_all_optimized(sim_system, t / 60.0, &cancel);
+            if (cancel.is_cancelled()) {
+                return grpc::Status(grpc::StatusCode::CANCELLED, "Maneuver simulation cancelled");
+            }
 
             auto* pos = response->add_predicted_path();
             pos->set_id(sat_id);
@@ -317,6 +519,10 @@ public:
         const OrbitPathRequest* request,
         OrbitPath* response
     ) override {
+        ORBITOPS_TRACE_SCOPE("rpc.GetOrbitPath");
+        FlightRecorder::Request flight(flight_recorder_, "GetOrbitPath", catalog_version_,
+                                       [request] { return request->ShortDebugString(); });
+
         int sat_id = request->satellite_id();
 
         if (sat_id < 0 || sat_id >= static_cast<int>(tles_.size())) {
@@ -343,6 +549,9 @@ public:
             end = start + orbital_period;
         }
 
+        CancellationToken cancel;
+        bind_to_context(cancel, context);
+
         std::lock_guard<std::mutex> lock(system_mutex_);
 
         response->set_satellite_id(sat_id);
@@ -352,7 +561,10 @@ public:
         response->set_step_seconds(step);
 
         for (double t = start; t <= end; t += step) {
-            propagate_all_optimized(system_, t / 60.0);
+            propagate_all_optimized(system_, t / 60.0, &cancel);
+            if (cancel.is_cancelled()) {
+                return grpc::Status(grpc::StatusCode::CANCELLED, "Orbit path cancelled");
+            }
 
             auto* pos = response->add_positions();
             pos->set_x(system_.x[sat_id]);
@@ -363,12 +575,168 @@ public:
         return grpc::Status::OK;
     }
 
+    grpc::Status GetOrbitPaths(
+        grpc::ServerContext* context,
+        const OrbitPathsRequest* request,
+        OrbitPathsResponse* response
+    ) override {
+        ORBITOPS_TRACE_SCOPE("rpc.GetOrbitPaths");
+        FlightRecorder::Request flight(flight_recorder_, "GetOrbitPaths", catalog_version_,
+                                       [request] { return request->ShortDebugString(); });
+
+        std::vector<uint32_t> indices;
+        indices.reserve(request->satellite_ids_size());
+        for (int32_t id : request->satellite_ids()) {
+            if (id < 0 || id >= static_cast<int>(tles_.size())) {
+                return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Invalid satellite ID");
+            }
+            indices.push_back(static_cast<uint32_t>(id));
+        }
+
+        OrbitPathSampling sampling;
+        if (request->tolerance_km() > 0) sampling.tolerance_km = request->tolerance_km();
+        if (request->max_step_seconds() > 0) sampling.max_step_s = request->max_step_seconds();
+
+        CancellationToken cancel;
+        bind_to_context(cancel, context);
+
+        // Only the requested objects are propagated; the shared SoA positions
+        // are left untouched, so the lock only guards against catalog swaps
+        std::lock_guard<std::mutex> lock(system_mutex_);
+        auto paths = sample_orbit_paths(system_, indices,
+                                        request->start_time() / 60.0, request->end_time() / 60.0,
+                                        sampling, &cancel);
+        if (cancel.is_cancelled()) {
+            return grpc::Status(grpc::StatusCode::CANCELLED, "Orbit paths cancelled");
+        }
+
+        int total_samples = 0;
+        response->mutable_paths()->Reserve(static_cast<int>(paths.size()));
+        for (const auto& path : paths) {
+            if (path.times_minutes.empty()) continue;  // Catalog shrank since validation
+
+            auto* out = response->add_paths();
+            out->set_satellite_id(static_cast<int32_t>(path.index));
+            out->set_name(tles_[path.index].name);
+
+            const int n = static_cast<int>(path.times_minutes.size());
+            out->mutable_timestamps()->Reserve(n);
+            for (double t : path.times_minutes) out->add_timestamps(t * 60.0);
+            out->mutable_positions_x()->Add(path.x.begin(), path.x.end());
+            out->mutable_positions_y()->Add(path.y.begin(), path.y.end());
+            out->mutable_positions_z()->Add(path.z.begin(), path.z.end());
+            total_samples += n;
+        }
+        response->set_total_samples(total_samples);
+
+        return grpc::Status::OK;
+    }
+
+    grpc::Status GetStates(
+        grpc::ServerContext* context,
+        const StatesRequest* request,
+        StatesResponse* response
+    ) override {
+        ORBITOPS_TRACE_SCOPE("rpc.GetStates");
+        FlightRecorder::Request flight(flight_recorder_, "GetStates", catalog_version_,
+                                       [request] { return request->ShortDebugString(); });
+
+        const int n = request->satellite_ids_size();
+        if (request->timestamps_size() != n) {
+            return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                                "satellite_ids and timestamps must have the same length");
+        }
+
+        std::vector<StateQuery> queries(n);
+        for (int i = 0; i < n; ++i) {
+            int32_t id = request->satellite_ids(i);
+            if (id < 0 || id >= static_cast<int>(tles_.size())) {
+                return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Invalid satellite ID");
+            }
+            queries[i] = {static_cast<uint32_t>(id), request->timestamps(i) / 60.0};
+        }
+
+        // Evaluate straight into the response's packed arrays
+        auto* px = response->mutable_positions_x();
+        auto* py = response->mutable_positions_y();
+        auto* pz = response->mutable_positions_z();
+        auto* vx = response->mutable_velocities_x();
+        auto* vy = response->mutable_velocities_y();
+        auto* vz = response->mutable_velocities_z();
+        for (auto* field : {px, py, pz, vx, vy, vz}) field->Resize(n, 0.0);
+
+        CancellationToken cancel;
+        bind_to_context(cancel, context);
+
+        // Only the queried objects are propagated; the lock guards against catalog swaps
+        std::lock_guard<std::mutex> lock(system_mutex_);
+        bool complete = propagate_states(system_, queries,
+            {px->mutable_data(), py->mutable_data(), pz->mutable_data(),
+             vx->mutable_data(), vy->mutable_data(), vz->mutable_data()},
+            &cancel);
+
+        if (!complete) {
+            return grpc::Status(grpc::StatusCode::CANCELLED, "State query cancelled");
+        }
+        return grpc::Status::OK;
+    }
+
+    grpc::Status FindNearest(
+        grpc::ServerContext* context,
+        const NearestRequest* request,
+        NeighborResponse* response
+    ) override {
+        ORBITOPS_TRACE_SCOPE("rpc.FindNearest");
+
+        size_t k = request->k() > 0 ? static_cast<size_t>(request->k()) : 10;
+
+        std::lock_guard<std::mutex> lock(query_mutex_);
+        ::Vec3 center;
+        size_t exclude = SIZE_MAX;
+        grpc::Status status = prepare_neighbor_query(request->timestamp(), request->has_satellite_id(),
+                                                     request->satellite_id(), request->point().x(),
+                                                     request->point().y(), request->point().z(),
+                                                     center, exclude);
+        if (!status.ok()) return status;
+
+        auto neighbors = query_index_.grid.query_knn(query_index_.sys, center, k, exclude);
+        fill_neighbors(neighbors, request->timestamp(), response);
+        return grpc::Status::OK;
+    }
+
+    grpc::Status FindWithinRadius(
+        grpc::ServerContext* context,
+        const RadiusRequest* request,
+        NeighborResponse* response
+    ) override {
+        ORBITOPS_TRACE_SCOPE("rpc.FindWithinRadius");
+
+        double radius = request->radius_km() > 0 ? request->radius_km() : 50.0;
+
+        std::lock_guard<std::mutex> lock(query_mutex_);
+        ::Vec3 center;
+        size_t exclude = SIZE_MAX;
+        grpc::Status status = prepare_neighbor_query(request->timestamp(), request->has_satellite_id(),
+                                                     request->satellite_id(), request->point().x(),
+                                                     request->point().y(), request->point().z(),
+                                                     center, exclude);
+        if (!status.ok()) return status;
+
+        auto neighbors = query_index_.grid.query_radius(query_index_.sys, center, radius, exclude);
+        fill_neighbors(neighbors, request->timestamp(), response);
+        return grpc::Status::OK;
+    }
+
     // ========== Phase 6.3: Maneuver Optimization ==========
     grpc::Status OptimizeManeuver(
         grpc::ServerContext* context,
         const ManeuverOptimizeRequest* request,
         ManeuverOptimizeResponse* response
     ) override {
+        ORBITOPS_TRACE_SCOPE("rpc.OptimizeManeuver");
+        FlightRecorder::Request flight(flight_recorder_, "OptimizeManeuver", catalog_version_,
+                                       [request] { return request->ShortDebugString(); });
+
         int sat_id = request->satellite_id();
         int threat_id = request->threat_id();
 
@@ -446,6 +814,8 @@ public:
         const HistoryRequest* request,
         HistoryResponse* response
     ) override {
+        ORBITOPS_TRACE_SCOPE("rpc.GetHistory");
+
         if (!request->has_time_range()) {
             return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Time range required");
         }
@@ -459,6 +829,12 @@ public:
             auto* proto_snap = response->add_snapshots();
             proto_snap->set_timestamp(snap.time_minutes * 60.0);
 
+            const int n = static_cast<int>(snap.satellite_ids.size());
+            proto_snap->mutable_satellite_ids()->Reserve(n);
+            proto_snap->mutable_positions_x()->Reserve(n);
+            proto_snap->mutable_positions_y()->Reserve(n);
+            proto_snap->mutable_positions_z()->Reserve(n);
+
             for (size_t i = 0; i < snap.satellite_ids.size(); ++i) {
                 proto_snap->add_satellite_ids(snap.satellite_ids[i]);
                 proto_snap->add_positions_x(snap.positions_x[i]);
@@ -476,6 +852,8 @@ public:
         const ConjunctionHistoryRequest* request,
         ConjunctionHistoryResponse* response
     ) override {
+        ORBITOPS_TRACE_SCOPE("rpc.GetConjunctionHistory");
+
         double start_min = 0.0;
         double end_min = std::numeric_limits<double>::max();
 
@@ -534,6 +912,8 @@ public:
         const TLEUpdateRequest* request,
         TLEUpdateResponse* response
     ) override {
+        ORBITOPS_TRACE_SCOPE("rpc.UpdateTLEs");
+
         std::vector<TLEFetchResult> results;
 
         if (request->source_names_size() == 0) {
@@ -545,6 +925,8 @@ public:
         }
 
         int total_satellites = 0;
+        bool catalog_changed = false;
+        size_t objects_decayed = 0;
         for (const auto& result : results) {
             auto* result_msg = response->add_results();
             result_msg->set_source_name(result.source_name);
@@ -560,10 +942,29 @@ public:
                 std::lock_guard<std::mutex> lock(system_mutex_);
                 tles_ = merge_tle_sets(tles_, result.tles);
                 total_satellites += result.tles.size();
+                catalog_changed = true;
             }
         }
 
+        if (catalog_changed) {
+            {
+                // New catalog version: rebuild the SoA and drop stale encoded frames
+                std::lock_guard<std::mutex> lock(system_mutex_);
+                system_ = create_satellite_system(tles_);
+                orbit_bands_.sync(system_);
+                debris_model_->load(tles_, system_);
+                uint64_t version = ++catalog_version_;
+                frame_cache_.invalidate_before(version);
+            }
+
+            // Reentry prediction runs outside the lock
+            CancellationToken cancel;
+            bind_to_context(cancel, context);
+            objects_decayed = refresh_reentries(true, &cancel);
+        }
+
         response->set_total_satellites(static_cast<int>(tles_.size()));
+        response->set_objects_decayed(static_cast<int>(objects_decayed));
         return grpc::Status::OK;
     }
 
@@ -572,6 +973,8 @@ public:
         const TLESourcesRequest* request,
         TLESourcesResponse* response
     ) override {
+        ORBITOPS_TRACE_SCOPE("rpc.GetTLESources");
+
         // Return configured TLE sources
         std::vector<std::pair<std::string, std::string>> sources = {
             {"Space Stations", "https://celestrak.org/NORAD/elements/gp.php?GROUP=stations&FORMAT=tle"},
@@ -602,59 +1005,663 @@ public:
         const DebrisFieldRequest* request,
         DebrisFieldResponse* response
     ) override {
-        std::lock_guard<std::mutex> lock(system_mutex_);
+        ORBITOPS_TRACE_SCOPE("rpc.GetDebrisField");
 
-        // Update debris positions from current satellite system
-        debris_model_->update_positions(system_, tles_);
+        CancellationToken cancel;
+        bind_to_context(cancel, context);
 
-        const auto& debris = debris_model_->get_debris();
-        std::vector<DebrisObject> filtered_debris;
+        std::lock_guard<std::mutex> lock(system_mutex_);
 
         double min_alt = request->has_min_altitude_km() ? request->min_altitude_km() : 0.0;
         double max_alt = request->has_max_altitude_km() ? request->max_altitude_km() : 100000.0;
+        const double t = request->has_time_range() ? request->time_range().start_time()
+                                                   : static_cast<double>(std::time(nullptr));
+
+        // Debris positions are written as float32 by the propagator into the
+        // model's render buffer; a repeated epoch reuses them as they are
+        if (!debris_model_->update_render_positions(system_, t / 60.0, &cancel)) {
+            return grpc::Status(grpc::StatusCode::CANCELLED, "Request cancelled or deadline exceeded");
+        }
+        const DebrisRenderBuffer& render = debris_model_->render_buffer();
+
+        // Debris rows in the band, shipped as packed arrays
+        const auto rows = request->by_orbit_crossing()
+            ? debris_model_->get_debris_crossing(orbit_bands_, min_alt, max_alt)
+            : debris_model_->get_debris_in_shell(min_alt, max_alt);
+        const int n = static_cast<int>(rows.size());
+        const bool send_attributes = request->known_attributes_version() != render.catalog_version();
+
+        response->mutable_ids()->Resize(n, 0);
+        response->mutable_positions()->Resize(3 * n, 0.0f);
+        if (send_attributes) {
+            response->mutable_colors()->Resize(3 * n, 0.0f);
+            response->mutable_sizes()->Resize(n, 0.0f);
+        }
+        render.gather(rows, response->mutable_ids()->mutable_data(),
+                      response->mutable_positions()->mutable_data(),
+                      send_attributes ? response->mutable_colors()->mutable_data() : nullptr,
+                      send_attributes ? response->mutable_sizes()->mutable_data() : nullptr);
+        response->set_attributes_version(render.catalog_version());
+        response->set_timestamp(t);
+
+        if (request->include_objects()) {
+            // States at the request epoch, consistent with the packed positions
+            std::vector<DebrisObject> objects;
+            if (!debris_model_->get_objects_at(rows, system_, t / 60.0, objects, &cancel)) {
+                return grpc::Status(grpc::StatusCode::CANCELLED, "Request cancelled or deadline exceeded");
+            }
+            response->mutable_debris()->Reserve(n);
+            for (const DebrisObject& d : objects) {
+                auto* debris_msg = response->add_debris();
+                debris_msg->set_id(d.id);
+                debris_msg->set_name(d.name);
+                debris_msg->set_origin(d.origin);
+
+                auto* pos = debris_msg->mutable_position();
+                pos->set_x(d.position.x);
+                pos->set_y(d.position.y);
+                pos->set_z(d.position.z);
+
+                auto* vel = debris_msg->mutable_velocity();
+                vel->set_x(d.velocity.x);
+                vel->set_y(d.velocity.y);
+                vel->set_z(d.velocity.z);
+
+                debris_msg->set_radar_cross_section(d.rcs);
+                debris_msg->set_timestamp(t);
+            }
+        }
+
+        if (request->include_fields()) {
+            // Cloud statistics are refreshed by every catalog propagation;
+            // propagate here only when no stream has reached this epoch
+            const auto& fields = debris_model_->get_debris_fields();
+            const bool current = std::all_of(fields.begin(), fields.end(), [&](const DebrisField& field) {
+                return field.has_statistics && field.stats_epoch_minutes == t / 60.0;
+            });
+            if (!current) {
+                propagate_all_optimized(system_, t / 60.0, &cancel);
+                if (cancel.is_cancelled()) {
+                    return grpc::Status(grpc::StatusCode::CANCELLED, "Request cancelled or deadline exceeded");
+                }
+                debris_model_->update_field_statistics(system_, t / 60.0);
+            }
 
-        for (const auto& d : debris) {
-            if (d.altitude_km >= min_alt && d.altitude_km <= max_alt) {
-                filtered_debris.push_back(d);
+            response->mutable_fields()->Reserve(static_cast<int>(fields.size()));
+            for (const DebrisField& field : fields) {
+                auto* stats = response->add_fields();
+                stats->set_event_id(field.event_id);
+                stats->set_event_name(field.event_name);
+                stats->set_fragment_count(field.total_fragments);
+                stats->mutable_centroid()->set_x(field.centroid.x);
+                stats->mutable_centroid()->set_y(field.centroid.y);
+                stats->mutable_centroid()->set_z(field.centroid.z);
+                stats->mutable_mean_velocity()->set_x(field.mean_velocity.x);
+                stats->mutable_mean_velocity()->set_y(field.mean_velocity.y);
+                stats->mutable_mean_velocity()->set_z(field.mean_velocity.z);
+                stats->set_spread_radius_km(field.spread_radius_km);
+                stats->set_plane_dispersion_deg(field.plane_dispersion_deg);
+                stats->set_spread_rate_km_per_day(field.spread_rate_km_per_day);
             }
         }
 
-        double total_volume = 0.0;
-        for (const auto& d : filtered_debris) {
-            auto* debris_msg = response->add_debris();
-            debris_msg->set_id(d.id);
-            debris_msg->set_name(d.name);
-            debris_msg->set_origin(d.origin);
+        // Spatial density over the band, capped at the highest debris orbit
+        const double bottom = 6371.0 + std::max(min_alt, 0.0);
+        const double top = 6371.0 + std::min(max_alt, render.max_altitude_km());
+        const double volume = top > bottom ? 4.0 / 3.0 * M_PI * (top * top * top - bottom * bottom * bottom) : 0.0;
+
+        response->set_total_count(n);
+        response->set_flux_density(volume > 0.0 ? n / volume : 0.0);  // per km^3
 
-            auto* pos = debris_msg->mutable_position();
-            pos->set_x(d.position.x);
-            pos->set_y(d.position.y);
-            pos->set_z(d.position.z);
+        return grpc::Status::OK;
+    }
 
-            auto* vel = debris_msg->mutable_velocity();
-            vel->set_x(d.velocity.x);
-            vel->set_y(d.velocity.y);
-            vel->set_z(d.velocity.z);
+    // ========== Conjunction Alerts ==========
+    grpc::Status SubscribeConjunctions(
+        grpc::ServerContext* context,
+        const AlertSubscription* request,
+        grpc::ServerWriter<ConjunctionAlertBatch>* writer
+    ) override {
+        ORBITOPS_TRACE_SCOPE("rpc.SubscribeConjunctions");
+
+        const std::unordered_set<uint32_t> protected_ids(request->protected_ids().begin(),
+                                                         request->protected_ids().end());
+        const double min_probability = request->min_probability();
+        auto wanted = [&](const MonitoredConjunction& event) {
+            return event.collision_probability >= min_probability &&
+                   (protected_ids.empty() || protected_ids.count(event.sat1_id) > 0 ||
+                    protected_ids.count(event.sat2_id) > 0);
+        };
 
-            debris_msg->set_radar_cross_section(d.rcs);
-            debris_msg->set_timestamp(std::time(nullptr));
+        // Screening is shared: every subscriber diffs the same event table
+        start_monitor();
+
+        PacedWriter<ConjunctionAlertBatch> pacer(
+            [writer](const ConjunctionAlertBatch& batch) { return writer->Write(batch); },
+            stream_window_);
+        StreamRegistration registration(*this, "SubscribeConjunctions", context->peer(),
+            [&pacer] { return pacer.get_stats(); });
+
+        CancellationToken cancel;
+        bind_to_context(cancel, context);
+
+        // Last revision sent to this client, by event id
+        std::unordered_map<uint64_t, MonitoredConjunction> sent;
+        uint64_t seen_generation = UINT64_MAX;
+        bool initial = true;
+
+        while (!cancel.is_cancelled()) {
+            std::shared_ptr<const std::vector<std::string>> names;
+            double window_from, window_until;
+            {
+                std::unique_lock<std::mutex> lock(monitor_mutex_);
+                monitor_cv_.wait_for(lock, std::chrono::seconds(1), [&] {
+                    return monitor_stop_ || monitor_table_.generation() != seen_generation;
+                });
+                if (monitor_stop_) break;
+                names = monitor_names_;
+                window_from = monitor_window_from_;
+                window_until = monitor_window_until_;
+            }
+
+            uint64_t generation = monitor_table_.generation();
+            if (generation == seen_generation) continue;
+            seen_generation = generation;
+            auto events = monitor_table_.events();
+
+            auto batch = pacer.acquire();
+            batch->Clear();
+            batch->set_initial(initial);
+            batch->set_screened_from(window_from);
+            batch->set_screened_until(window_until);
+
+            auto add_alert = [&](AlertKind kind, const MonitoredConjunction& event) {
+                auto* alert = batch->add_alerts();
+                alert->set_kind(kind);
+                alert->set_event_id(event.event_id);
+                alert->set_revision(event.revision);
+
+                auto* warning = alert->mutable_conjunction();
+                warning->set_sat1_id(static_cast<int32_t>(event.sat1_id));
+                warning->set_sat2_id(static_cast<int32_t>(event.sat2_id));
+                if (names && event.sat2_id < names->size()) {
+                    warning->set_sat1_name((*names)[event.sat1_id]);
+                    warning->set_sat2_name((*names)[event.sat2_id]);
+                }
+                warning->set_tca(event.tca_minutes * 60.0);
+                warning->set_miss_distance(event.miss_distance_km);
+                warning->set_relative_velocity(event.relative_velocity_km_s);
+                warning->set_collision_probability(event.collision_probability);
+                warning->set_combined_radius(monitor_config_.collision_radius_km);
+            };
+
+            // New and changed events that pass this client's filter
+            std::unordered_set<uint64_t> present;
+            for (const auto& event : *events) {
+                if (!wanted(event)) continue;
+                present.insert(event.event_id);
+
+                auto it = sent.find(event.event_id);
+                if (it == sent.end()) {
+                    add_alert(ALERT_NEW, event);
+                    sent.emplace(event.event_id, event);
+                } else if (it->second.revision != event.revision) {
+                    add_alert(ALERT_CHANGED, event);
+                    it->second = event;
+                }
+            }
+
+            // Resolved, expired, or no longer passing the filter
+            for (auto it = sent.begin(); it != sent.end();) {
+                if (present.count(it->first) == 0) {
+                    add_alert(ALERT_RESOLVED, it->second);
+                    it = sent.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+
+            if (initial || batch->alerts_size() > 0) {
+                if (!pacer.push(std::move(batch), false)) break;
+                initial = false;
+            }
+        }
+
+        pacer.close();
+        if (cancel.is_cancelled()) {
+            return grpc::Status(grpc::StatusCode::CANCELLED, "Stream cancelled or deadline exceeded");
+        }
+        return grpc::Status::OK;
+    }
 
-            // Calculate volume of shell for flux
-            double r = 6371.0 + d.altitude_km;
-            total_volume += 4.0 * M_PI * r * r * 50.0;  // 50km shell thickness
+    // Stop the standing screener and release alert subscribers
+    void stop_monitor() {
+        {
+            std::lock_guard<std::mutex> lock(monitor_mutex_);
+            monitor_stop_ = true;
         }
+        monitor_cancel_.cancel();
+        monitor_cv_.notify_all();
+        if (monitor_thread_.joinable()) monitor_thread_.join();
+    }
 
-        response->set_total_count(static_cast<int>(filtered_debris.size()));
-        response->set_flux_density(filtered_debris.size() / (total_volume / 1e9));  // per km^3
+    ~OrbitOpsServiceImpl() {
+        stop_monitor();
+    }
+
+    // ========== Server Metrics ==========
+    grpc::Status GetServerMetrics(
+        grpc::ServerContext* context,
+        const ServerMetricsRequest* request,
+        ServerMetrics* response
+    ) override {
+        ORBITOPS_TRACE_SCOPE("rpc.GetServerMetrics");
+
+        response->set_catalog_version(catalog_version_);
+
+        auto cache_stats = frame_cache_.get_stats();
+        auto* cache = response->mutable_frame_cache();
+        cache->set_hits(static_cast<int64_t>(cache_stats.hits));
+        cache->set_misses(static_cast<int64_t>(cache_stats.misses));
+        cache->set_insertions(static_cast<int64_t>(cache_stats.insertions));
+        cache->set_evictions(static_cast<int64_t>(cache_stats.evictions));
+        cache->set_entries(static_cast<int64_t>(cache_stats.entries));
+        cache->set_bytes(static_cast<int64_t>(cache_stats.bytes));
+        cache->set_max_bytes(static_cast<int64_t>(cache_stats.max_bytes));
+        cache->set_hit_rate(cache_stats.hit_rate());
+
+        std::lock_guard<std::mutex> lock(streams_mutex_);
+        for (const auto& [id, stream] : active_streams_) {
+            auto stats = stream.stats();
+            auto* msg = response->add_streams();
+            msg->set_stream_id(id);
+            msg->set_method(stream.method);
+            msg->set_peer(stream.peer);
+            msg->set_frames_written(static_cast<int64_t>(stats.frames_written));
+            msg->set_frames_dropped(static_cast<int64_t>(stats.frames_dropped));
+            msg->set_queue_depth(static_cast<int32_t>(stats.queue_depth));
+            msg->set_max_queue_depth(static_cast<int32_t>(stats.max_queue_depth));
+            msg->set_lag_ms(stats.oldest_frame_age_ms);
+            msg->set_max_write_latency_ms(stats.max_write_latency_ms);
+        }
+        response->set_total_frames_dropped(static_cast<int64_t>(
+            total_frames_dropped_.load(std::memory_order_relaxed)));
 
         return grpc::Status::OK;
     }
 
+    // Prometheus text page for the local metrics endpoint
+    std::string render_metrics() {
+        std::string out;
+        stage_metrics_.render_prometheus(out);
+
+        auto cache_stats = frame_cache_.get_stats();
+        append_prometheus_metric(out, "orbitops_catalog_version", "gauge",
+                                 "Current catalog version", static_cast<double>(catalog_version_.load()));
+        append_prometheus_metric(out, "orbitops_frame_cache_hits_total", "counter",
+                                 "Frame cache hits", static_cast<double>(cache_stats.hits));
+        append_prometheus_metric(out, "orbitops_frame_cache_misses_total", "counter",
+                                 "Frame cache misses", static_cast<double>(cache_stats.misses));
+        append_prometheus_metric(out, "orbitops_frame_cache_bytes", "gauge",
+                                 "Encoded frame bytes held by the cache", static_cast<double>(cache_stats.bytes));
+        append_prometheus_metric(out, "orbitops_frames_dropped_total", "counter",
+                                 "Position frames skipped by completed streams",
+                                 static_cast<double>(total_frames_dropped_.load(std::memory_order_relaxed)));
+
+        size_t streams;
+        {
+            std::lock_guard<std::mutex> lock(streams_mutex_);
+            streams = active_streams_.size();
+        }
+        append_prometheus_metric(out, "orbitops_active_streams", "gauge",
+                                 "Streaming RPCs in progress", static_cast<double>(streams));
+
+        auto recorder_stats = flight_recorder_.get_stats();
+        append_prometheus_metric(out, "orbitops_slow_requests_total", "counter",
+                                 "Requests or stream steps over the latency SLO",
+                                 static_cast<double>(recorder_stats.slow_requests));
+        append_prometheus_metric(out, "orbitops_flight_recorder_dumps_total", "counter",
+                                 "Slow-request dumps written", static_cast<double>(recorder_stats.dumps_written));
+        append_prometheus_metric(out, "orbitops_flight_recorder_dumps_suppressed_total", "counter",
+                                 "Slow-request dumps skipped (rate limit, dump cap or write failure)",
+                                 static_cast<double>(recorder_stats.dumps_suppressed));
+        return out;
+    }
+
 private:
+    // Active streaming RPC, tracked for per-stream lag metrics
+    struct ActiveStream {
+        std::string method;
+        std::string peer;
+        std::function<PacedWriterStats()> stats;
+    };
+
+    // Registers a stream for its lifetime
+    class StreamRegistration {
+    public:
+        StreamRegistration(OrbitOpsServiceImpl& service, const std::string& method,
+                           const std::string& peer, std::function<PacedWriterStats()> stats)
+            : service_(service)
+        {
+            std::lock_guard<std::mutex> lock(service_.streams_mutex_);
+            id_ = service_.next_stream_id_++;
+            service_.active_streams_[id_] = {method, peer, std::move(stats)};
+        }
+
+        ~StreamRegistration() {
+            std::lock_guard<std::mutex> lock(service_.streams_mutex_);
+            auto it = service_.active_streams_.find(id_);
+            service_.total_frames_dropped_ += it->second.stats().frames_dropped;
+            service_.active_streams_.erase(it);
+        }
+
+    private:
+        OrbitOpsServiceImpl& service_;
+        uint64_t id_;
+    };
+
+    // Trip `token` when the client cancels or the call deadline passes, so
+    // kernels stop within one chunk instead of finishing abandoned work
+    static void bind_to_context(CancellationToken& token, grpc::ServerContext* context) {
+        auto deadline = context->deadline();
+        if (deadline != std::chrono::system_clock::time_point::max()) {
+            auto remaining = deadline - std::chrono::system_clock::now();
+            if (remaining < std::chrono::hours(24 * 365)) {
+                token.set_deadline(CancellationToken::Clock::now() +
+                    std::chrono::duration_cast<CancellationToken::Clock::duration>(remaining));
+            }
+        }
+        token.set_poll([context] { return context->IsCancelled(); });
+    }
+
+    // Aggregate one screening step's stage timings and, if requested,
+    // attach them to the outgoing batch (cached frames never carry them)
+    void finish_step(ConjunctionBatch& batch, const StageTimings& timings, bool cache_hit, bool attach) {
+        stage_metrics_.record(timings);
+        if (!attach) return;
+
+        auto* diagnostics = batch.mutable_diagnostics();
+        diagnostics->set_propagate_ms(timings.seconds(Stage::PROPAGATE) * 1e3);
+        diagnostics->set_grid_build_ms(timings.seconds(Stage::GRID_BUILD) * 1e3);
+        diagnostics->set_pair_test_ms(timings.seconds(Stage::PAIR_TEST) * 1e3);
+        diagnostics->set_monte_carlo_ms(timings.seconds(Stage::MONTE_CARLO) * 1e3);
+        diagnostics->set_serialize_ms(timings.seconds(Stage::SERIALIZE) * 1e3);
+        diagnostics->set_candidates_tested(static_cast<int64_t>(timings.count(StageCounter::CANDIDATES_TESTED)));
+        diagnostics->set_hits(static_cast<int64_t>(timings.count(StageCounter::HITS)));
+        diagnostics->set_pc_samples(static_cast<int64_t>(timings.count(StageCounter::PC_SAMPLES)));
+        diagnostics->set_bytes_written(static_cast<int64_t>(timings.count(StageCounter::BYTES_WRITTEN)));
+        diagnostics->set_cache_hit(cache_hit);
+    }
+
+    static FlightRecorderConfig make_flight_recorder_config(const ServerConfig& config) {
+        FlightRecorderConfig recorder;
+        recorder.default_slo_ms = config.slow_request_ms;
+        recorder.dump_directory = config.flight_recorder_dir;
+        return recorder;
+    }
+
+    static MonitorConfig make_monitor_config(const ServerConfig& config) {
+        MonitorConfig monitor;
+        monitor.horizon_minutes = config.monitor_horizon_hours * 60.0;
+        monitor.step_seconds = config.monitor_step_seconds;
+        monitor.threshold_km = config.monitor_threshold_km;
+        return monitor;
+    }
+
+    void start_monitor() {
+        std::lock_guard<std::mutex> lock(monitor_mutex_);
+        if (monitor_started_ || monitor_stop_) return;
+        monitor_started_ = true;
+        monitor_thread_ = std::thread([this] { monitor_loop(); });
+    }
+
+    // Keep the look-ahead window screened from wall-clock now on a private
+    // catalog copy, so screening never holds system_mutex_. Each pass only
+    // screens the slices that entered the window since the last one; catalog
+    // updates re-screen just the new and changed objects.
+    void monitor_loop() {
+        ScreeningHorizon horizon(monitor_table_, monitor_config_);
+        uint64_t version = 0;
+
+        auto now_minutes = [] {
+            return std::chrono::duration<double>(
+                std::chrono::system_clock::now().time_since_epoch()).count() / 60.0;
+        };
+
+        while (true) {
+            SatelliteSystem fresh;
+            bool catalog_changed = false;
+            {
+                std::lock_guard<std::mutex> lock(system_mutex_);
+                if (version != catalog_version_) {
+                    fresh = create_satellite_system(tles_);
+                    version = catalog_version_;
+                    catalog_changed = true;
+
+                    std::lock_guard<std::mutex> monitor_lock(monitor_mutex_);
+                    monitor_names_ = std::make_shared<const std::vector<std::string>>(fresh.names);
+                }
+            }
+
+            if (catalog_changed) {
+                if (horizon.has_catalog()) {
+                    horizon.update_catalog(std::move(fresh), now_minutes(), &monitor_cancel_);
+                } else {
+                    horizon.reset(std::move(fresh), now_minutes());
+                }
+            }
+
+            // Fill in chunks so subscribers see the near term while a cold
+            // window is still being screened
+            size_t slices;
+            do {
+                const double now = now_minutes();
+                slices = horizon.advance(now, MONITOR_SLICES_PER_PUBLISH, &monitor_cancel_);
+                if (monitor_cancel_.is_cancelled()) return;
+
+                std::lock_guard<std::mutex> lock(monitor_mutex_);
+                monitor_window_from_ = now * 60.0;
+                monitor_window_until_ = horizon.screened_until() * 60.0;
+                monitor_cv_.notify_all();
+            } while (slices == MONITOR_SLICES_PER_PUBLISH);
+
+            std::unique_lock<std::mutex> lock(monitor_mutex_);
+            if (monitor_cv_.wait_for(lock, monitor_interval_, [this] { return monitor_stop_; })) break;
+        }
+    }
+
+    // Bring the query index to (current catalog, timestamp) and resolve the
+    // query centre. Caller holds query_mutex_. Queries at the timestamp the
+    // index was last built for reuse its positions and grid.
+    grpc::Status prepare_neighbor_query(double timestamp, bool has_satellite_id, int32_t satellite_id,
+                                        double px, double py, double pz,
+                                        ::Vec3& center, size_t& exclude) {
+        {
+            std::lock_guard<std::mutex> lock(system_mutex_);
+            if (query_index_.catalog_version != catalog_version_) {
+                query_index_.sys = create_satellite_system(tles_);
+                query_index_.catalog_version = catalog_version_;
+                query_index_.timestamp = std::numeric_limits<double>::quiet_NaN();
+            }
+        }
+
+        if (!(query_index_.timestamp == timestamp)) {
+            propagate_all_optimized(query_index_.sys, timestamp / 60.0);
+            query_index_.grid.build(query_index_.sys);
+            query_index_.timestamp = timestamp;
+        }
+
+        const SatelliteSystem& sys = query_index_.sys;
+        if (has_satellite_id) {
+            if (satellite_id < 0 || static_cast<size_t>(satellite_id) >= sys.count) {
+                return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Invalid satellite ID");
+            }
+            exclude = static_cast<size_t>(satellite_id);
+            center = {sys.x[exclude], sys.y[exclude], sys.z[exclude]};
+        } else {
+            center = {px, py, pz};
+        }
+        return grpc::Status::OK;
+    }
+
+    // Caller holds query_mutex_
+    void fill_neighbors(const std::vector<Neighbor>& neighbors, double timestamp,
+                        NeighborResponse* response) const {
+        const SatelliteSystem& sys = query_index_.sys;
+        response->set_timestamp(timestamp);
+        response->mutable_neighbors()->Reserve(static_cast<int>(neighbors.size()));
+
+        for (const auto& neighbor : neighbors) {
+            size_t i = neighbor.index;
+            auto* out = response->add_neighbors();
+            out->set_satellite_id(static_cast<int32_t>(i));
+            out->set_name(sys.names[i]);
+            out->set_distance_km(neighbor.distance_km);
+
+            auto* position = out->mutable_position();
+            position->set_x(sys.x[i]);
+            position->set_y(sys.y[i]);
+            position->set_z(sys.z[i]);
+        }
+    }
+
+    // Convert a request filter into core predicates
+    static ObjectFilter to_object_filter(const PositionFilter& proto) {
+        ObjectFilter filter;
+        filter.ids.assign(proto.satellite_ids().begin(), proto.satellite_ids().end());
+        if (proto.has_min_altitude_km()) filter.min_altitude_km = proto.min_altitude_km();
+        if (proto.has_max_altitude_km()) filter.max_altitude_km = proto.max_altitude_km();
+        if (proto.has_min_inclination_deg()) filter.min_inclination_deg = proto.min_inclination_deg();
+        if (proto.has_max_inclination_deg()) filter.max_inclination_deg = proto.max_inclination_deg();
+        if (proto.has_min_orbit_altitude_km()) filter.min_orbit_altitude_km = proto.min_orbit_altitude_km();
+        if (proto.has_max_orbit_altitude_km()) filter.max_orbit_altitude_km = proto.max_orbit_altitude_km();
+        filter.class_mask = static_cast<uint8_t>(proto.object_class_mask());
+
+        if (proto.has_geo_box()) {
+            filter.has_geo_box = true;
+            filter.min_lat_deg = proto.geo_box().min_lat_deg();
+            filter.max_lat_deg = proto.geo_box().max_lat_deg();
+            filter.min_lon_deg = proto.geo_box().min_lon_deg();
+            filter.max_lon_deg = proto.geo_box().max_lon_deg();
+        }
+
+        for (const auto& plane : proto.frustum_planes()) {
+            filter.frustum.push_back({plane.nx(), plane.ny(), plane.nz(), plane.d()});
+        }
+        return filter;
+    }
+
+    // Record a screened step's conjunctions to history (fresh or cached)
+    void record_conjunctions(const ConjunctionBatch& batch, double time_minutes) {
+        for (const auto& warning : batch.conjunctions()) {
+            ConjunctionEvent event;
+            event.time_minutes = time_minutes;
+            event.wall_time = std::chrono::system_clock::now();
+            event.sat1_id = warning.sat1_id();
+            event.sat2_id = warning.sat2_id();
+            event.sat1_name = warning.sat1_name();
+            event.sat2_name = warning.sat2_name();
+            event.miss_distance = warning.miss_distance();
+            event.relative_velocity = warning.relative_velocity();
+            event.collision_probability = warning.collision_probability();
+            history_recorder_->record_conjunction(event);
+        }
+    }
+
+    // Predict reentries for the low-perigee catalog on a private copy,
+    // outside system_mutex_, then feed them to the debris model. With
+    // `tombstone`, objects whose whole reentry window has passed are dropped
+    // from the catalog unless a fresher element set arrived meanwhile (a
+    // later update with one brings them back). Caller must not hold
+    // system_mutex_; returns the number of objects dropped.
+    size_t refresh_reentries(bool tombstone, const CancellationToken* cancel) {
+        std::vector<TLE> tles;
+        {
+            std::lock_guard<std::mutex> lock(system_mutex_);
+            tles = tles_;
+        }
+        const SatelliteSystem snapshot = create_satellite_system(tles);
+        const ReentryReport report = predict_reentries(snapshot, reentry_config_, nullptr, cancel);
+        if (!report.success) return 0;
+
+        // Decayed objects, keyed to the element epoch the prediction used
+        std::unordered_map<int, double> decayed;
+        if (tombstone) {
+            const double now_jd = std::chrono::duration<double>(
+                std::chrono::system_clock::now().time_since_epoch()).count() / 86400.0 + 2440587.5;
+            for (int catalog_number : decayed_catalog_numbers(report, tles, now_jd)) {
+                decayed.emplace(catalog_number, 0.0);
+            }
+            for (const auto& tle : tles) {
+                auto it = decayed.find(tle.catalog_number);
+                if (it != decayed.end()) it->second = std::max(it->second, tle.epoch_jd);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(system_mutex_);
+        const size_t before = tles_.size();
+        if (!decayed.empty()) {
+            std::erase_if(tles_, [&](const TLE& tle) {
+                auto it = decayed.find(tle.catalog_number);
+                return it != decayed.end() && tle.epoch_jd <= it->second;
+            });
+        }
+        const size_t dropped = before - tles_.size();
+        if (dropped > 0) {
+            system_ = create_satellite_system(tles_);
+            orbit_bands_.sync(system_);
+            debris_model_->load(tles_, system_);
+            uint64_t version = ++catalog_version_;
+            frame_cache_.invalidate_before(version);
+        }
+        debris_model_->apply_reentry_predictions(report, system_);
+        return dropped;
+    }
+
     std::vector<TLE> tles_;
     SatelliteSystem system_;
+    OrbitIntervalIndex orbit_bands_;   // Perigee/apogee ranges of system_ (filters, debris queries)
+    ReentryConfig reentry_config_;
     std::mutex system_mutex_;  // Protect system_ for concurrent access
 
+    // Bumped whenever the catalog changes; keys cached frames
+    std::atomic<uint64_t> catalog_version_{1};
+    FrameCache frame_cache_;
+    StageMetrics stage_metrics_;   // StreamConjunctions per-stage timings
+    FlightRecorder flight_recorder_;
+
+    // Private catalog copy and grid for neighbour queries, rebuilt only when
+    // the catalog version or query timestamp changes
+    struct QueryIndex {
+        SatelliteSystem sys;
+        SpatialGrid grid{50.0};
+        uint64_t catalog_version = 0;
+        double timestamp = std::numeric_limits<double>::quiet_NaN();
+    };
+    QueryIndex query_index_;
+    std::mutex query_mutex_;
+
+    // Standing conjunction screener shared by alert subscribers
+    ConjunctionEventTable monitor_table_;
+    MonitorConfig monitor_config_;
+    std::chrono::duration<double> monitor_interval_;
+    std::thread monitor_thread_;
+    CancellationToken monitor_cancel_;
+    std::mutex monitor_mutex_;
+    std::condition_variable monitor_cv_;
+    bool monitor_started_ = false;
+    bool monitor_stop_ = false;
+    std::shared_ptr<const std::vector<std::string>> monitor_names_;
+    double monitor_window_from_ = 0.0;      // Unix timestamps
+    double monitor_window_until_ = 0.0;
+
+    // Streaming write pressure
+    size_t stream_window_;
+    std::mutex streams_mutex_;
+    std::map<uint64_t, ActiveStream> active_streams_;
+    uint64_t next_stream_id_ = 1;
+    std::atomic<uint64_t> total_frames_dropped_{0};
+
     // Phase 6 modules
     std::unique_ptr<CollisionProbabilityCalculator> probability_calculator_;
     std::unique_ptr<ManeuverOptimizer> maneuver_optimizer_;
@@ -666,11 +1673,20 @@ private:
 // Pimpl implementation
 class OrbitOpsServer::Impl {
 public:
-    Impl(const std::string& tle_file, uint16_t port)
-        : service_(tle_file)
+    Impl(const std::string& tle_file, uint16_t port, const ServerConfig& config)
+        : service_(tle_file, config)
         , port_(port)
         , address_("0.0.0.0:" + std::to_string(port))
-    {}
+    {
+        if (config.metrics_port != 0) {
+            metrics_endpoint_ = std::make_unique<MetricsEndpoint>(
+                config.metrics_port, [this] { return service_.render_metrics(); });
+
+            // Buffered spans (empty unless built with ORBITOPS_TRACING)
+            metrics_endpoint_->add_route("/trace", "application/json",
+                                         [] { return trace::chrome_json(); });
+        }
+    }
 
     void run() {
         grpc::ServerBuilder builder;
@@ -683,10 +1699,23 @@ public:
         
         server_ = builder.BuildAndStart();
         std::cout << "[OrbitOps] Server listening on " << address_ << std::endl;
+
+        if (metrics_endpoint_) {
+            if (metrics_endpoint_->start()) {
+                std::cout << "[OrbitOps] Metrics at http://127.0.0.1:" << metrics_endpoint_->port()
+                          << "/metrics" << std::endl;
+            } else {
+                std::cerr << "[OrbitOps] Could not bind metrics port " << metrics_endpoint_->port() << std::endl;
+            }
+        }
         server_->Wait();
     }
 
     void shutdown() {
+        service_.stop_monitor();  // Ends alert subscriptions so Shutdown() can drain
+        if (metrics_endpoint_) {
+            metrics_endpoint_->stop();
+        }
         if (server_) {
             server_->Shutdown();
         }
@@ -699,11 +1728,13 @@ private:
     uint16_t port_;
     std::string address_;
     std::unique_ptr<grpc::Server> server_;
+    std::unique_ptr<MetricsEndpoint> metrics_endpoint_;
 };
 
 // Public interface
-OrbitOpsServer::OrbitOpsServer(const std::string& tle_file, uint16_t port)
-    : impl_(std::make_unique<Impl>(tle_file, port))
+OrbitOpsServer::OrbitOpsServer(const std::string& tle_file, uint16_t port,
+                               const ServerConfig& config)
+    : impl_(std::make_unique<Impl>(tle_file, port, config))
 {}
 
 OrbitOpsServer::~OrbitOpsServer() = default;
@@ -1,4 +1,5 @@
 #include "history_recorder.hpp"
+#include "trace.hpp"
 #include <fstream>
 #include <algorithm>
 #include <cmath>
@@ -31,6 +32,7 @@ void HistoryRecorder::record_snapshot(
     double time_minutes
 ) {
     if (!recording_) return;
+    ORBITOPS_TRACE_SCOPE_ARG("history.record_snapshot", sys.count);
     
     std::lock_guard<std::mutex> lock(mutex_);
     
@@ -56,6 +58,7 @@ void HistoryRecorder::record_snapshot(
 
 void HistoryRecorder::record_conjunction(const ConjunctionEvent& event) {
     if (!recording_ || !config_.record_conjunctions) return;
+    ORBITOPS_TRACE_SCOPE("history.record_conjunction");
     
     std::lock_guard<std::mutex> lock(mutex_);
     conjunctions_.push_back(event);
@@ -0,0 +1,130 @@
+#include "metrics_endpoint.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <cstring>
+
+namespace orbitops {
+
+namespace {
+    constexpr int POLL_INTERVAL_MS = 200;      // Stop-flag check period
+    constexpr size_t MAX_REQUEST_BYTES = 8192;
+
+    void send_all(int fd, const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) return;
+            sent += static_cast<size_t>(n);
+        }
+    }
+}
+
+MetricsEndpoint::MetricsEndpoint(uint16_t port, Render render)
+    : port_(port) {
+    add_route("/metrics", "text/plain; version=0.0.4; charset=utf-8", std::move(render));
+}
+
+void MetricsEndpoint::add_route(const std::string& path, const std::string& content_type, Render render) {
+    routes_.push_back({path, content_type, std::move(render)});
+}
+
+MetricsEndpoint::~MetricsEndpoint() {
+    stop();
+}
+
+bool MetricsEndpoint::start() {
+    if (running_) return true;
+
+    // Close-on-exec so spawned shard workers do not inherit it
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) return false;
+
+    int reuse = 1;
+    ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port_);
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        ::listen(listen_fd_, 8) < 0) {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    socklen_t len = sizeof(addr);
+    if (::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len) == 0) {
+        port_ = ntohs(addr.sin_port);
+    }
+
+    running_ = true;
+    thread_ = std::thread([this] { serve(); });
+    return true;
+}
+
+void MetricsEndpoint::stop() {
+    running_ = false;
+    if (thread_.joinable()) thread_.join();
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+    }
+}
+
+void MetricsEndpoint::serve() {
+    while (running_) {
+        pollfd pfd{listen_fd_, POLLIN, 0};
+        if (::poll(&pfd, 1, POLL_INTERVAL_MS) <= 0) continue;
+
+        int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) continue;
+
+        // A stalled client must not hold up the next scrape for long
+        timeval timeout{1, 0};
+        ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        handle(fd);
+        ::close(fd);
+    }
+}
+
+void MetricsEndpoint::handle(int fd) {
+    // Read up to the end of the request headers
+    std::string request;
+    char buf[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < MAX_REQUEST_BYTES) {
+        ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+        if (n <= 0) break;
+        request.append(buf, static_cast<size_t>(n));
+    }
+
+    // Request line: GET <path>[?query] HTTP/1.x ("/" is the metrics page)
+    const Route* route = nullptr;
+    if (request.rfind("GET ", 0) == 0) {
+        size_t end = request.find_first_of(" ?\r\n", 4);
+        std::string path = request.substr(4, end == std::string::npos ? std::string::npos : end - 4);
+        if (path == "/") path = "/metrics";
+        for (const auto& candidate : routes_) {
+            if (candidate.path == path) route = &candidate;
+        }
+    }
+    if (route == nullptr) {
+        send_all(fd, "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n");
+        return;
+    }
+
+    std::string body = route->render();
+    std::string response = "HTTP/1.1 200 OK\r\n"
+                           "Content-Type: " + route->content_type + "\r\n"
+                           "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                           "Connection: close\r\n\r\n";
+    response += body;
+    send_all(fd, response);
+}
+
+} // namespace orbitops
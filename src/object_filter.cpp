@@ -0,0 +1,182 @@
+#include "object_filter.hpp"
+#include <cmath>
+#include <algorithm>
+
+namespace orbitops {
+
+namespace {
+    constexpr double EARTH_RADIUS = 6371.0;   // km (matches debris altitude convention)
+    constexpr double DEG2RAD = M_PI / 180.0;
+    constexpr double TWOPI = 2.0 * M_PI;
+
+    // FNV-1a over raw bytes
+    inline uint64_t fnv1a(uint64_t h, const void* data, size_t len) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < len; ++i) {
+            h ^= bytes[i];
+            h *= 0x100000001B3ULL;
+        }
+        return h;
+    }
+}
+
+bool ObjectFilter::is_pass_through() const {
+    constexpr double inf = std::numeric_limits<double>::infinity();
+    return ids.empty() &&
+           min_altitude_km == -inf && max_altitude_km == inf &&
+           min_inclination_deg == -inf && max_inclination_deg == inf &&
+           min_orbit_altitude_km == -inf && max_orbit_altitude_km == inf &&
+           class_mask == 0 && !has_geo_box && frustum.empty();
+}
+
+uint64_t ObjectFilter::hash() const {
+    uint64_t h = 0xCBF29CE484222325ULL;
+    h = fnv1a(h, ids.data(), ids.size() * sizeof(int));
+    const double bands[] = {
+        min_altitude_km, max_altitude_km, min_inclination_deg, max_inclination_deg,
+        min_orbit_altitude_km, max_orbit_altitude_km,
+        has_geo_box ? min_lat_deg : 0.0, has_geo_box ? max_lat_deg : 0.0,
+        has_geo_box ? min_lon_deg : 0.0, has_geo_box ? max_lon_deg : 0.0
+    };
+    h = fnv1a(h, bands, sizeof(bands));
+    h = fnv1a(h, &class_mask, sizeof(class_mask));
+    h = fnv1a(h, &has_geo_box, sizeof(has_geo_box));
+    h = fnv1a(h, frustum.data(), frustum.size() * sizeof(HalfSpace));
+    return h;
+}
+
+void evaluate_filter_mask(
+    const SatelliteSystem& sys,
+    const ObjectFilter& filter,
+    double gmst_rad,
+    uint8_t* mask,
+    const OrbitIntervalIndex* bands
+) {
+    const size_t n = sys.count;
+    const double* __restrict x = sys.x;
+    const double* __restrict y = sys.y;
+    const double* __restrict z = sys.z;
+    const double* __restrict incl = sys.incl;
+    const uint8_t* __restrict cls = sys.object_class.data();
+
+    // Altitude band as squared radius band (no sqrt in the hot loop)
+    const double r_min = std::max(0.0, EARTH_RADIUS + filter.min_altitude_km);
+    const double r_max = EARTH_RADIUS + filter.max_altitude_km;
+    const double r_min_sq = r_min * r_min;
+    const double r_max_sq = r_max < 0.0 ? -1.0 : r_max * r_max;
+    const double incl_min = filter.min_inclination_deg * DEG2RAD;
+    const double incl_max = filter.max_inclination_deg * DEG2RAD;
+    const uint8_t class_mask = filter.class_mask ? filter.class_mask : 0xFF;
+
+    // Pass 1: band and class predicates (branch-free, vectorizable)
+    #pragma omp parallel for simd schedule(static)
+    for (size_t i = 0; i < n; ++i) {
+        const double r_sq = x[i] * x[i] + y[i] * y[i] + z[i] * z[i];
+        mask[i] = static_cast<uint8_t>(
+            (r_sq >= r_min_sq) & (r_sq <= r_max_sq) &
+            (incl[i] >= incl_min) & (incl[i] <= incl_max) &
+            ((cls[i] & class_mask) != 0)
+        );
+    }
+
+    // Pass 1b: orbit crossing band (interval index, or perigee/apogee from the elements)
+    constexpr double inf = std::numeric_limits<double>::infinity();
+    if (filter.min_orbit_altitude_km != -inf || filter.max_orbit_altitude_km != inf) {
+        const double lo = EARTH_RADIUS + filter.min_orbit_altitude_km;
+        const double hi = EARTH_RADIUS + filter.max_orbit_altitude_km;
+        if (bands && bands->count() == n) {
+            bands->and_mask(lo, hi, mask);
+        } else {
+            const double* __restrict a = sys.a0;
+            const double* __restrict e = sys.ecc;
+
+            #pragma omp parallel for simd schedule(static)
+            for (size_t i = 0; i < n; ++i) {
+                mask[i] &= static_cast<uint8_t>((a[i] * (1.0 - e[i]) <= hi) & (a[i] * (1.0 + e[i]) >= lo));
+            }
+        }
+    }
+
+    // Pass 2: geographic box (geocentric latitude via z/r, longitude via GMST)
+    if (filter.has_geo_box) {
+        const double sin_lat_min = std::sin(filter.min_lat_deg * DEG2RAD);
+        const double sin_lat_max = std::sin(filter.max_lat_deg * DEG2RAD);
+        const double lon_min = filter.min_lon_deg * DEG2RAD;
+        const double lon_max = filter.max_lon_deg * DEG2RAD;
+        const bool wraps = lon_min > lon_max;
+
+        #pragma omp parallel for simd schedule(static)
+        for (size_t i = 0; i < n; ++i) {
+            const double r = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+            const double sin_lat = z[i] / r;
+            double lon = std::atan2(y[i], x[i]) - gmst_rad;
+            lon -= TWOPI * std::floor((lon + M_PI) / TWOPI);   // [-pi, pi)
+
+            const bool in_lon = wraps ? ((lon >= lon_min) | (lon <= lon_max))
+                                      : ((lon >= lon_min) & (lon <= lon_max));
+            mask[i] &= static_cast<uint8_t>(
+                (sin_lat >= sin_lat_min) & (sin_lat <= sin_lat_max) & in_lon
+            );
+        }
+    }
+
+    // Pass 3: frustum culling, one half-space per pass
+    for (const auto& plane : filter.frustum) {
+        const double nx = plane.nx, ny = plane.ny, nz = plane.nz, d = plane.d;
+
+        #pragma omp parallel for simd schedule(static)
+        for (size_t i = 0; i < n; ++i) {
+            mask[i] &= static_cast<uint8_t>(nx * x[i] + ny * y[i] + nz * z[i] + d >= 0.0);
+        }
+    }
+
+    // Pass 4: explicit ID set (scatter, then AND)
+    if (!filter.ids.empty()) {
+        std::vector<uint8_t> selected(n, 0);
+        for (int id : filter.ids) {
+            if (id >= 0 && static_cast<size_t>(id) < n) {
+                selected[id] = 1;
+            }
+        }
+
+        #pragma omp parallel for simd schedule(static)
+        for (size_t i = 0; i < n; ++i) {
+            mask[i] &= selected[i];
+        }
+    }
+}
+
+std::vector<uint32_t> select_filtered(
+    const SatelliteSystem& sys,
+    const ObjectFilter& filter,
+    double gmst_rad,
+    const OrbitIntervalIndex* bands
+) {
+    std::vector<uint8_t> mask(sys.count);
+    evaluate_filter_mask(sys, filter, gmst_rad, mask.data(), bands);
+
+    size_t selected = 0;
+    for (size_t i = 0; i < sys.count; ++i) {
+        selected += mask[i];
+    }
+
+    std::vector<uint32_t> indices;
+    indices.reserve(selected);
+    for (size_t i = 0; i < sys.count; ++i) {
+        if (mask[i]) indices.push_back(static_cast<uint32_t>(i));
+    }
+    return indices;
+}
+
+double gmst_from_unix(double unix_seconds) {
+    // IAU 1982 GMST, Julian centuries from J2000
+    const double jd = unix_seconds / 86400.0 + 2440587.5;
+    const double t = (jd - 2451545.0) / 36525.0;
+    double gmst_sec = 67310.54841 + (876600.0 * 3600.0 + 8640184.812866) * t +
+                      0.093104 * t * t - 6.2e-6 * t * t * t;
+    double gmst = std::fmod(gmst_sec * (TWOPI / 86400.0), TWOPI);
+    if (gmst < 0) gmst += TWOPI;
+    return gmst;
+}
+
+} // namespace orbitops
@@ -0,0 +1,135 @@
+#include "orbit_interval_index.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace orbitops {
+
+OrbitIntervalIndex::OrbitIntervalIndex(const OrbitIntervalConfig& config)
+    : config_(config)
+{
+    const double span = std::max(config_.max_radius_km - config_.min_radius_km, 0.0);
+    shells_ = config_.shell_km > 0.0 ? std::max<size_t>(static_cast<size_t>(std::ceil(span / config_.shell_km)), 1) : 1;
+}
+
+size_t OrbitIntervalIndex::shell_of(double radius_km) const {
+    const double f = (radius_km - config_.min_radius_km) / config_.shell_km;
+    if (!(f > 0.0)) return 0;
+    return std::min(static_cast<size_t>(f), shells_ - 1);
+}
+
+void OrbitIntervalIndex::mark(uint32_t i, bool set) {
+    const size_t first = shell_of(perigee_[i]);
+    const size_t last = shell_of(apogee_[i]);
+    const size_t w = i / 64;
+    const uint64_t bit = 1ULL << (i % 64);
+    for (size_t s = first; s <= last; ++s) {
+        uint64_t& word = bits_[s * words_ + w];
+        word = set ? (word | bit) : (word & ~bit);
+    }
+}
+
+void OrbitIntervalIndex::build(const SatelliteSystem& sys) {
+    ORBITOPS_TRACE_SCOPE_ARG("orbit_index.build", sys.count);
+    const size_t n = sys.count;
+    perigee_.resize(n);
+    apogee_.resize(n);
+    words_ = (n + 63) / 64;
+    bits_.assign(shells_ * words_, 0);
+
+    #pragma omp parallel for simd schedule(static)
+    for (size_t i = 0; i < n; ++i) {
+        perigee_[i] = sys.a0[i] * (1.0 - sys.ecc[i]);
+        apogee_[i] = sys.a0[i] * (1.0 + sys.ecc[i]);
+    }
+
+    // Each thread owns whole words, so bitmap writes never race
+    #pragma omp parallel for schedule(static)
+    for (size_t w = 0; w < words_; ++w) {
+        const size_t end = std::min(n, (w + 1) * 64);
+        for (size_t i = w * 64; i < end; ++i) {
+            mark(static_cast<uint32_t>(i), true);
+        }
+    }
+}
+
+size_t OrbitIntervalIndex::sync(const SatelliteSystem& sys) {
+    if (sys.count != count()) {
+        build(sys);
+        return sys.count;
+    }
+
+    // Detect changed ranges in parallel; re-mark them per word as in build()
+    std::vector<uint8_t> changed(sys.count, 0);
+    #pragma omp parallel for simd schedule(static)
+    for (size_t i = 0; i < sys.count; ++i) {
+        const double perigee = sys.a0[i] * (1.0 - sys.ecc[i]);
+        const double apogee = sys.a0[i] * (1.0 + sys.ecc[i]);
+        changed[i] = static_cast<uint8_t>((perigee != perigee_[i]) | (apogee != apogee_[i]));
+    }
+
+    size_t updated = 0;
+    #pragma omp parallel for schedule(static) reduction(+:updated)
+    for (size_t w = 0; w < words_; ++w) {
+        const size_t end = std::min(sys.count, (w + 1) * 64);
+        for (size_t i = w * 64; i < end; ++i) {
+            if (!changed[i]) continue;
+            const auto id = static_cast<uint32_t>(i);
+            mark(id, false);
+            perigee_[i] = sys.a0[i] * (1.0 - sys.ecc[i]);
+            apogee_[i] = sys.a0[i] * (1.0 + sys.ecc[i]);
+            mark(id, true);
+            ++updated;
+        }
+    }
+    return updated;
+}
+
+uint64_t OrbitIntervalIndex::candidates(size_t first_shell, size_t last_shell, size_t w) const {
+    uint64_t acc = 0;
+    for (size_t s = first_shell; s <= last_shell; ++s) {
+        acc |= bits_[s * words_ + w];
+    }
+    return acc;
+}
+
+std::vector<uint32_t> OrbitIntervalIndex::query(double min_radius_km, double max_radius_km) const {
+    std::vector<uint32_t> result;
+    if (!(min_radius_km <= max_radius_km) || count() == 0) return result;
+
+    const size_t first = shell_of(min_radius_km);
+    const size_t last = shell_of(max_radius_km);
+    for (size_t w = 0; w < words_; ++w) {
+        for (uint64_t acc = candidates(first, last, w); acc != 0; acc &= acc - 1) {
+            const auto i = static_cast<uint32_t>(w * 64 + std::countr_zero(acc));
+            if (perigee_[i] <= max_radius_km && apogee_[i] >= min_radius_km) {
+                result.push_back(i);
+            }
+        }
+    }
+    return result;
+}
+
+void OrbitIntervalIndex::and_mask(double min_radius_km, double max_radius_km, uint8_t* mask) const {
+    const size_t n = count();
+    if (!(min_radius_km <= max_radius_km)) {
+        std::fill(mask, mask + n, 0);
+        return;
+    }
+
+    const size_t first = shell_of(min_radius_km);
+    const size_t last = shell_of(max_radius_km);
+
+    #pragma omp parallel for schedule(static)
+    for (size_t w = 0; w < words_; ++w) {
+        const uint64_t acc = candidates(first, last, w);
+        const size_t end = std::min(n, (w + 1) * 64);
+        for (size_t i = w * 64; i < end; ++i) {
+            mask[i] &= static_cast<uint8_t>(((acc >> (i % 64)) & 1) &
+                                            (perigee_[i] <= max_radius_km) & (apogee_[i] >= min_radius_km));
+        }
+    }
+}
+
+} // namespace orbitops
@@ -0,0 +1,83 @@
+#include "orbit_path.hpp"
+#include "sgp4_optimized.hpp"
+#include <cmath>
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace orbitops {
+
+namespace {
+    constexpr double MU = 398600.4418;   // km^3/s^2
+    constexpr double TWOPI = 2.0 * M_PI;
+    constexpr double DEG2RAD = M_PI / 180.0;
+
+    // Largest step (seconds) keeping the segment within tolerance of the arc.
+    // Path curvature under two-body gravity is k = |r x v| * mu / (r^3 v^3);
+    // a chord of length s deviates from the arc by about k s^2 / 8.
+    inline double adaptive_step_s(const Vec3& r, const Vec3& v, const OrbitPathSampling& sampling,
+                                  double min_step_s) {
+        const double r_mag = r.magnitude();
+        const double v_mag = v.magnitude();
+        if (r_mag <= 0.0 || v_mag <= 0.0) return sampling.max_step_s;
+
+        const double hx = r.y * v.z - r.z * v.y;
+        const double hy = r.z * v.x - r.x * v.z;
+        const double hz = r.x * v.y - r.y * v.x;
+        const double h = std::sqrt(hx*hx + hy*hy + hz*hz);
+        const double curvature = h * MU / (r_mag * r_mag * r_mag * v_mag * v_mag * v_mag);
+        if (curvature <= 0.0) return sampling.max_step_s;
+
+        const double s_chord = std::sqrt(8.0 * sampling.tolerance_km / curvature);
+        const double s_turn = sampling.max_turn_deg * DEG2RAD / curvature;
+        const double step = std::min(s_chord, s_turn) / v_mag;
+        return std::clamp(step, min_step_s, std::max(min_step_s, sampling.max_step_s));
+    }
+}
+
+std::vector<SampledPath> sample_orbit_paths(
+    const SatelliteSystem& sys,
+    const std::vector<uint32_t>& indices,
+    double start_minutes,
+    double end_minutes,
+    const OrbitPathSampling& sampling,
+    const CancellationToken* cancel
+) {
+    std::vector<SampledPath> paths(indices.size());
+    const size_t max_samples = std::max<size_t>(sampling.max_samples, 2);
+
+    // Paths differ in length (eccentric orbits take more samples)
+    #pragma omp parallel for schedule(dynamic, 4)
+    for (size_t p = 0; p < indices.size(); ++p) {
+        SampledPath& path = paths[p];
+        path.index = indices[p];
+        if (path.index >= sys.count || is_cancelled(cancel)) continue;
+
+        double end = end_minutes;
+        if (end <= start_minutes) {
+            end = start_minutes + TWOPI / sys.n0[path.index];  // One revolution
+        }
+        const double duration_s = (end - start_minutes) * 60.0;
+        const double min_step_s = std::max(sampling.min_step_s,
+                                           duration_s / static_cast<double>(max_samples - 1));
+
+        Vec3 r, v;
+        double t = start_minutes;
+        while (true) {
+            propagate_state(sys, path.index, t, r, v);
+            path.times_minutes.push_back(t);
+            path.x.push_back(r.x);
+            path.y.push_back(r.y);
+            path.z.push_back(r.z);
+
+            if (t >= end) break;
+            t = std::min(end, t + adaptive_step_s(r, v, sampling, min_step_s) / 60.0);
+        }
+    }
+
+    return paths;
+}
+
+} // namespace orbitops
@@ -0,0 +1,164 @@
+#include "reentry_predictor.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+namespace orbitops {
+
+namespace {
+    constexpr double RE = 6378.137;              // km (propagator radius, drag perigee heights)
+    constexpr double DAYS_PER_YEAR = 365.25;
+    constexpr double MIN_FLUX_SCALE = 0.3;       // Keeps perturbed F10.7 physical
+
+    // splitmix64 finaliser: decorrelates the (seed, object, member) streams
+    uint64_t mix_seed(uint64_t x) {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    // Days until the perigee drops below the cutoff, or -1 if it survives
+    double member_reentry_days(double a, double e, double ballistic, double flux_scale,
+                               const ReentryConfig& config) {
+        const double cutoff = RE + config.cutoff_altitude_km;
+        const double step = config.step_days > 0.0 ? config.step_days : config.horizon_days;
+        double t = 0.0;
+        while (t < config.horizon_days) {
+            const double dt = std::min(step, config.horizon_days - t);
+            const double f107 = config.solar.f107((t + 0.5 * dt) / DAYS_PER_YEAR) * flux_scale;
+            const double used = integrate_drag_decay(a, e, ballistic, f107, dt, cutoff,
+                                                     config.max_decay_per_scale_height);
+            if (a * (1.0 - e) < cutoff) return t + used;
+            if (used <= 0.0) break;
+            t += used;
+        }
+        return -1.0;
+    }
+}
+
+ReentryReport predict_reentries(
+    const SatelliteSystem& sys,
+    const ReentryConfig& config,
+    const OrbitIntervalIndex* bands,
+    const CancellationToken* cancel
+) {
+    ORBITOPS_TRACE_SCOPE_ARG("reentry.predict", sys.count);
+    ReentryReport report;
+
+    if (!(config.horizon_days > 0.0) || !(config.max_decay_per_scale_height > 0.0)) {
+        report.error_message = "horizon_days and max_decay_per_scale_height must be positive";
+        return report;
+    }
+    if (!(config.window_low >= 0.0 && config.window_low <= config.window_high && config.window_high <= 1.0)) {
+        report.error_message = "window quantiles must satisfy 0 <= window_low <= window_high <= 1";
+        return report;
+    }
+
+    // Candidates: perigee radius below the threshold
+    const double max_perigee = RE + config.max_perigee_altitude_km;
+    std::vector<uint32_t> candidates;
+    if (bands && bands->count() == sys.count) {
+        candidates = bands->query(0.0, max_perigee);
+    } else {
+        for (size_t i = 0; i < sys.count; ++i) {
+            if (sys.a0[i] * (1.0 - sys.ecc[i]) <= max_perigee) {
+                candidates.push_back(static_cast<uint32_t>(i));
+            }
+        }
+    }
+    report.candidates = candidates.size();
+
+    // One flat batch over (candidate, member) pairs so small candidate sets
+    // still fill every thread
+    const size_t members = std::max<size_t>(config.ensemble_size, 1);
+    const size_t pairs = candidates.size() * members;
+    std::vector<double> days(pairs, -1.0);
+
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (size_t p = 0; p < pairs; ++p) {
+        if (is_cancelled(cancel)) continue;
+        const uint32_t i = candidates[p / members];
+        const size_t k = p % members;
+
+        double ballistic = ballistic_coefficient_from_bstar(sys.bstar[i]);
+        double flux_scale = 1.0;
+        if (k > 0) {
+            std::mt19937_64 rng(mix_seed(config.seed ^ mix_seed((static_cast<uint64_t>(i) << 16) ^ k)));
+            std::normal_distribution<double> normal(0.0, 1.0);
+            ballistic *= std::exp(config.ballistic_sigma * normal(rng));
+            flux_scale = std::max(MIN_FLUX_SCALE, 1.0 + config.f107_sigma * normal(rng));
+        }
+        days[p] = member_reentry_days(sys.a0[i], sys.ecc[i], ballistic, flux_scale, config);
+    }
+
+    if (is_cancelled(cancel)) {
+        report.error_message = "cancelled";
+        return report;
+    }
+
+    report.predictions.resize(candidates.size());
+    const double inf = std::numeric_limits<double>::infinity();
+    const size_t low_rank = static_cast<size_t>(std::floor(config.window_low * static_cast<double>(members - 1)));
+    const size_t high_rank = static_cast<size_t>(std::ceil(config.window_high * static_cast<double>(members - 1)));
+
+    #pragma omp parallel for schedule(static)
+    for (size_t c = 0; c < candidates.size(); ++c) {
+        const uint32_t i = candidates[c];
+        const double* member_days = days.data() + c * members;
+        ReentryPrediction& pred = report.predictions[c];
+
+        pred.index = i;
+        pred.catalog_number = i < sys.catalog_numbers.size() ? sys.catalog_numbers[i] : 0;
+        pred.perigee_altitude_km = sys.a0[i] * (1.0 - sys.ecc[i]) - RE;
+        pred.reenters = member_days[0] >= 0.0;
+        pred.nominal_days = member_days[0];
+
+        // Survivors sort last, so the quantiles stay meaningful when only
+        // part of the ensemble reenters within the horizon
+        std::vector<double> sorted(members);
+        double sum = 0.0;
+        double sum_sq = 0.0;
+        for (size_t k = 0; k < members; ++k) {
+            const double d = member_days[k];
+            sorted[k] = d >= 0.0 ? d : inf;
+            if (d >= 0.0) {
+                ++pred.members_reentered;
+                sum += d;
+                sum_sq += d * d;
+            }
+        }
+        if (pred.members_reentered > 0) {
+            const double n = static_cast<double>(pred.members_reentered);
+            pred.mean_days = sum / n;
+            pred.sigma_days = std::sqrt(std::max(0.0, sum_sq / n - pred.mean_days * pred.mean_days));
+        }
+
+        std::sort(sorted.begin(), sorted.end());
+        pred.window_start_days = std::min(sorted[low_rank], config.horizon_days);
+        pred.window_end_days = std::min(sorted[high_rank], config.horizon_days);
+        pred.window_complete = sorted[high_rank] != inf;
+    }
+
+    report.success = true;
+    return report;
+}
+
+std::vector<int> decayed_catalog_numbers(
+    const ReentryReport& report,
+    const std::vector<TLE>& tles,
+    double now_jd
+) {
+    std::vector<int> decayed;
+    for (const auto& pred : report.predictions) {
+        if (!pred.window_complete || pred.index >= tles.size()) continue;
+        if (tles[pred.index].epoch_jd + pred.window_end_days < now_jd) {
+            decayed.push_back(pred.catalog_number);
+        }
+    }
+    return decayed;
+}
+
+} // namespace orbitops
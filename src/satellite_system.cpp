@@ -1,5 +1,7 @@
 #include "satellite_system.hpp"
 #include <cmath>
+#include <cctype>
+#include <algorithm>
 
 namespace orbitops {
 
@@ -33,10 +35,54 @@ SatelliteSystem create_satellite_system(const std::vector<TLE>& tles) {
         // Cold data
         sys.catalog_numbers[i] = tle.catalog_number;
         sys.names[i] = tle.name;
+        sys.object_class[i] = classify_object(tle);
     }
     
     return sys;
 }
 
+SatelliteSystem extend_satellite_system(const SatelliteSystem& sys, size_t extra) {
+    SatelliteSystem grown;
+    grown.allocate(sys.count + extra);
+    
+    const size_t bytes = sys.count * sizeof(double);
+    double* const* src[] = {&sys.x, &sys.y, &sys.z, &sys.vx, &sys.vy, &sys.vz,
+                            &sys.incl, &sys.raan0, &sys.ecc, &sys.argp0, &sys.M0,
+                            &sys.n0, &sys.a0, &sys.bstar};
+    double** dst[] = {&grown.x, &grown.y, &grown.z, &grown.vx, &grown.vy, &grown.vz,
+                      &grown.incl, &grown.raan0, &grown.ecc, &grown.argp0, &grown.M0,
+                      &grown.n0, &grown.a0, &grown.bstar};
+    for (size_t k = 0; k < sizeof(src) / sizeof(src[0]); ++k) {
+        if (bytes > 0) std::memcpy(*dst[k], *src[k], bytes);
+        std::memset(*dst[k] + sys.count, 0, extra * sizeof(double));
+    }
+    
+    std::copy(sys.catalog_numbers.begin(), sys.catalog_numbers.end(), grown.catalog_numbers.begin());
+    std::copy(sys.names.begin(), sys.names.end(), grown.names.begin());
+    std::copy(sys.object_class.begin(), sys.object_class.end(), grown.object_class.begin());
+    return grown;
+}
+
+uint8_t classify_object(const TLE& tle) {
+    std::string upper_name = tle.name;
+    for (auto& c : upper_name) {
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    
+    if (upper_name.find("R/B") != std::string::npos ||
+        upper_name.find("ROCKET") != std::string::npos) {
+        return OBJECT_ROCKET_BODY;
+    }
+    
+    static const char* const DEBRIS_KEYWORDS[] = {"DEB", "FRAG", "COOLANT", "TANK"};
+    for (const char* keyword : DEBRIS_KEYWORDS) {
+        if (upper_name.find(keyword) != std::string::npos) {
+            return OBJECT_DEBRIS;
+        }
+    }
+    
+    return OBJECT_PAYLOAD;
+}
+
 } // namespace orbitops
 
@@ -0,0 +1,186 @@
+#include "screening_horizon.hpp"
+#include "sgp4_optimized.hpp"
+#include <cmath>
+#include <algorithm>
+#include <unordered_map>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace orbitops {
+
+namespace {
+    // Re-screen everything instead when more than this fraction changed: a
+    // full slice screen is one grid pass, while each changed object costs a
+    // neighbour probe per slice on top of the same propagation
+    constexpr double FULL_RESCREEN_FRACTION = 0.01;
+
+    inline bool same_elements(const SatelliteSystem& a, size_t i, const SatelliteSystem& b, size_t j) {
+        return a.incl[i] == b.incl[j] && a.raan0[i] == b.raan0[j] && a.ecc[i] == b.ecc[j] &&
+               a.argp0[i] == b.argp0[j] && a.M0[i] == b.M0[j] && a.n0[i] == b.n0[j] &&
+               a.bstar[i] == b.bstar[j];
+    }
+}
+
+ScreeningHorizon::ScreeningHorizon(ConjunctionEventTable& table, const MonitorConfig& config)
+    : table_(table)
+    , config_(config)
+    , step_minutes_(config.step_seconds / 60.0)
+    , grid_(config.threshold_km * 2)  // Cell size = 2x threshold
+    , tracker_(config)
+{}
+
+void ScreeningHorizon::reset(SatelliteSystem sys, double now_minutes) {
+    sys_ = std::move(sys);
+    tracker_ = EncounterTracker(config_);
+    table_.clear();
+    origin_minutes_ = now_minutes;
+    screened_until_ = now_minutes;
+    screened_any_ = false;
+}
+
+double ScreeningHorizon::slice_at_or_after(double t_minutes) const {
+    double k = std::ceil((t_minutes - origin_minutes_) / step_minutes_ - 1e-9);
+    return origin_minutes_ + std::max(k, 0.0) * step_minutes_;
+}
+
+bool ScreeningHorizon::screen_slice(double t_minutes, EncounterTracker& tracker,
+                                    const CancellationToken* cancel) {
+    propagate_all_optimized(sys_, t_minutes, cancel);
+    grid_.build(sys_);
+    auto pairs = grid_.find_close_pairs(sys_, config_.threshold_km, cancel);
+    if (is_cancelled(cancel)) return false;
+
+    tracker.observe(sys_, pairs, t_minutes);
+    return true;
+}
+
+size_t ScreeningHorizon::advance(double now_minutes, size_t max_slices, const CancellationToken* cancel) {
+    table_.expire_before(now_minutes);
+    if (sys_.count == 0) return 0;
+
+    // Slices that slipped into the past (e.g. after a stall) are not screened
+    double next = screened_any_ ? screened_until_ + step_minutes_ : slice_at_or_after(now_minutes);
+    next = std::max(next, slice_at_or_after(now_minutes));
+    const double target = now_minutes + config_.horizon_minutes;
+
+    size_t slices = 0;
+    for (double t = next; t <= target + 1e-9; t += step_minutes_) {
+        if (max_slices > 0 && slices >= max_slices) break;
+        if (!screen_slice(t, tracker_, cancel)) break;
+
+        screened_until_ = t;
+        screened_any_ = true;
+        slices++;
+    }
+
+    // Encounters not seen in the newest slice are complete
+    if (slices > 0) {
+        table_.add(tracker_.close_before(screened_until_));
+        stats_.slices_screened += slices;
+    }
+    return slices;
+}
+
+size_t ScreeningHorizon::update_catalog(SatelliteSystem sys, double now_minutes,
+                                        const CancellationToken* cancel) {
+    // Match objects across catalogs by catalog number
+    std::unordered_map<int, size_t> new_index;
+    new_index.reserve(sys.count);
+    for (size_t j = 0; j < sys.count; ++j) new_index.emplace(sys.catalog_numbers[j], j);
+
+    std::vector<int64_t> old_to_new(sys_.count, -1);
+    std::vector<uint8_t> changed(sys.count, 1);   // New objects start flagged
+    for (size_t i = 0; i < sys_.count; ++i) {
+        auto it = new_index.find(sys_.catalog_numbers[i]);
+        if (it == new_index.end()) continue;
+
+        size_t j = it->second;
+        old_to_new[i] = static_cast<int64_t>(j);
+        changed[j] = same_elements(sys_, i, sys, j) ? 0 : 1;
+    }
+
+    table_.remap(old_to_new);
+    tracker_.remap(old_to_new);
+    sys_ = std::move(sys);
+
+    size_t changed_count = static_cast<size_t>(std::count(changed.begin(), changed.end(), 1));
+    if (!screened_any_ || changed_count == 0) return 0;
+
+    const double from = slice_at_or_after(now_minutes);
+    if (static_cast<double>(changed_count) > FULL_RESCREEN_FRACTION * static_cast<double>(sys_.count)) {
+        rescreen_all(from, cancel);
+        stats_.full_rescreens++;
+        stats_.objects_rescreened += sys_.count;
+        return sys_.count;
+    }
+
+    rescreen_objects(changed, from, cancel);
+    stats_.objects_rescreened += changed_count;
+    return changed_count;
+}
+
+bool ScreeningHorizon::rescreen_all(double from_minutes, const CancellationToken* cancel) {
+    EncounterTracker tracker(config_);
+    for (double t = from_minutes; t <= screened_until_ + 1e-9; t += step_minutes_) {
+        if (!screen_slice(t, tracker, cancel)) return false;
+    }
+
+    // Events whose encounter is still open at the frontier are settled when
+    // it closes, not resolved now and re-reported as NEW later
+    auto closed = tracker.close_before(screened_until_);
+    const auto frontier = tracker.open_events();
+    tracker_ = std::move(tracker);
+    table_.apply(closed, from_minutes, screened_until_, nullptr, &frontier);
+    return true;
+}
+
+bool ScreeningHorizon::rescreen_objects(const std::vector<uint8_t>& changed, double from_minutes,
+                                        const CancellationToken* cancel) {
+    const double threshold = config_.threshold_km;
+
+    std::vector<uint32_t> movers;
+    for (size_t i = 0; i < sys_.count; ++i) {
+        if (changed[i]) movers.push_back(static_cast<uint32_t>(i));
+    }
+
+    // Each slice: one propagation and grid build, then a neighbour probe per
+    // changed object, so the work is not changed x catalog pair checks
+    std::vector<std::vector<Neighbor>> found(movers.size());
+    EncounterTracker tracker(config_);
+    for (double t = from_minutes; t <= screened_until_ + 1e-9; t += step_minutes_) {
+        propagate_all_optimized(sys_, t, cancel);
+        if (is_cancelled(cancel)) return false;
+        grid_.build(sys_);
+
+        #pragma omp parallel for schedule(dynamic, 16)
+        for (size_t k = 0; k < movers.size(); ++k) {
+            const uint32_t s = movers[k];
+            found[k] = grid_.query_radius(sys_, {sys_.x[s], sys_.y[s], sys_.z[s]}, threshold, s);
+        }
+
+        for (size_t k = 0; k < movers.size(); ++k) {
+            const uint32_t s = movers[k];
+            for (const Neighbor& neighbor : found[k]) {
+                const auto j = static_cast<uint32_t>(neighbor.index);
+                if (neighbor.distance_km >= threshold || (changed[j] && j < s)) continue;   // Changed pairs once
+                const double r[3] = {sys_.x[j] - sys_.x[s], sys_.y[j] - sys_.y[s], sys_.z[j] - sys_.z[s]};
+                const double v[3] = {sys_.vx[j] - sys_.vx[s], sys_.vy[j] - sys_.vy[s], sys_.vz[j] - sys_.vz[s]};
+                tracker.observe_pair(s, j, t, r, v);
+            }
+        }
+    }
+
+    // Replace the changed objects' events; encounters still open at the
+    // frontier continue in the main tracker, and their existing events are
+    // held until they close
+    tracker_.drop(changed);
+    auto closed = tracker.close_before(screened_until_);
+    const auto frontier = tracker.open_events();
+    tracker_.merge(std::move(tracker));
+    table_.apply(closed, from_minutes, screened_until_, &changed, &frontier);
+    return true;
+}
+
+} // namespace orbitops
@@ -15,6 +15,7 @@ void signal_handler(int signal) {
 int main(int argc, char* argv[]) {
     std::string tle_file = "data/tle/active.txt";
     uint16_t port = 50051;
+    orbitops::ServerConfig config;
     
     // Parse command line arguments
     for (int i = 1; i < argc; ++i) {
@@ -23,11 +24,35 @@ int main(int argc, char* argv[]) {
             tle_file = argv[++i];
         } else if (arg == "--port" && i + 1 < argc) {
             port = static_cast<uint16_t>(std::stoi(argv[++i]));
+        } else if (arg == "--frame-cache-mb" && i + 1 < argc) {
+            config.frame_cache_bytes = static_cast<size_t>(std::stoul(argv[++i])) * 1024 * 1024;
+        } else if (arg == "--stream-window" && i + 1 < argc) {
+            config.stream_window = static_cast<size_t>(std::stoul(argv[++i]));
+        } else if (arg == "--monitor-horizon-hours" && i + 1 < argc) {
+            config.monitor_horizon_hours = std::stod(argv[++i]);
+        } else if (arg == "--monitor-step" && i + 1 < argc) {
+            config.monitor_step_seconds = std::stod(argv[++i]);
+        } else if (arg == "--monitor-interval" && i + 1 < argc) {
+            config.monitor_interval_seconds = std::stod(argv[++i]);
+        } else if (arg == "--metrics-port" && i + 1 < argc) {
+            config.metrics_port = static_cast<uint16_t>(std::stoi(argv[++i]));
+        } else if (arg == "--slow-request-ms" && i + 1 < argc) {
+            config.slow_request_ms = std::stod(argv[++i]);
+        } else if (arg == "--flight-recorder-dir" && i + 1 < argc) {
+            config.flight_recorder_dir = argv[++i];
         } else if (arg == "--help") {
             std::cout << "Usage: orbitops_server [options]\n"
                       << "Options:\n"
                       << "  --tle <file>   TLE data file (default: data/tle/active.txt)\n"
                       << "  --port <port>  Server port (default: 50051)\n"
+                      << "  --frame-cache-mb <mb>  Encoded frame cache budget (default: 256)\n"
+                      << "  --stream-window <n>    Outstanding frames per stream (default: 4)\n"
+                      << "  --monitor-horizon-hours <h>  Alert look-ahead window (default: 168)\n"
+                      << "  --monitor-step <s>     Alert screening step in seconds (default: 30)\n"
+                      << "  --monitor-interval <s> Alert window advance period in seconds (default: 30)\n"
+                      << "  --metrics-port <port>  Prometheus /metrics and /trace on 127.0.0.1 (default: off)\n"
+                      << "  --slow-request-ms <ms> Dump requests slower than this (default: 1000)\n"
+                      << "  --flight-recorder-dir <dir>  Slow-request dump directory (default: flight_recorder)\n"
                       << "  --help         Show this help\n";
             return 0;
         }
@@ -43,7 +68,7 @@ int main(int argc, char* argv[]) {
               << "\n";
     
     try {
-        g_server = std::make_unique<orbitops::OrbitOpsServer>(tle_file, port);
+        g_server = std::make_unique<orbitops::OrbitOpsServer>(tle_file, port, config);
         g_server->run();
     } catch (const std::exception& e) {
         std::cerr << "[OrbitOps] Error: " << e.what() << std::endl;
@@ -1,5 +1,9 @@
 #include "sgp4_optimized.hpp"
+#include "trace.hpp"
 #include <cmath>
+#include <algorithm>
+#include <numeric>
+#include <limits>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -29,24 +33,19 @@ namespace {
         }
         return E;
     }
-}
 
-void propagate_all_optimized(SatelliteSystem& sys, double time_minutes) {
-    const size_t n = sys.count;
-    const double t = time_minutes;
-    
-    // Pre-compute constants
-    const double j2_factor = 1.5 * J2 * RE * RE;
-
-    #pragma omp parallel for schedule(static, 256)
-    for (size_t i = 0; i < n; ++i) {
-        // Prefetch next satellite's orbital elements
-        if (i + 4 < n) [[likely]] {
-            __builtin_prefetch(&sys.incl[i + 4], 0, 1);
-            __builtin_prefetch(&sys.ecc[i + 4], 0, 1);
-            __builtin_prefetch(&sys.n0[i + 4], 0, 1);
-        }
-        
+    // Objects per cancellation check (matches the static schedule chunk)
+    constexpr size_t PROPAGATION_CHUNK = 256;
+
+    // Propagate one object of the SoA to time t (minutes from epoch)
+    inline void propagate_one(
+        const SatelliteSystem& sys, size_t i, double t,
+        double& x, double& y, double& z,
+        double& vx, double& vy, double& vz
+    ) {
+        // Pre-computed constant
+        constexpr double j2_factor = 1.5 * J2 * RE * RE;
+
         // Load orbital elements into registers
         const double incl = sys.incl[i];
         const double raan0 = sys.raan0[i];
@@ -103,9 +102,9 @@ void propagate_all_optimized(SatelliteSystem& sys, double time_minutes) {
         const double cos_raan = std::cos(raan);
         const double sin_raan = std::sin(raan);
         
-        sys.x[i] = xp * cos_raan - yp * cosi * sin_raan;
-        sys.y[i] = xp * sin_raan + yp * cosi * cos_raan;
-        sys.z[i] = yp * sini;
+        x = xp * cos_raan - yp * cosi * sin_raan;
+        y = xp * sin_raan + yp * cosi * cos_raan;
+        z = yp * sini;
         
         // Velocity calculation
         const double h = std::sqrt(MU * p);
@@ -115,10 +114,201 @@ void propagate_all_optimized(SatelliteSystem& sys, double time_minutes) {
         const double vxp = r_dot * cos_u - rf_dot * sin_u;
         const double vyp = r_dot * sin_u + rf_dot * cos_u;
         
-        sys.vx[i] = vxp * cos_raan - vyp * cosi * sin_raan;
-        sys.vy[i] = vxp * sin_raan + vyp * cosi * cos_raan;
-        sys.vz[i] = vyp * sini;
+        vx = vxp * cos_raan - vyp * cosi * sin_raan;
+        vy = vxp * sin_raan + vyp * cosi * cos_raan;
+        vz = vyp * sini;
+    }
+}
+
+void propagate_all_optimized(SatelliteSystem& sys, double time_minutes,
+                             const CancellationToken* cancel) {
+    const size_t n = sys.count;
+    const double t = time_minutes;
+    const size_t chunks = (n + PROPAGATION_CHUNK - 1) / PROPAGATION_CHUNK;
+    ORBITOPS_TRACE_SCOPE_ARG("propagate_all", n);
+
+    // One cancellation check per chunk; cancelled chunks are skipped
+    #pragma omp parallel
+    {
+        ORBITOPS_TRACE_SCOPE("propagate_all.worker");
+
+        #pragma omp for schedule(static)
+        for (size_t c = 0; c < chunks; ++c) {
+            if (is_cancelled(cancel)) continue;
+
+            const size_t begin = c * PROPAGATION_CHUNK;
+            const size_t end = std::min(n, begin + PROPAGATION_CHUNK);
+
+            for (size_t i = begin; i < end; ++i) {
+                // Prefetch next satellite's orbital elements
+                if (i + 4 < n) [[likely]] {
+                    __builtin_prefetch(&sys.incl[i + 4], 0, 1);
+                    __builtin_prefetch(&sys.ecc[i + 4], 0, 1);
+                    __builtin_prefetch(&sys.n0[i + 4], 0, 1);
+                }
+
+                propagate_one(sys, i, t,
+                              sys.x[i], sys.y[i], sys.z[i],
+                              sys.vx[i], sys.vy[i], sys.vz[i]);
+            }
+        }
+    }
+}
+
+void propagate_state(const SatelliteSystem& sys, size_t index, double time_minutes,
+                     Vec3& position, Vec3& velocity) {
+    propagate_one(sys, index, time_minutes,
+                  position.x, position.y, position.z,
+                  velocity.x, velocity.y, velocity.z);
+}
+
+bool set_elements_from_state(SatelliteSystem& sys, size_t index, double time_minutes,
+                             const Vec3& position, const Vec3& velocity) {
+    const double rx = position.x, ry = position.y, rz = position.z;
+    const double vx = velocity.x, vy = velocity.y, vz = velocity.z;
+    const double r = std::sqrt(rx * rx + ry * ry + rz * rz);
+    const double v_sq = vx * vx + vy * vy + vz * vz;
+    const double rv = rx * vx + ry * vy + rz * vz;
+
+    // Angular momentum and orbit size
+    const double hx = ry * vz - rz * vy;
+    const double hy = rz * vx - rx * vz;
+    const double hz = rx * vy - ry * vx;
+    const double h = std::sqrt(hx * hx + hy * hy + hz * hz);
+    const double energy = 0.5 * v_sq - MU / r;
+    if (!(r > 0.0) || !(h > 0.0) || !(energy < 0.0)) return false;
+
+    const double a = -MU / (2.0 * energy);
+    const double p = h * h / MU;
+    const double e = std::sqrt(std::max(0.0, 1.0 - p / a));
+    if (e >= 1.0) return false;
+
+    // Plane orientation matching the propagator's rotation:
+    // P = (cos raan, sin raan, 0), Q = h_hat x P
+    const double incl = std::acos(std::clamp(hz / h, -1.0, 1.0));
+    const double raan = std::atan2(hx, -hy);
+    const double cos_raan = std::cos(raan);
+    const double sin_raan = std::sin(raan);
+    const double cosi = std::cos(incl);
+    const double sini = std::sin(incl);
+    const double r_p = rx * cos_raan + ry * sin_raan;
+    const double r_q = -rx * cosi * sin_raan + ry * cosi * cos_raan + rz * sini;
+    const double u = std::atan2(r_q, r_p);
+
+    // True, eccentric and mean anomaly
+    const double nu = std::atan2(std::sqrt(p / MU) * rv / r, p / r - 1.0);
+    const double E = std::atan2(std::sqrt(1.0 - e * e) * std::sin(nu), e + std::cos(nu));
+    const double M = E - e * std::sin(E);
+
+    // Back out the epoch angles with the same secular rates as propagate_one
+    const double n0 = std::sqrt(MU / (a * a * a)) * 60.0;   // rad/min
+    const double factor = 1.5 * J2 * RE * RE / (p * p);
+    const double raan_dot = -factor * n0 * cosi;
+    const double argp_dot = factor * n0 * (2.0 - 2.5 * sini * sini);
+    const double t = time_minutes;
+
+    auto wrap = [](double angle) {
+        angle = std::fmod(angle, TWOPI);
+        return angle < 0.0 ? angle + TWOPI : angle;
+    };
+
+    sys.incl[index] = incl;
+    sys.raan0[index] = wrap(raan - raan_dot * t);
+    sys.ecc[index] = e;
+    sys.argp0[index] = wrap(u - nu - argp_dot * t);
+    sys.M0[index] = wrap(M - n0 * t);
+    sys.n0[index] = n0;
+    sys.a0[index] = a;
+    return true;
+}
+
+bool propagate_states(const SatelliteSystem& sys, const std::vector<StateQuery>& queries,
+                      const StateArrays& out, const CancellationToken* cancel) {
+    const size_t n = queries.size();
+    auto before = [&queries](uint32_t a, uint32_t b) {
+        const StateQuery& qa = queries[a];
+        const StateQuery& qb = queries[b];
+        return qa.index != qb.index ? qa.index < qb.index : qa.time_minutes < qb.time_minutes;
+    };
+
+    // Evaluation order grouped by (object, time); clients usually send
+    // grouped batches, so skip the sort when already in order
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0u);
+    if (!std::is_sorted(order.begin(), order.end(), before)) {
+        std::sort(order.begin(), order.end(), before);
     }
+
+    const size_t chunks = (n + PROPAGATION_CHUNK - 1) / PROPAGATION_CHUNK;
+    bool cancelled = false;
+
+    #pragma omp parallel for schedule(static) reduction(||:cancelled)
+    for (size_t c = 0; c < chunks; ++c) {
+        if (is_cancelled(cancel)) {
+            cancelled = true;
+            continue;
+        }
+
+        const size_t begin = c * PROPAGATION_CHUNK;
+        const size_t end = std::min(n, begin + PROPAGATION_CHUNK);
+
+        for (size_t k = begin; k < end; ++k) {
+            const uint32_t q = order[k];
+            const StateQuery& query = queries[q];
+
+            if (query.index >= sys.count) [[unlikely]] {
+                constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+                out.x[q] = out.y[q] = out.z[q] = nan;
+                out.vx[q] = out.vy[q] = out.vz[q] = nan;
+                continue;
+            }
+
+            // Repeated pair within the chunk: copy the previous result
+            if (k > begin) {
+                const uint32_t p = order[k - 1];
+                if (queries[p].index == query.index && queries[p].time_minutes == query.time_minutes) {
+                    out.x[q] = out.x[p]; out.y[q] = out.y[p]; out.z[q] = out.z[p];
+                    out.vx[q] = out.vx[p]; out.vy[q] = out.vy[p]; out.vz[q] = out.vz[p];
+                    continue;
+                }
+            }
+
+            propagate_one(sys, query.index, query.time_minutes,
+                          out.x[q], out.y[q], out.z[q],
+                          out.vx[q], out.vy[q], out.vz[q]);
+        }
+    }
+
+    return !cancelled;
+}
+
+bool propagate_positions_f32(const SatelliteSystem& sys, const uint32_t* indices, size_t n,
+                             double time_minutes, double scale, float* xyz,
+                             const CancellationToken* cancel) {
+    ORBITOPS_TRACE_SCOPE_ARG("propagate_positions_f32", n);
+    const size_t chunks = (n + PROPAGATION_CHUNK - 1) / PROPAGATION_CHUNK;
+    bool cancelled = false;
+
+    #pragma omp parallel for schedule(static) reduction(||:cancelled)
+    for (size_t c = 0; c < chunks; ++c) {
+        if (is_cancelled(cancel)) {
+            cancelled = true;
+            continue;
+        }
+
+        const size_t begin = c * PROPAGATION_CHUNK;
+        const size_t end = std::min(n, begin + PROPAGATION_CHUNK);
+
+        for (size_t k = begin; k < end; ++k) {
+            double x, y, z, vx, vy, vz;
+            propagate_one(sys, indices[k], time_minutes, x, y, z, vx, vy, vz);
+            xyz[3 * k] = static_cast<float>(x * scale);
+            xyz[3 * k + 1] = static_cast<float>(y * scale);
+            xyz[3 * k + 2] = static_cast<float>(z * scale);
+        }
+    }
+
+    return !cancelled;
 }
 
 } // namespace orbitops
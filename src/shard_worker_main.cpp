@@ -0,0 +1,26 @@
+#include "sharded_screening.hpp"
+#include <iostream>
+#include <string>
+
+// Worker process for screen_sharded(); started by the coordinator with the
+// inherited socket and shared catalog descriptors
+int main(int argc, char* argv[]) {
+    int socket_fd = -1;
+    int catalog_fd = -1;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) {
+            socket_fd = std::stoi(argv[++i]);
+        } else if (arg == "--catalog-fd" && i + 1 < argc) {
+            catalog_fd = std::stoi(argv[++i]);
+        }
+    }
+
+    if (socket_fd < 0 || catalog_fd < 0) {
+        std::cerr << "Usage: orbitops_shard_worker --socket <fd> --catalog-fd <fd>\n"
+                  << "(started by the sharded screening coordinator)\n";
+        return 2;
+    }
+    return orbitops::run_shard_worker(socket_fd, catalog_fd);
+}
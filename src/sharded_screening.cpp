@@ -0,0 +1,438 @@
+#include "sharded_screening.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+namespace orbitops {
+
+namespace {
+    constexpr uint64_t CATALOG_MAGIC = 0x31305441434253ULL;   // "SBCAT01"
+    constexpr uint64_t TASK_MAGIC = 0x4B534154445253ULL;      // "SRDTASK"
+    constexpr uint64_t REPLY_MAGIC = 0x594C5045524453ULL;     // "SDREPLY"
+    constexpr size_t ELEMENT_ARRAYS = 8;   // incl, raan0, ecc, argp0, M0, n0, a0, bstar
+    constexpr int POLL_INTERVAL_MS = 100;  // Cancellation check period while waiting
+
+    static_assert(std::is_trivially_copyable_v<MonitoredConjunction>,
+                  "Events are sent over the socket as raw bytes");
+
+    // Mapped catalog layout: header, element arrays, catalog numbers; each
+    // array starts on a cache line so workers use them in place
+    struct alignas(64) CatalogHeader {
+        uint64_t magic;
+        uint64_t count;
+    };
+
+    struct ShardTask {
+        uint64_t magic;
+        uint64_t object_count;
+        double start_minutes;
+        double end_minutes;
+        double threshold_km;
+        double step_seconds;
+        double tca_match_minutes;
+        double change_fraction;
+        double collision_radius_km;
+    };
+
+    struct ShardReply {
+        uint64_t magic;
+        uint64_t status;      // 0 = ok
+        uint64_t count;
+    };
+
+    // Doubles per element array (count rounded up to a cache line)
+    size_t array_stride(size_t count) {
+        return (count + 7) / 8 * 8;
+    }
+
+    size_t catalog_bytes(size_t count) {
+        return sizeof(CatalogHeader) + ELEMENT_ARRAYS * array_stride(count) * sizeof(double) +
+               count * sizeof(int32_t);
+    }
+
+    bool write_full(int fd, const void* data, size_t size) {
+        const char* p = static_cast<const char*>(data);
+        while (size > 0) {
+            ssize_t n = ::send(fd, p, size, MSG_NOSIGNAL);   // A dead peer is an error, not SIGPIPE
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            p += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    bool read_full(int fd, void* data, size_t size) {
+        char* p = static_cast<char*>(data);
+        while (size > 0) {
+            ssize_t n = ::read(fd, p, size);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            p += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    // Write the catalog elements to an unlinked temporary file and return its
+    // descriptor, or -1. It is close-on-exec; spawn_worker passes it to each
+    // worker explicitly.
+    int write_shared_catalog(const SatelliteSystem& sys) {
+        char path[] = "/dev/shm/orbitops-catalog-XXXXXX";
+        int fd = ::mkostemp(path, O_CLOEXEC);
+        if (fd < 0) {
+            char fallback[] = "/tmp/orbitops-catalog-XXXXXX";
+            fd = ::mkostemp(fallback, O_CLOEXEC);
+            if (fd < 0) return -1;
+            ::unlink(fallback);
+        } else {
+            ::unlink(path);
+        }
+
+        const size_t n = sys.count;
+        const size_t bytes = catalog_bytes(n);
+        if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            ::close(fd);
+            return -1;
+        }
+        void* map = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (map == MAP_FAILED) {
+            ::close(fd);
+            return -1;
+        }
+
+        auto* header = static_cast<CatalogHeader*>(map);
+        header->magic = CATALOG_MAGIC;
+        header->count = n;
+        auto* arrays = reinterpret_cast<double*>(header + 1);
+        const size_t stride = array_stride(n);
+        const double* sources[ELEMENT_ARRAYS] = {sys.incl, sys.raan0, sys.ecc, sys.argp0,
+                                                 sys.M0, sys.n0, sys.a0, sys.bstar};
+        for (size_t k = 0; k < ELEMENT_ARRAYS; ++k) {
+            if (n > 0) std::memcpy(arrays + k * stride, sources[k], n * sizeof(double));
+        }
+        auto* numbers = reinterpret_cast<int32_t*>(arrays + ELEMENT_ARRAYS * stride);
+        for (size_t i = 0; i < n; ++i) numbers[i] = static_cast<int32_t>(sys.catalog_numbers[i]);
+
+        ::munmap(map, bytes);
+        return fd;
+    }
+
+    // Read-only mapping of the shared catalog, kept for the worker's
+    // lifetime. The SatelliteSystem borrows its element arrays from the
+    // mapping and owns only the state arrays it propagates into; the
+    // mapping must outlive it (declare it after the system).
+    class MappedCatalog {
+    public:
+        MappedCatalog() = default;
+        MappedCatalog(const MappedCatalog&) = delete;
+        MappedCatalog& operator=(const MappedCatalog&) = delete;
+        ~MappedCatalog() { release(); }
+
+        bool map(int fd, SatelliteSystem& sys) {
+            struct stat st;
+            if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(CatalogHeader)) return false;
+
+            size_ = static_cast<size_t>(st.st_size);
+            map_ = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+            if (map_ == MAP_FAILED) return false;
+
+            const auto* header = static_cast<const CatalogHeader*>(map_);
+            const size_t n = static_cast<size_t>(header->count);
+            if (header->magic != CATALOG_MAGIC || size_ < catalog_bytes(n)) return false;
+
+            sys.allocate(n);
+            sys_ = &sys;
+            auto* arrays = const_cast<double*>(reinterpret_cast<const double*>(header + 1));
+            const size_t stride = array_stride(n);
+            double** targets[ELEMENT_ARRAYS] = {&sys.incl, &sys.raan0, &sys.ecc, &sys.argp0,
+                                                &sys.M0, &sys.n0, &sys.a0, &sys.bstar};
+            for (size_t k = 0; k < ELEMENT_ARRAYS; ++k) {
+                std::free(*targets[k]);
+                *targets[k] = arrays + k * stride;
+            }
+            const auto* numbers = reinterpret_cast<const int32_t*>(arrays + ELEMENT_ARRAYS * stride);
+            for (size_t i = 0; i < n; ++i) sys.catalog_numbers[i] = numbers[i];
+            return true;
+        }
+
+    private:
+        void* map_ = MAP_FAILED;
+        size_t size_ = 0;
+        SatelliteSystem* sys_ = nullptr;
+
+        void release() {
+            if (sys_) {
+                // Borrowed arrays are not the system's to free
+                sys_->incl = sys_->raan0 = sys_->ecc = sys_->argp0 = nullptr;
+                sys_->M0 = sys_->n0 = sys_->a0 = sys_->bstar = nullptr;
+                sys_ = nullptr;
+            }
+            if (map_ != MAP_FAILED) ::munmap(map_, size_);
+            map_ = MAP_FAILED;
+        }
+    };
+
+    std::string default_worker_executable() {
+        char buf[4096];
+        ssize_t n = ::readlink("/proc/self/exe", buf, sizeof(buf) - 1);
+        if (n <= 0) return "orbitops_shard_worker";
+        std::string self(buf, static_cast<size_t>(n));
+        size_t slash = self.rfind('/');
+        return (slash == std::string::npos ? std::string() : self.substr(0, slash + 1)) + "orbitops_shard_worker";
+    }
+
+    struct Worker {
+        pid_t pid = -1;
+        int socket = -1;       // Coordinator end
+        std::vector<MonitoredConjunction> events;
+        bool done = false;
+    };
+
+    // Spawn one worker; its socket end and the catalog descriptor are inherited
+    bool spawn_worker(const std::string& exe, int child_socket, int catalog_fd,
+                      const std::vector<std::string>& env, pid_t& pid) {
+        std::string socket_arg = std::to_string(child_socket);
+        std::string catalog_arg = std::to_string(catalog_fd);
+        std::vector<char*> argv = {const_cast<char*>(exe.c_str()),
+                                   const_cast<char*>("--socket"), socket_arg.data(),
+                                   const_cast<char*>("--catalog-fd"), catalog_arg.data(), nullptr};
+        std::vector<char*> envp;
+        for (const auto& entry : env) envp.push_back(const_cast<char*>(entry.c_str()));
+        envp.push_back(nullptr);
+
+        // Both descriptors are close-on-exec; a dup2 onto itself clears the
+        // flag in this child only
+        posix_spawn_file_actions_t actions;
+        if (::posix_spawn_file_actions_init(&actions) != 0) return false;
+        bool ok = ::posix_spawn_file_actions_adddup2(&actions, child_socket, child_socket) == 0 &&
+                  ::posix_spawn_file_actions_adddup2(&actions, catalog_fd, catalog_fd) == 0 &&
+                  ::posix_spawn(&pid, exe.c_str(), &actions, nullptr, argv.data(), envp.data()) == 0;
+        ::posix_spawn_file_actions_destroy(&actions);
+        return ok;
+    }
+}
+
+std::vector<MonitoredConjunction> merge_shard_events(
+    const std::vector<std::vector<MonitoredConjunction>>& shards,
+    double tca_match_minutes,
+    size_t* duplicates
+) {
+    std::vector<MonitoredConjunction> all;
+    for (const auto& shard : shards) all.insert(all.end(), shard.begin(), shard.end());
+
+    // Group by pair, then collapse TCAs within the match window
+    std::sort(all.begin(), all.end(), [](const MonitoredConjunction& a, const MonitoredConjunction& b) {
+        if (a.sat1_id != b.sat1_id) return a.sat1_id < b.sat1_id;
+        if (a.sat2_id != b.sat2_id) return a.sat2_id < b.sat2_id;
+        return a.tca_minutes < b.tca_minutes;
+    });
+
+    std::vector<MonitoredConjunction> merged;
+    merged.reserve(all.size());
+    size_t dropped = 0;
+    for (const auto& event : all) {
+        if (!merged.empty()) {
+            auto& last = merged.back();
+            if (last.sat1_id == event.sat1_id && last.sat2_id == event.sat2_id &&
+                event.tca_minutes - last.tca_minutes <= tca_match_minutes) {
+                if (event.miss_distance_km < last.miss_distance_km) last = event;
+                dropped++;
+                continue;
+            }
+        }
+        merged.push_back(event);
+    }
+
+    std::sort(merged.begin(), merged.end(), [](const MonitoredConjunction& a, const MonitoredConjunction& b) {
+        if (a.tca_minutes != b.tca_minutes) return a.tca_minutes < b.tca_minutes;
+        return a.sat1_id != b.sat1_id ? a.sat1_id < b.sat1_id : a.sat2_id < b.sat2_id;
+    });
+    if (duplicates) *duplicates = dropped;
+    return merged;
+}
+
+ShardedScreeningResult screen_sharded(
+    const SatelliteSystem& sys,
+    double start_minutes,
+    double end_minutes,
+    const MonitorConfig& config,
+    const ShardingConfig& sharding,
+    const CancellationToken* cancel
+) {
+    ShardedScreeningResult result;
+    const double step_minutes = config.step_seconds / 60.0;
+    const size_t total_steps = end_minutes > start_minutes
+        ? static_cast<size_t>(std::floor((end_minutes - start_minutes) / step_minutes)) + 1 : 1;
+    const size_t steps_per_shard = (total_steps + std::max<size_t>(sharding.workers, 1) - 1) /
+                                   std::max<size_t>(sharding.workers, 1);
+    const size_t shards = (total_steps + steps_per_shard - 1) / steps_per_shard;
+    const double overlap = sharding.overlap_minutes >= 0.0
+        ? sharding.overlap_minutes : config.tca_match_minutes + step_minutes;
+
+    const std::string exe = sharding.worker_executable.empty()
+        ? default_worker_executable() : sharding.worker_executable;
+    if (::access(exe.c_str(), X_OK) != 0) {
+        result.error_message = "Shard worker not executable: " + exe;
+        return result;
+    }
+
+    // Workers split the cores unless told otherwise
+    size_t threads = sharding.threads_per_worker;
+    if (threads == 0) {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency() / shards);
+    }
+    std::vector<std::string> env;
+    for (char** e = environ; *e != nullptr; ++e) {
+        if (std::strncmp(*e, "OMP_NUM_THREADS=", 16) != 0) env.emplace_back(*e);
+    }
+    env.push_back("OMP_NUM_THREADS=" + std::to_string(threads));
+
+    int catalog_fd = write_shared_catalog(sys);
+    if (catalog_fd < 0) {
+        result.error_message = "Could not write the shared catalog";
+        return result;
+    }
+
+    // Equal step counts per shard, each extended by the overlap so an
+    // encounter straddling a boundary is seen whole by at least one shard
+    std::vector<Worker> workers(shards);
+    for (size_t k = 0; k < shards && result.error_message.empty(); ++k) {
+        const double from = start_minutes + static_cast<double>(k * steps_per_shard) * step_minutes;
+        double to = start_minutes + static_cast<double>((k + 1) * steps_per_shard) * step_minutes + overlap;
+        to = std::min(to, end_minutes);
+
+        int fds[2];
+        // Close-on-exec from creation, so a concurrent spawn on another
+        // thread cannot inherit either end
+        if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0) {
+            result.error_message = "socketpair failed";
+            break;
+        }
+
+        pid_t pid;
+        bool spawned = spawn_worker(exe, fds[1], catalog_fd, env, pid);
+        ::close(fds[1]);
+        if (!spawned) {
+            ::close(fds[0]);
+            result.error_message = "Could not start " + exe;
+            break;
+        }
+        workers[k].pid = pid;
+        workers[k].socket = fds[0];
+
+        ShardTask task{TASK_MAGIC, sys.count, from, to, config.threshold_km, config.step_seconds,
+                       config.tca_match_minutes, config.change_fraction, config.collision_radius_km};
+        if (!write_full(fds[0], &task, sizeof(task))) {
+            result.error_message = "Could not send task to shard " + std::to_string(k);
+        }
+    }
+    ::close(catalog_fd);
+
+    // Collect replies as workers finish
+    size_t remaining = 0;
+    for (const auto& worker : workers) remaining += worker.socket >= 0 ? 1 : 0;
+    while (remaining > 0 && result.error_message.empty()) {
+        if (is_cancelled(cancel)) {
+            result.error_message = "Cancelled";
+            break;
+        }
+
+        std::vector<pollfd> pfds;
+        std::vector<size_t> owners;
+        for (size_t k = 0; k < workers.size(); ++k) {
+            if (workers[k].socket >= 0 && !workers[k].done) {
+                pfds.push_back({workers[k].socket, POLLIN, 0});
+                owners.push_back(k);
+            }
+        }
+        if (::poll(pfds.data(), pfds.size(), POLL_INTERVAL_MS) <= 0) continue;
+
+        for (size_t p = 0; p < pfds.size(); ++p) {
+            if (pfds[p].revents == 0) continue;
+            Worker& worker = workers[owners[p]];
+
+            ShardReply reply;
+            if (!read_full(worker.socket, &reply, sizeof(reply)) ||
+                reply.magic != REPLY_MAGIC || reply.status != 0) {
+                result.error_message = "Shard " + std::to_string(owners[p]) + " failed";
+                break;
+            }
+            worker.events.resize(reply.count);
+            if (reply.count > 0 &&
+                !read_full(worker.socket, worker.events.data(), reply.count * sizeof(MonitoredConjunction))) {
+                result.error_message = "Shard " + std::to_string(owners[p]) + " reply truncated";
+                break;
+            }
+            worker.done = true;
+            remaining--;
+        }
+    }
+
+    // Reap workers; stragglers are killed on error or cancellation
+    for (auto& worker : workers) {
+        if (worker.socket >= 0) ::close(worker.socket);
+        if (worker.pid > 0) {
+            if (!worker.done) ::kill(worker.pid, SIGTERM);
+            int status;
+            while (::waitpid(worker.pid, &status, 0) < 0 && errno == EINTR) {}
+        }
+    }
+    if (!result.error_message.empty()) return result;
+
+    std::vector<std::vector<MonitoredConjunction>> shard_events;
+    shard_events.reserve(workers.size());
+    for (auto& worker : workers) shard_events.push_back(std::move(worker.events));
+
+    result.events = merge_shard_events(shard_events, config.tca_match_minutes, &result.duplicates_merged);
+    result.shards = shards;
+    result.success = true;
+    return result;
+}
+
+int run_shard_worker(int socket_fd, int catalog_fd) {
+    ShardTask task;
+    if (!read_full(socket_fd, &task, sizeof(task)) || task.magic != TASK_MAGIC) return 2;
+
+    ShardReply reply{REPLY_MAGIC, 0, 0};
+    SatelliteSystem sys;
+    MappedCatalog catalog;   // Released before sys
+    if (!catalog.map(catalog_fd, sys) || sys.count != task.object_count) {
+        reply.status = 1;
+        return write_full(socket_fd, &reply, sizeof(reply)) ? 1 : 2;
+    }
+    ::close(catalog_fd);
+
+    MonitorConfig config;
+    config.threshold_km = task.threshold_km;
+    config.step_seconds = task.step_seconds;
+    config.tca_match_minutes = task.tca_match_minutes;
+    config.change_fraction = task.change_fraction;
+    config.collision_radius_km = task.collision_radius_km;
+
+    auto events = screen_window(sys, task.start_minutes, task.end_minutes, config);
+
+    reply.count = events.size();
+    if (!write_full(socket_fd, &reply, sizeof(reply)) ||
+        (!events.empty() && !write_full(socket_fd, events.data(), events.size() * sizeof(MonitoredConjunction)))) {
+        return 2;
+    }
+    return 0;
+}
+
+} // namespace orbitops
@@ -0,0 +1,105 @@
+#include "shell_density.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace orbitops {
+
+namespace {
+    constexpr double EARTH_RADIUS = 6371.0;            // km
+    constexpr double RAD2DEG = 180.0 / M_PI;
+    constexpr double AVG_RELATIVE_VELOCITY = 7.5;      // km/s in LEO
+    constexpr double SECONDS_PER_YEAR = 3.15576e7;
+    constexpr double KM2_PER_M2 = 1e-6;
+}
+
+size_t ShellBinning::altitude_bins() const {
+    if (!(shell_thickness_km > 0.0) || !(max_altitude_km > min_altitude_km)) return 0;
+    return static_cast<size_t>(std::ceil((max_altitude_km - min_altitude_km) / shell_thickness_km));
+}
+
+long ShellDensityTable::cell(double altitude_km, double inclination_deg) const {
+    const size_t shells = binning.altitude_bins();
+    const size_t bands = std::max<size_t>(binning.inclination_bins, 1);
+    if (!(altitude_km >= binning.min_altitude_km)) return -1;
+
+    const auto shell = static_cast<size_t>((altitude_km - binning.min_altitude_km) / binning.shell_thickness_km);
+    if (shell >= shells) return -1;
+
+    const double band_width = 180.0 / bands;
+    const auto band = std::min(static_cast<size_t>(std::clamp(inclination_deg, 0.0, 180.0) / band_width), bands - 1);
+    return static_cast<long>(shell * bands + band);
+}
+
+double ShellDensityTable::shell_flux(double altitude_km) const {
+    const long first = cell(altitude_km, 0.0);
+    if (first < 0) return 0.0;
+
+    const size_t bands = std::max<size_t>(binning.inclination_bins, 1);
+    double total = 0.0;
+    for (size_t b = 0; b < bands; ++b) {
+        total += flux[first + b];
+    }
+    return total;
+}
+
+ShellDensityTable build_shell_density_table(
+    const DebrisSystem& debris,
+    const SatelliteSystem& sys,
+    const ShellBinning& binning
+) {
+    ShellDensityTable table;
+    table.binning = binning;
+    table.binning.inclination_bins = std::max<size_t>(binning.inclination_bins, 1);
+
+    const size_t shells = table.binning.altitude_bins();
+    const size_t bands = table.binning.inclination_bins;
+    const size_t cells = shells * bands;
+    table.counts.assign(cells, 0);
+    table.spatial_density.assign(cells, 0.0);
+    table.flux.assign(cells, 0.0);
+    if (cells == 0) return table;
+
+    const size_t n = debris.count;
+    const uint32_t* __restrict index = debris.index.data();
+    const double* __restrict mean_alt = debris.mean_altitude_km.data();
+    const double min_alt = table.binning.min_altitude_km;
+    const double inv_thickness = 1.0 / table.binning.shell_thickness_km;
+    const double inv_band = bands / 180.0;
+    const bool current = table.binning.current_altitude;
+
+    // One pass: each thread fills a private histogram, merged by the reduction
+    uint32_t* counts = table.counts.data();
+    #pragma omp parallel for schedule(static) reduction(+:counts[:cells])
+    for (size_t row = 0; row < n; ++row) {
+        const uint32_t i = index[row];
+        if (i >= sys.count) continue;
+
+        double alt = mean_alt[row];
+        if (current) {
+            alt = std::sqrt(sys.x[i] * sys.x[i] + sys.y[i] * sys.y[i] + sys.z[i] * sys.z[i]) - EARTH_RADIUS;
+        }
+        const double shell = (alt - min_alt) * inv_thickness;
+        if (!(shell >= 0.0) || shell >= static_cast<double>(shells)) continue;
+
+        const auto band = std::min(static_cast<size_t>(sys.incl[i] * RAD2DEG * inv_band), bands - 1);
+        counts[static_cast<size_t>(shell) * bands + band]++;
+    }
+
+    // Densities per cell: F = n * v_avg
+    for (size_t s = 0; s < shells; ++s) {
+        const double r_inner = EARTH_RADIUS + min_alt + s * table.binning.shell_thickness_km;
+        const double r_outer = std::min(r_inner + table.binning.shell_thickness_km,
+                                        EARTH_RADIUS + table.binning.max_altitude_km);
+        const double volume = (4.0/3.0) * M_PI * (r_outer*r_outer*r_outer - r_inner*r_inner*r_inner);
+
+        for (size_t b = 0; b < bands; ++b) {
+            const size_t c = s * bands + b;
+            table.spatial_density[c] = table.counts[c] / volume;
+            table.flux[c] = table.spatial_density[c] * AVG_RELATIVE_VELOCITY * KM2_PER_M2 * SECONDS_PER_YEAR;
+        }
+    }
+
+    return table;
+}
+
+} // namespace orbitops
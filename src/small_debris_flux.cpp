@@ -0,0 +1,256 @@
+#include "small_debris_flux.hpp"
+#include "shell_density.hpp"
+#include "sgp4_optimized.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace orbitops {
+
+namespace {
+    constexpr double EARTH_RADIUS = 6371.0;            // km (debris altitude convention)
+    constexpr double MU = 398600.4418;                 // km^3/s^2
+    constexpr double DEG2RAD = M_PI / 180.0;
+    constexpr double RAD2DEG = 180.0 / M_PI;
+    constexpr double TWOPI = 2.0 * M_PI;
+    constexpr double SECONDS_PER_YEAR = 3.15576e7;
+    constexpr double KM2_PER_M2 = 1e-6;
+}
+
+void SmallDebrisFluxTable::build(const DebrisSystem& debris, const SatelliteSystem& sys,
+                                 const SmallDebrisFluxConfig& config) {
+    ORBITOPS_TRACE_SCOPE_ARG("small_debris.build", debris.count);
+    config_ = config;
+    config_.inclination_bins = std::max<size_t>(config.inclination_bins, 1);
+    config_.direction_bins = std::max<size_t>(config.direction_bins, 1);
+    config_.raan_samples = std::max<size_t>(config.raan_samples, 1);
+
+    // Tracked population shape in altitude and inclination
+    ShellBinning binning;
+    binning.min_altitude_km = config_.min_altitude_km;
+    binning.max_altitude_km = config_.max_altitude_km;
+    binning.shell_thickness_km = config_.altitude_step_km;
+    binning.inclination_bins = config_.inclination_bins;
+    const ShellDensityTable tracked = build_shell_density_table(debris, sys, binning);
+
+    const size_t shells = binning.altitude_bins();
+    const size_t bands = config_.inclination_bins;
+    const size_t directions = config_.direction_bins;
+    altitude_bins_ = shells;
+    omni_.assign(shells * bands, 0.0);
+    directional_.assign(shells * bands * directions, 0.0);
+    if (shells == 0) return;
+
+    // Scale so the densest shell holds the reference density; without a
+    // tracked population every cell gets it, spread evenly over inclination
+    double densest = 0.0;
+    for (size_t s = 0; s < shells; ++s) {
+        double total = 0.0;
+        for (size_t b = 0; b < bands; ++b) total += tracked.spatial_density[s * bands + b];
+        densest = std::max(densest, total);
+    }
+    std::vector<double> population(shells * bands);
+    for (size_t c = 0; c < population.size(); ++c) {
+        population[c] = densest > 0.0 ? tracked.spatial_density[c] * config_.reference_density / densest
+                                       : config_.reference_density / bands;
+    }
+
+    const double band_width = 180.0 / bands;
+    const double direction_width = 360.0 / directions;
+    const size_t samples = config_.raan_samples;
+    auto direction_bin = [&](double azimuth_deg) {
+        const auto bin = static_cast<long>(std::floor((azimuth_deg + 180.0) / direction_width));
+        return static_cast<size_t>(((bin % static_cast<long>(directions)) + directions) % directions);
+    };
+
+    // Cell (shell, own inclination): integrate over population bands and
+    // relative node angles. Two circular orbits cross at angle
+    // cos(D) = cos i cos j + sin i sin j cos(dRAAN) with relative speed
+    // 2 v sin(D/2), arriving from +-(90 - D/2) degrees off the ram direction.
+    #pragma omp parallel for collapse(2) schedule(static)
+    for (size_t s = 0; s < shells; ++s) {
+        for (size_t b = 0; b < bands; ++b) {
+            const double altitude = config_.min_altitude_km + (s + 0.5) * config_.altitude_step_km;
+            const double speed = std::sqrt(MU / (EARTH_RADIUS + altitude));
+            const double incl = (b + 0.5) * band_width * DEG2RAD;
+            double* cell = &directional_[(s * bands + b) * directions];
+
+            for (size_t j = 0; j < bands; ++j) {
+                const double density = population[s * bands + j];
+                if (density <= 0.0) continue;
+                const double other = (j + 0.5) * band_width * DEG2RAD;
+
+                for (size_t k = 0; k < samples; ++k) {
+                    const double d_raan = (k + 0.5) * TWOPI / samples;
+                    const double cos_cross = std::cos(incl) * std::cos(other) +
+                                             std::sin(incl) * std::sin(other) * std::cos(d_raan);
+                    const double crossing = std::acos(std::clamp(cos_cross, -1.0, 1.0));
+                    const double relative_speed = 2.0 * speed * std::sin(0.5 * crossing);
+                    const double rate = density * relative_speed / samples *
+                                        KM2_PER_M2 * SECONDS_PER_YEAR;
+
+                    const double azimuth = 90.0 - 0.5 * crossing * RAD2DEG;
+                    cell[direction_bin(azimuth)] += 0.5 * rate;
+                    cell[direction_bin(-azimuth)] += 0.5 * rate;
+                }
+            }
+
+            double total = 0.0;
+            for (size_t d = 0; d < directions; ++d) total += cell[d];
+            omni_[s * bands + b] = total;
+        }
+    }
+}
+
+bool SmallDebrisFluxTable::locate(double altitude_km, double inclination_deg,
+                                  size_t cell[4], double weight[4]) const {
+    if (empty() || !(altitude_km >= config_.min_altitude_km) || !(altitude_km <= config_.max_altitude_km)) {
+        return false;
+    }
+    const size_t bands = config_.inclination_bins;
+
+    // Fractional positions relative to cell centres, clamped at the edges
+    const double fa = std::clamp((altitude_km - config_.min_altitude_km) / config_.altitude_step_km - 0.5,
+                                 0.0, static_cast<double>(altitude_bins_ - 1));
+    const double fi = std::clamp(inclination_deg * bands / 180.0 - 0.5, 0.0, static_cast<double>(bands - 1));
+    const auto a0 = static_cast<size_t>(fa);
+    const auto i0 = static_cast<size_t>(fi);
+    const size_t a1 = std::min(a0 + 1, altitude_bins_ - 1);
+    const size_t i1 = std::min(i0 + 1, bands - 1);
+    const double ta = fa - a0;
+    const double ti = fi - i0;
+
+    cell[0] = a0 * bands + i0;  weight[0] = (1.0 - ta) * (1.0 - ti);
+    cell[1] = a0 * bands + i1;  weight[1] = (1.0 - ta) * ti;
+    cell[2] = a1 * bands + i0;  weight[2] = ta * (1.0 - ti);
+    cell[3] = a1 * bands + i1;  weight[3] = ta * ti;
+    return true;
+}
+
+double SmallDebrisFluxTable::flux(double altitude_km, double inclination_deg) const {
+    size_t cell[4];
+    double weight[4];
+    if (!locate(altitude_km, inclination_deg, cell, weight)) return 0.0;
+    return weight[0] * omni_[cell[0]] + weight[1] * omni_[cell[1]] +
+           weight[2] * omni_[cell[2]] + weight[3] * omni_[cell[3]];
+}
+
+void SmallDebrisFluxTable::flux_batch(const double* altitude_km, const double* inclination_deg,
+                                      size_t n, double* out) const {
+    if (empty()) {
+        std::fill(out, out + n, 0.0);
+        return;
+    }
+
+    const double* __restrict table = omni_.data();
+    const double min_alt = config_.min_altitude_km;
+    const double max_alt = config_.max_altitude_km;
+    const double inv_step = 1.0 / config_.altitude_step_km;
+    const double last_shell = static_cast<double>(altitude_bins_ - 1);
+    const size_t bands = config_.inclination_bins;
+    const double band_scale = bands / 180.0;
+    const double last_band = static_cast<double>(bands - 1);
+
+    // Same interpolation as flux(), branch-free so the loop vectorizes
+    #pragma omp simd
+    for (size_t k = 0; k < n; ++k) {
+        const double alt = altitude_km[k];
+        const double fa = std::clamp((alt - min_alt) * inv_step - 0.5, 0.0, last_shell);
+        const double fi = std::clamp(inclination_deg[k] * band_scale - 0.5, 0.0, last_band);
+        const auto a0 = static_cast<size_t>(fa);
+        const auto i0 = static_cast<size_t>(fi);
+        const size_t a1 = a0 + (a0 < altitude_bins_ - 1);
+        const size_t i1 = i0 + (i0 < bands - 1);
+        const double ta = fa - a0;
+        const double ti = fi - i0;
+
+        const double low = (1.0 - ti) * table[a0 * bands + i0] + ti * table[a0 * bands + i1];
+        const double high = (1.0 - ti) * table[a1 * bands + i0] + ti * table[a1 * bands + i1];
+        const double value = (1.0 - ta) * low + ta * high;
+        out[k] = (alt >= min_alt && alt <= max_alt) ? value : 0.0;
+    }
+}
+
+void SmallDebrisFluxTable::accumulate_directional(double altitude_km, double inclination_deg, double* out) const {
+    size_t cell[4];
+    double weight[4];
+    if (!locate(altitude_km, inclination_deg, cell, weight)) return;
+
+    const size_t directions = config_.direction_bins;
+    for (int c = 0; c < 4; ++c) {
+        const double* values = &directional_[cell[c] * directions];
+        for (size_t d = 0; d < directions; ++d) {
+            out[d] += weight[c] * values[d];
+        }
+    }
+}
+
+double SmallDebrisFluxTable::size_fraction(double size_m) const {
+    if (!(size_m > config_.reference_size_m)) return 1.0;
+    return std::pow(size_m / config_.reference_size_m, -config_.size_exponent);
+}
+
+std::vector<SmallDebrisAssessment> assess_small_debris(
+    const SatelliteSystem& sys,
+    const std::vector<uint32_t>& fleet,
+    const SmallDebrisFluxTable& table,
+    const SmallDebrisExposure& exposure
+) {
+    ORBITOPS_TRACE_SCOPE_ARG("small_debris.assess", fleet.size());
+    const size_t samples = std::max<size_t>(exposure.samples_per_orbit, 1);
+    const size_t directions = table.config().direction_bins;
+    std::vector<SmallDebrisAssessment> assessments(fleet.size());
+
+    // One orbit of ephemeris per fleet member, evaluated as a single batch
+    std::vector<StateQuery> queries(fleet.size() * samples);
+    for (size_t f = 0; f < fleet.size(); ++f) {
+        const uint32_t i = fleet[f];
+        const double period = (i < sys.count && sys.n0[i] > 0.0) ? TWOPI / sys.n0[i] : 0.0;
+        for (size_t k = 0; k < samples; ++k) {
+            queries[f * samples + k] = {i, exposure.start_minutes + period * k / samples};
+        }
+    }
+
+    const size_t total = queries.size();
+    std::vector<double> x(total), y(total), z(total), vx(total), vy(total), vz(total);
+    propagate_states(sys, queries, {x.data(), y.data(), z.data(), vx.data(), vy.data(), vz.data()});
+
+    std::vector<double> altitude(total), inclination(total), flux(total);
+    #pragma omp parallel for simd schedule(static)
+    for (size_t q = 0; q < total; ++q) {
+        altitude[q] = std::sqrt(x[q] * x[q] + y[q] * y[q] + z[q] * z[q]) - EARTH_RADIUS;
+    }
+    for (size_t f = 0; f < fleet.size(); ++f) {
+        const double incl = fleet[f] < sys.count ? sys.incl[fleet[f]] * RAD2DEG : 0.0;
+        std::fill(inclination.begin() + f * samples, inclination.begin() + (f + 1) * samples, incl);
+    }
+    table.flux_batch(altitude.data(), inclination.data(), total, flux.data());
+
+    const double penetrating = table.size_fraction(exposure.ballistic_limit_m);
+
+    #pragma omp parallel for schedule(static)
+    for (size_t f = 0; f < fleet.size(); ++f) {
+        SmallDebrisAssessment& assessment = assessments[f];
+        assessment.index = fleet[f];
+        assessment.directional_flux.assign(directions, 0.0);
+        if (fleet[f] >= sys.count) continue;
+
+        double sum = 0.0;
+        for (size_t k = 0; k < samples; ++k) {
+            const size_t q = f * samples + k;
+            sum += flux[q];
+            assessment.peak_flux = std::max(assessment.peak_flux, flux[q]);
+            table.accumulate_directional(altitude[q], inclination[q], assessment.directional_flux.data());
+        }
+        assessment.mean_flux = sum / samples;
+        for (double& d : assessment.directional_flux) d /= samples;
+
+        assessment.expected_penetrations = assessment.mean_flux * penetrating *
+                                           exposure.area_m2 * exposure.duration_years;
+        assessment.penetration_probability = 1.0 - std::exp(-assessment.expected_penetrations);
+    }
+
+    return assessments;
+}
+
+} // namespace orbitops
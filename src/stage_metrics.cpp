@@ -0,0 +1,171 @@
+#include "stage_metrics.hpp"
+#include <cmath>
+#include <cstdio>
+
+namespace orbitops {
+
+namespace {
+    // Seconds per cycle_count() tick, measured against steady_clock over a
+    // few milliseconds on first use
+    double seconds_per_cycle() {
+#if defined(__x86_64__) || defined(__i386__)
+        static const double value = [] {
+            using Clock = std::chrono::steady_clock;
+            const auto t0 = Clock::now();
+            const uint64_t c0 = cycle_count();
+            while (Clock::now() - t0 < std::chrono::milliseconds(5)) {}
+            const uint64_t c1 = cycle_count();
+            const double elapsed = std::chrono::duration<double>(Clock::now() - t0).count();
+            return c1 > c0 ? elapsed / static_cast<double>(c1 - c0) : 1e-9;
+        }();
+        return value;
+#else
+        return 1e-9;
+#endif
+    }
+
+    void append_number(std::string& out, double value) {
+        // Whole numbers (counters) print exactly
+        char buf[32];
+        const bool whole = value == std::floor(value) && std::abs(value) < 9e15;
+        std::snprintf(buf, sizeof(buf), whole ? "%.0f" : "%.9g", value);
+        out += buf;
+    }
+
+    void append_uint(std::string& out, uint64_t value) {
+        out += std::to_string(value);
+    }
+}
+
+double cycles_to_seconds(uint64_t cycles) {
+    return static_cast<double>(cycles) * seconds_per_cycle();
+}
+
+const char* stage_name(Stage stage) {
+    switch (stage) {
+        case Stage::PROPAGATE:   return "propagate";
+        case Stage::GRID_BUILD:  return "grid_build";
+        case Stage::PAIR_TEST:   return "pair_test";
+        case Stage::MONTE_CARLO: return "monte_carlo";
+        case Stage::SERIALIZE:   return "serialize";
+    }
+    return "unknown";
+}
+
+const char* stage_counter_name(StageCounter counter) {
+    switch (counter) {
+        case StageCounter::CANDIDATES_TESTED: return "candidates_tested";
+        case StageCounter::HITS:              return "hits";
+        case StageCounter::PC_SAMPLES:        return "pc_samples";
+        case StageCounter::BYTES_WRITTEN:     return "bytes_written";
+    }
+    return "unknown";
+}
+
+const std::array<double, LatencyHistogram::BUCKETS>& LatencyHistogram::bounds() {
+    static const std::array<double, BUCKETS> values = {
+        1e-5, 2.5e-5, 5e-5,
+        1e-4, 2.5e-4, 5e-4,
+        1e-3, 2.5e-3, 5e-3,
+        1e-2, 2.5e-2, 5e-2,
+        0.1, 0.25, 0.5,
+        1.0, 2.5, 5.0,
+        10.0
+    };
+    return values;
+}
+
+void LatencyHistogram::observe(double seconds) {
+    const auto& b = bounds();
+    size_t bucket = 0;
+    while (bucket < BUCKETS && seconds > b[bucket]) ++bucket;
+
+    counts_[bucket].fetch_add(1, std::memory_order_relaxed);
+    sum_ns_.fetch_add(static_cast<uint64_t>(seconds * 1e9), std::memory_order_relaxed);
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const {
+    Snapshot snap;
+    for (size_t i = 0; i <= BUCKETS; ++i) {
+        snap.counts[i] = counts_[i].load(std::memory_order_relaxed);
+        snap.count += snap.counts[i];
+    }
+    snap.sum_seconds = static_cast<double>(sum_ns_.load(std::memory_order_relaxed)) * 1e-9;
+    return snap;
+}
+
+void StageMetrics::record(const StageTimings& timings) {
+    for (size_t s = 0; s < STAGE_COUNT; ++s) {
+        if (timings.cycles[s] > 0) {
+            stages_[s].observe(cycles_to_seconds(timings.cycles[s]));
+        }
+    }
+    for (size_t c = 0; c < STAGE_COUNTER_COUNT; ++c) {
+        counters_[c].fetch_add(timings.counters[c], std::memory_order_relaxed);
+    }
+    steps_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void StageMetrics::render_prometheus(std::string& out) const {
+    out += "# HELP orbitops_stage_duration_seconds Time per conjunction screening step spent in each stage\n";
+    out += "# TYPE orbitops_stage_duration_seconds histogram\n";
+
+    const auto& b = LatencyHistogram::bounds();
+    for (size_t s = 0; s < STAGE_COUNT; ++s) {
+        const std::string label = std::string("stage=\"") + stage_name(static_cast<Stage>(s)) + "\"";
+        auto snap = stages_[s].snapshot();
+
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i <= LatencyHistogram::BUCKETS; ++i) {
+            cumulative += snap.counts[i];
+            out += "orbitops_stage_duration_seconds_bucket{" + label + ",le=\"";
+            if (i < LatencyHistogram::BUCKETS) {
+                append_number(out, b[i]);
+            } else {
+                out += "+Inf";
+            }
+            out += "\"} ";
+            append_uint(out, cumulative);
+            out += '\n';
+        }
+        out += "orbitops_stage_duration_seconds_sum{" + label + "} ";
+        append_number(out, snap.sum_seconds);
+        out += "\norbitops_stage_duration_seconds_count{" + label + "} ";
+        append_uint(out, snap.count);
+        out += '\n';
+    }
+
+    static const char* const counter_help[STAGE_COUNTER_COUNT] = {
+        "Pair distance tests performed by the spatial grid",
+        "Pairs found within the screening threshold",
+        "Monte Carlo collision probability samples drawn",
+        "Encoded conjunction frame bytes sent",
+    };
+    for (size_t c = 0; c < STAGE_COUNTER_COUNT; ++c) {
+        const std::string name = std::string("orbitops_") +
+                                 stage_counter_name(static_cast<StageCounter>(c)) + "_total";
+        append_prometheus_metric(out, name.c_str(), "counter", counter_help[c],
+                                 static_cast<double>(counters_[c].load(std::memory_order_relaxed)));
+    }
+    append_prometheus_metric(out, "orbitops_screening_steps_total", "counter",
+                             "Conjunction screening steps recorded", static_cast<double>(steps()));
+}
+
+void append_prometheus_metric(std::string& out, const char* name, const char* type,
+                              const char* help, double value) {
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    out += help;
+    out += "\n# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+    out += name;
+    out += ' ';
+    append_number(out, value);
+    out += '\n';
+}
+
+} // namespace orbitops
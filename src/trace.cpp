@@ -0,0 +1,150 @@
+#include "trace.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <utility>
+
+namespace orbitops {
+namespace trace {
+
+namespace {
+    // All rings ever handed out. A ring outlives its thread so late dumps
+    // still see its spans, and is reused (under a new tid) by the next new
+    // thread. Tids and ring reassignment are guarded by the mutex.
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<ThreadRing>> rings;
+        std::vector<std::shared_ptr<ThreadRing>> retired;
+        uint32_t next_tid = 1;
+        uint64_t base_cycles = cycle_count();   // Trace time zero
+    };
+
+    Registry& registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    // Returns the thread's ring to the pool when the thread exits
+    struct RingHandle {
+        std::shared_ptr<ThreadRing> ring;
+
+        RingHandle() {
+            auto& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            if (!reg.retired.empty()) {
+                ring = std::move(reg.retired.back());
+                reg.retired.pop_back();
+                ring->reassign(reg.next_tid++);
+            } else {
+                ring = std::make_shared<ThreadRing>(reg.next_tid++);
+                reg.rings.push_back(ring);
+            }
+        }
+
+        ~RingHandle() {
+            auto& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.retired.push_back(std::move(ring));
+        }
+    };
+
+    ThreadRing& thread_ring() {
+        thread_local RingHandle handle;
+        return *handle.ring;
+    }
+
+    void append_micros(std::string& out, double micros) {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.3f", micros);
+        out += buf;
+    }
+}
+
+ThreadRing::ThreadRing(uint32_t tid)
+    : tid_(tid), events_(std::make_unique<Event[]>(CAPACITY)) {}
+
+void ThreadRing::snapshot(std::vector<Event>& out) const {
+    const uint64_t head = head_.load(std::memory_order_acquire);
+    const uint64_t tail = tail_.load(std::memory_order_acquire);
+    uint64_t first = std::max(tail, head > CAPACITY ? head - CAPACITY : 0);
+
+    const size_t start = out.size();
+    for (uint64_t i = first; i < head; ++i) {
+        out.push_back(events_[i & (CAPACITY - 1)]);
+    }
+
+    // Slots the writer reached during the copy may be torn. push() writes
+    // slot (head & mask) before publishing head + 1, so the writer may be
+    // overwriting slot head_after - CAPACITY itself. The fence keeps the
+    // copies above from being reordered after the reload.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t head_after = head_.load(std::memory_order_relaxed);
+    if (head_after >= first + CAPACITY) {
+        const size_t lapped = static_cast<size_t>(std::min(head_after - CAPACITY - first + 1, head - first));
+        out.erase(out.begin() + static_cast<std::ptrdiff_t>(start),
+                  out.begin() + static_cast<std::ptrdiff_t>(start + lapped));
+    }
+}
+
+void record(const char* name, uint64_t start, uint64_t end, int64_t arg) {
+    thread_ring().push({name, start, end, arg});
+}
+
+std::string chrome_json(uint64_t since_cycles) {
+    auto& reg = registry();
+
+    // Copy under the lock so no ring is reassigned (and retagged) mid-copy
+    std::vector<std::pair<uint32_t, std::vector<Event>>> tracks;
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        tracks.resize(reg.rings.size());
+        for (size_t r = 0; r < reg.rings.size(); ++r) {
+            tracks[r].first = reg.rings[r]->tid();
+            reg.rings[r]->snapshot(tracks[r].second);
+        }
+    }
+
+    std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto& [tid, events] : tracks) {
+        for (const auto& event : events) {
+            if (event.end < since_cycles || event.start < reg.base_cycles || event.name == nullptr) continue;
+
+            if (!first) out += ',';
+            first = false;
+            out += "{\"name\":\"";
+            out += event.name;
+            out += "\",\"ph\":\"X\",\"pid\":1,\"tid\":";
+            out += std::to_string(tid);
+            out += ",\"ts\":";
+            append_micros(out, cycles_to_seconds(event.start - reg.base_cycles) * 1e6);
+            out += ",\"dur\":";
+            append_micros(out, cycles_to_seconds(event.end - event.start) * 1e6);
+            if (event.arg >= 0) {
+                out += ",\"args\":{\"n\":";
+                out += std::to_string(event.arg);
+                out += '}';
+            }
+            out += '}';
+        }
+    }
+    out += "]}";
+    return out;
+}
+
+bool write_chrome_json(const std::string& path, uint64_t since_cycles) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+    file << chrome_json(since_cycles);
+    return static_cast<bool>(file);
+}
+
+void clear() {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (auto& ring : reg.rings) ring->clear();
+}
+
+} // namespace trace
+} // namespace orbitops
@@ -5,8 +5,36 @@
 #include "satellite_system.hpp"
 #include "sgp4_optimized.hpp"
 #include "collision_optimized.hpp"
+#include "frame_cache.hpp"
+#include "object_filter.hpp"
+#include "paced_writer.hpp"
+#include "cancellation.hpp"
+#include "orbit_path.hpp"
+#include "conjunction_monitor.hpp"
+#include "screening_horizon.hpp"
+#include "sharded_screening.hpp"
+#include "stage_metrics.hpp"
+#include "metrics_endpoint.hpp"
+#include "trace.hpp"
+#include "flight_recorder.hpp"
+#include "debris_model.hpp"
+#include "breakup_model.hpp"
+#include <algorithm>
 #include <cmath>
 #include <fstream>
+#include <limits>
+#include <filesystem>
+#include <set>
+#include <thread>
+#include <tuple>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using namespace orbitops;
 using namespace test;
@@ -243,6 +271,1351 @@ bool test_high_eccentricity() {
            assert_true(radius > 6378, "Radius should be greater than Earth radius");
 }
 
+// ============================================================================
+// Frame Cache Tests
+// ============================================================================
+
+bool test_frame_cache_lru_eviction() {
+    // Budget fits roughly two 1 KB frames
+    FrameCache cache(2 * 1024 + 2 * 256);
+    uint64_t enc = frame_encoding(FrameEncoding::POSITION_BATCH);
+    
+    cache.put({1, 0.0, enc}, std::string(1024, 'a'));
+    cache.put({1, 60.0, enc}, std::string(1024, 'b'));
+    cache.get({1, 0.0, enc});                          // Touch t=0 so t=60 is LRU
+    cache.put({1, 120.0, enc}, std::string(1024, 'c'));
+    
+    auto stats = cache.get_stats();
+    return assert_true(cache.get({1, 0.0, enc}) != nullptr, "Recently used frame kept") &&
+           assert_true(cache.get({1, 60.0, enc}) == nullptr, "LRU frame evicted") &&
+           assert_true(cache.get({2, 0.0, enc}) == nullptr, "Other catalog version misses") &&
+           assert_true(stats.evictions == 1, "One eviction") &&
+           assert_true(stats.bytes <= stats.max_bytes, "Within memory budget");
+}
+
+bool test_frame_cache_version_invalidation() {
+    FrameCache cache;
+    uint64_t enc = frame_encoding(FrameEncoding::CONJUNCTION_BATCH, 10.0);
+    
+    cache.put({1, 0.0, enc}, "old");
+    cache.put({2, 0.0, enc}, "new");
+    cache.invalidate_before(2);
+    
+    auto stale = cache.get({1, 0.0, enc});
+    auto frame = cache.get({2, 0.0, enc});
+    auto stats = cache.get_stats();
+    return assert_true(stale == nullptr, "Old version dropped") &&
+           assert_true(frame && *frame == "new", "Current version kept") &&
+           assert_true(enc != frame_encoding(FrameEncoding::CONJUNCTION_BATCH, 5.0),
+                       "Threshold is part of the encoding") &&
+           assert_near(stats.hit_rate(), 0.5, 1e-9);
+}
+
+bool test_catalog_paging() {
+    const CatalogPage whole = catalog_page(10, 0, 0);
+    const CatalogPage middle = catalog_page(10, 4, 4);
+    const CatalogPage last = catalog_page(10, 8, 4);
+    const CatalogPage past = catalog_page(10, 25, 4);
+    const CatalogPage negative = catalog_page(10, -3, -1);
+    const CatalogPage huge = catalog_page(10, 2, std::numeric_limits<int32_t>::max());
+    
+    return assert_true(whole.begin == 0 && whole.end == 10 && whole.next_offset == 0,
+                       "page_size 0 returns the whole catalog") &&
+           assert_true(middle.begin == 4 && middle.end == 8 && middle.next_offset == 8, "Full page") &&
+           assert_true(last.begin == 8 && last.end == 10 && last.next_offset == 0, "Partial last page") &&
+           assert_true(past.begin == 10 && past.end == 10 && past.next_offset == 0, "Offset past the end is empty") &&
+           assert_true(negative.begin == 0 && negative.end == 10, "Negative values count as 0") &&
+           assert_true(huge.begin == 2 && huge.end == 10 && huge.next_offset == 0, "No overflow near INT_MAX") &&
+           assert_true(catalog_page_key(3, 4, 4) == catalog_page_key(3, 4, 4) &&
+                       !(catalog_page_key(3, 4, 4) == catalog_page_key(3, 4, 8)) &&
+                       !(catalog_page_key(3, 4, 4) == catalog_page_key(3, 8, 4)) &&
+                       catalog_page_key(3, -1, -1) == catalog_page_key(3, 0, 0),
+                       "Page keys distinguish offset and size");
+}
+
+// ============================================================================
+// Object Filter Tests
+// ============================================================================
+
+bool test_object_filter_predicates() {
+    std::vector<TLE> tles(3);
+    tles[0].name = "STARLINK-1007";    // LEO payload
+    tles[0].inclination = 53.0;
+    tles[0].mean_motion = 15.0;
+    tles[1].name = "COSMOS 2251 DEB";  // LEO debris
+    tles[1].inclination = 74.0;
+    tles[1].mean_motion = 14.5;
+    tles[2].name = "CZ-3B R/B";        // High-altitude rocket body
+    tles[2].inclination = 28.0;
+    tles[2].mean_motion = 2.0;
+    
+    SatelliteSystem sys = create_satellite_system(tles);
+    propagate_all_optimized(sys, 0.0);
+    
+    ObjectFilter pass_all;
+    
+    ObjectFilter debris_only;
+    debris_only.class_mask = OBJECT_DEBRIS;
+    
+    ObjectFilter leo_band;
+    leo_band.max_altitude_km = 2000.0;
+    leo_band.max_inclination_deg = 60.0;
+    
+    ObjectFilter ids;
+    ids.ids = {2, 7};                  // Out-of-range IDs are ignored
+    
+    ObjectFilter whole_globe;
+    whole_globe.has_geo_box = true;
+    
+    return assert_true(pass_all.is_pass_through(), "Default filter passes through") &&
+           assert_true(select_filtered(sys, pass_all, 0.0).size() == 3, "All objects") &&
+           assert_true(select_filtered(sys, debris_only, 0.0) == std::vector<uint32_t>{1}, "Debris class") &&
+           assert_true(select_filtered(sys, leo_band, 0.0) == std::vector<uint32_t>{0}, "LEO band") &&
+           assert_true(select_filtered(sys, ids, 0.0) == std::vector<uint32_t>{2}, "ID set") &&
+           assert_true(select_filtered(sys, whole_globe, 1.7e9).size() == 3, "Global geo box") &&
+           assert_true(debris_only.hash() != leo_band.hash(), "Distinct filter hashes");
+}
+
+// ============================================================================
+// Paced Writer Tests
+// ============================================================================
+
+bool test_paced_writer_skips_intermediate_frames() {
+    std::vector<int> written;
+    PacedWriter<int> pacer([&written](const int& frame) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));  // Slow client
+        written.push_back(frame);
+        return true;
+    }, 2);
+    
+    for (int i = 0; i < 50; ++i) {
+        auto frame = pacer.acquire();
+        *frame = i;
+        pacer.push(std::move(frame), true);
+    }
+    bool ok = pacer.close();
+    auto stats = pacer.get_stats();
+    
+    std::cout << "(written: " << stats.frames_written << ", dropped: " << stats.frames_dropped << ") ";
+    return assert_true(ok, "No write failures") &&
+           assert_true(stats.frames_dropped > 0, "Slow client skips frames") &&
+           assert_true(stats.frames_written + stats.frames_dropped == 50, "Every frame accounted for") &&
+           assert_true(!written.empty() && written.back() == 49, "Latest frame always delivered") &&
+           assert_true(std::is_sorted(written.begin(), written.end()), "Frames stay in order");
+}
+
+bool test_paced_writer_keeps_events() {
+    size_t writes = 0;
+    PacedWriter<int> pacer([&writes](const int&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return ++writes < 10;  // Client disconnects on the 10th write
+    }, 2);
+    
+    int pushed = 0;
+    for (int i = 0; i < 100; ++i) {
+        if (!pacer.push(std::make_unique<int>(i), false)) break;
+        ++pushed;
+    }
+    bool ok = pacer.close();
+    auto stats = pacer.get_stats();
+    
+    return assert_true(!ok, "Disconnect reported") &&
+           assert_true(stats.frames_dropped == 0, "Events are never skipped") &&
+           assert_true(pushed < 100, "Producer stops after disconnect");
+}
+
+// ============================================================================
+// Cancellation Tests
+// ============================================================================
+
+bool test_cancellation_stops_kernels() {
+    std::vector<TLE> tles(1000);
+    for (size_t i = 0; i < tles.size(); ++i) {
+        tles[i].catalog_number = static_cast<int>(i);
+        tles[i].inclination = 50.0;
+        tles[i].mean_motion = 15.0;
+        tles[i].mean_anomaly = 0.01 * static_cast<double>(i);
+    }
+    SatelliteSystem sys = create_satellite_system(tles);
+    propagate_all_optimized(sys, 0.0);
+    const double x0 = sys.x[0], x999 = sys.x[999];
+    
+    CancellationToken cancelled;
+    cancelled.cancel();
+    propagate_all_optimized(sys, 45.0, &cancelled);
+    bool untouched = sys.x[0] == x0 && sys.x[999] == x999;
+    
+    CancellationToken expired;
+    expired.set_deadline(CancellationToken::Clock::now() - std::chrono::seconds(1));
+    
+    CancellationToken live;
+    propagate_all_optimized(sys, 90.0, &live);
+    
+    // One close pair per occupied cell, far more cells than the 64 screened
+    // between token checks, so a tripped token must skip most of them
+    const size_t pairs = 16384;
+    std::vector<TLE> lattice_tles(2 * pairs);
+    SatelliteSystem lattice = create_satellite_system(lattice_tles);
+    for (size_t k = 0; k < pairs; ++k) {
+        const double x = 100.0 * static_cast<double>(k % 128);
+        const double y = 100.0 * static_cast<double>(k / 128);
+        lattice.x[2 * k] = x;
+        lattice.y[2 * k] = y;
+        lattice.z[2 * k] = 0.0;
+        lattice.x[2 * k + 1] = x + 1.0;
+        lattice.y[2 * k + 1] = y;
+        lattice.z[2 * k + 1] = 0.0;
+    }
+    SpatialGrid grid(20.0);
+    grid.build(lattice);
+    auto found = grid.find_close_pairs(lattice, 10.0);
+    auto partial = grid.find_close_pairs(lattice, 10.0, &expired);
+    
+    std::set<std::pair<size_t, size_t>> found_set;
+    for (const auto& p : found) found_set.insert({std::min(p.i, p.j), std::max(p.i, p.j)});
+    bool subset = true;
+    for (const auto& p : partial) {
+        subset = subset && found_set.count({std::min(p.i, p.j), std::max(p.i, p.j)}) > 0;
+    }
+    
+    return assert_true(untouched, "Cancelled propagation leaves positions untouched") &&
+           assert_true(!live.is_cancelled() && sys.x[999] != x999, "Live token propagates") &&
+           assert_true(expired.is_cancelled(), "Past deadline trips the token") &&
+           assert_true(found.size() == pairs, "Uncancelled screening finds every pair") &&
+           assert_true(partial.size() < found.size() && subset,
+                       "Cancelled screening returns a strict subset");
+}
+
+// ============================================================================
+// Subset Propagation Tests
+// ============================================================================
+
+bool test_orbit_path_adaptive_sampling() {
+    std::vector<TLE> tles(2);
+    tles[0].name = "CIRCULAR";
+    tles[0].inclination = 51.6;
+    tles[0].mean_motion = 15.5;
+    tles[1].name = "MOLNIYA";
+    tles[1].inclination = 63.4;
+    tles[1].eccentricity = 0.72;
+    tles[1].mean_motion = 2.006;
+    
+    SatelliteSystem sys = create_satellite_system(tles);
+    auto paths = sample_orbit_paths(sys, {0, 1, 5}, 0.0, 0.0);
+    
+    // Samples near perigee of the eccentric orbit are closer in time
+    const auto& m = paths[1];
+    double perigee_gap = 1e9, apogee_gap = 0.0, min_r = 1e9;
+    for (size_t k = 0; k + 1 < m.times_minutes.size(); ++k) {
+        double r = std::sqrt(m.x[k]*m.x[k] + m.y[k]*m.y[k] + m.z[k]*m.z[k]);
+        double gap = m.times_minutes[k + 1] - m.times_minutes[k];
+        if (r < min_r) { min_r = r; perigee_gap = gap; }
+        apogee_gap = std::max(apogee_gap, gap);
+    }
+    
+    // Sampled points agree with full-catalog propagation
+    double t = paths[0].times_minutes[3];
+    propagate_all_optimized(sys, t);
+    double err = std::abs(sys.x[0] - paths[0].x[3]) + std::abs(sys.z[0] - paths[0].z[3]);
+    
+    std::cout << "(circular: " << paths[0].times_minutes.size()
+              << ", eccentric: " << m.times_minutes.size() << " samples) ";
+    return assert_true(paths.size() == 3 && paths[2].times_minutes.empty(), "Invalid index yields empty path") &&
+           assert_true(paths[0].times_minutes.size() > 10 && paths[0].times_minutes.size() < 500, "Circular sample count") &&
+           assert_true(perigee_gap * 4.0 < apogee_gap, "Dense at perigee, sparse at apogee") &&
+           assert_true(err < 1e-9, "Matches batch propagation");
+}
+
+bool test_state_queries_match_propagation() {
+    std::vector<TLE> tles(50);
+    for (size_t i = 0; i < tles.size(); ++i) {
+        tles[i].inclination = 30.0 + static_cast<double>(i);
+        tles[i].eccentricity = 0.001 * static_cast<double>(i);
+        tles[i].mean_motion = 14.0 + 0.02 * static_cast<double>(i);
+    }
+    SatelliteSystem sys = create_satellite_system(tles);
+    
+    // Unordered queries with a repeated pair and an invalid index
+    std::vector<StateQuery> queries = {{7, 30.0}, {3, 10.0}, {7, 5.0}, {3, 10.0}, {99, 0.0}, {49, 1440.0}};
+    std::vector<double> out(6 * queries.size());
+    const size_t n = queries.size();
+    StateArrays arrays{&out[0], &out[n], &out[2 * n], &out[3 * n], &out[4 * n], &out[5 * n]};
+    bool complete = propagate_states(sys, queries, arrays);
+    
+    double max_err = 0.0;
+    for (size_t q = 0; q < n; ++q) {
+        if (queries[q].index >= sys.count) continue;
+        propagate_all_optimized(sys, queries[q].time_minutes);
+        size_t i = queries[q].index;
+        max_err = std::max({max_err, std::abs(arrays.x[q] - sys.x[i]),
+                            std::abs(arrays.vz[q] - sys.vz[i])});
+    }
+    
+    return assert_true(complete, "All queries evaluated") &&
+           assert_true(max_err < 1e-9, "States match batch propagation") &&
+           assert_true(arrays.y[1] == arrays.y[3], "Repeated pair yields the same state") &&
+           assert_true(std::isnan(arrays.x[4]), "Invalid index yields NaN");
+}
+
+// ============================================================================
+// Neighbour Query Tests
+// ============================================================================
+
+bool test_neighbor_queries_match_brute_force() {
+    std::vector<TLE> tles(2000);
+    for (size_t i = 0; i < tles.size(); ++i) {
+        tles[i].catalog_number = static_cast<int>(i);
+        tles[i].inclination = 20.0 + 0.03 * static_cast<double>(i);
+        tles[i].raan = 0.7 * static_cast<double>(i);
+        tles[i].mean_anomaly = 1.3 * static_cast<double>(i);
+        tles[i].mean_motion = (i % 10 == 0) ? 1.0027 : 14.0 + 0.001 * static_cast<double>(i);
+    }
+    SatelliteSystem sys = create_satellite_system(tles);
+    propagate_all_optimized(sys, 30.0);
+    
+    SpatialGrid grid(50.0);
+    grid.build(sys);
+    
+    // Brute-force distances from object 5 (LEO) and from a GEO point
+    auto brute = [&sys](const Vec3& p, size_t exclude) {
+        std::vector<double> d;
+        for (size_t i = 0; i < sys.count; ++i) {
+            if (i == exclude) continue;
+            d.push_back(std::sqrt((sys.x[i]-p.x)*(sys.x[i]-p.x) + (sys.y[i]-p.y)*(sys.y[i]-p.y) +
+                                  (sys.z[i]-p.z)*(sys.z[i]-p.z)));
+        }
+        std::sort(d.begin(), d.end());
+        return d;
+    };
+    
+    bool ok = true;
+    const Vec3 centers[2] = {{sys.x[5], sys.y[5], sys.z[5]}, {42164.0, 0.0, 0.0}};
+    for (int c = 0; c < 2; ++c) {
+        size_t exclude = c == 0 ? 5 : SIZE_MAX;
+        auto expected = brute(centers[c], exclude);
+        
+        auto knn = grid.query_knn(sys, centers[c], 20, exclude);
+        ok = ok && knn.size() == 20;
+        for (size_t j = 0; ok && j < knn.size(); ++j) {
+            ok = std::abs(knn[j].distance_km - expected[j]) < 1e-9;
+        }
+        
+        double radius = expected[49] + 1e-6;
+        auto within = grid.query_radius(sys, centers[c], radius, exclude);
+        ok = ok && within.size() == 50 && std::is_sorted(within.begin(), within.end(),
+            [](const Neighbor& a, const Neighbor& b) { return a.distance_km < b.distance_km; });
+    }
+    
+    return assert_true(ok, "kNN and radius results match brute force");
+}
+
+// ============================================================================
+// Conjunction Monitor Tests
+// ============================================================================
+
+bool test_monitor_screens_encounters() {
+    // Two objects trailing each other by ~7 km, plus an unrelated one
+    std::vector<TLE> tles(3);
+    for (auto& tle : tles) {
+        tle.inclination = 51.6;
+        tle.mean_motion = 15.5;
+    }
+    tles[1].mean_anomaly = 0.06;
+    tles[2].raan = 90.0;
+    SatelliteSystem sys = create_satellite_system(tles);
+    
+    MonitorConfig config;
+    config.horizon_minutes = 120.0;
+    auto events = screen_window(sys, 0.0, config.horizon_minutes, config);
+    
+    return assert_true(events.size() == 1, "One continuous encounter") &&
+           assert_true(events[0].sat1_id == 0 && events[0].sat2_id == 1, "Pair by index") &&
+           assert_true(events[0].miss_distance_km < 10.0, "Within threshold") &&
+           assert_true(events[0].collision_probability >= 0.0, "Pc computed");
+}
+
+bool test_monitor_event_table_diffs() {
+    MonitorConfig config;
+    ConjunctionEventTable table(config);
+    
+    auto make = [](uint32_t a, uint32_t b, double tca, double miss) {
+        MonitoredConjunction event;
+        event.sat1_id = a;
+        event.sat2_id = b;
+        event.tca_minutes = tca;
+        event.miss_distance_km = miss;
+        return event;
+    };
+    
+    auto first = table.apply({make(1, 2, 100.0, 5.0), make(3, 4, 200.0, 2.0)}, 0.0, 1000.0);
+    uint64_t id12 = table.events()->front().event_id;
+    
+    // (1,2) drifts slightly, (3,4) tightens, (5,6) appears, nothing resolves
+    auto second = table.apply({make(1, 2, 101.0, 5.1), make(3, 4, 200.5, 1.0), make(5, 6, 300.0, 8.0)}, 0.0, 1000.0);
+    
+    // (3,4) and (5,6) are no longer predicted
+    auto third = table.apply({make(1, 2, 100.5, 5.0)}, 0.0, 1000.0);
+    
+    // Passed events expire silently
+    size_t expired = table.expire_before(150.0);
+    
+    auto count = [](const std::vector<ConjunctionUpdate>& updates, UpdateKind kind) {
+        return std::count_if(updates.begin(), updates.end(),
+                             [kind](const ConjunctionUpdate& u) { return u.kind == kind; });
+    };
+    
+    return assert_true(first.size() == 2 && count(first, UpdateKind::NEW) == 2, "Initial events are new") &&
+           assert_true(second.size() == 2 && count(second, UpdateKind::CHANGED) == 1 &&
+                       count(second, UpdateKind::NEW) == 1, "Only material changes reported") &&
+           assert_true(third.size() == 2 && count(third, UpdateKind::RESOLVED) == 2, "Unpredicted events resolve") &&
+           assert_true(expired == 1 && table.events()->empty(), "Passed events expire") &&
+           assert_true(id12 != 0, "Stable event ids assigned");
+}
+
+bool test_screening_horizon_incremental() {
+    // Objects 0 and 1 cross at the nodes every half revolution; object 2
+    // starts elsewhere and is later moved onto the same crossing. Objects 3
+    // and 4 sit in higher shells. 200 spread-out MEO objects keep a single
+    // change below the full re-screen fraction.
+    std::vector<TLE> tles(205);
+    for (size_t i = 0; i < tles.size(); ++i) {
+        tles[i].catalog_number = 100 + static_cast<int>(i);
+        tles[i].inclination = 51.6;
+        tles[i].mean_motion = 15.5;
+    }
+    for (size_t i = 5; i < tles.size(); ++i) {
+        tles[i].mean_motion = 2.0 + 0.02 * static_cast<double>(i);
+        tles[i].raan = 7.0 * static_cast<double>(i);
+        tles[i].mean_anomaly = 13.0 * static_cast<double>(i);
+        tles[i].inclination = 20.0 + 0.3 * static_cast<double>(i);
+    }
+    tles[1].inclination = 52.6;
+    tles[2].raan = 90.0;
+    tles[2].mean_anomaly = 120.0;
+    tles[3].mean_motion = 13.0;
+    tles[4].mean_motion = 14.0;
+    tles[4].raan = 45.0;
+    
+    MonitorConfig config;
+    config.horizon_minutes = 120.0;
+    
+    auto same_events = [](std::vector<MonitoredConjunction> a, std::vector<MonitoredConjunction> b) {
+        auto by_pair = [](const MonitoredConjunction& x, const MonitoredConjunction& y) {
+            return std::tie(x.sat1_id, x.sat2_id, x.tca_minutes) < std::tie(y.sat1_id, y.sat2_id, y.tca_minutes);
+        };
+        std::sort(a.begin(), a.end(), by_pair);
+        std::sort(b.begin(), b.end(), by_pair);
+        if (a.size() != b.size()) return false;
+        for (size_t k = 0; k < a.size(); ++k) {
+            if (a[k].sat1_id != b[k].sat1_id || a[k].sat2_id != b[k].sat2_id ||
+                std::abs(a[k].tca_minutes - b[k].tca_minutes) > 1e-9 ||
+                std::abs(a[k].miss_distance_km - b[k].miss_distance_km) > 1e-9) return false;
+        }
+        return true;
+    };
+    
+    ConjunctionEventTable table(config);
+    ScreeningHorizon horizon(table, config);
+    horizon.reset(create_satellite_system(tles), 0.0);
+    
+    // Screen the window in chunks, as a cold server does
+    while (horizon.advance(0.0, 25) == 25) {}
+    SatelliteSystem full = create_satellite_system(tles);
+    bool initial_ok = !table.events()->empty() &&
+                      same_events(*table.events(), screen_window(full, 0.0, 120.0, config));
+    
+    // Re-publishing an identical catalog re-screens nothing
+    uint64_t generation = table.generation();
+    size_t unchanged = horizon.update_catalog(create_satellite_system(tles), 0.0);
+    bool unchanged_ok = unchanged == 0 && table.generation() == generation;
+    
+    // Move object 2 onto the crossing: only it is re-screened
+    tles[2].raan = 0.0;
+    tles[2].mean_anomaly = 0.0;
+    tles[2].inclination = 50.6;
+    size_t rescreened = horizon.update_catalog(create_satellite_system(tles), 0.0);
+    SatelliteSystem moved = create_satellite_system(tles);
+    auto expected = screen_window(moved, 0.0, 120.0, config);
+    bool involves_2 = std::any_of(expected.begin(), expected.end(),
+                                  [](const MonitoredConjunction& e) { return e.sat2_id == 2; });
+    
+    // An event whose encounter is still open at the re-screened frontier is
+    // held, then updated in place when the encounter closes
+    ConjunctionEventTable held_table(config);
+    MonitoredConjunction held_event;
+    held_event.sat1_id = 0;
+    held_event.sat2_id = 1;
+    held_event.tca_minutes = 118.0;
+    held_event.miss_distance_km = 4.0;
+    held_table.add({held_event});
+    const uint64_t held_id = held_table.events()->front().event_id;
+    std::vector<MonitoredConjunction> frontier = {held_event};
+    frontier[0].tca_minutes = 120.0;
+    const auto rescreen_updates = held_table.apply({}, 0.0, 120.0, nullptr, &frontier);
+    MonitoredConjunction closing = held_event;
+    closing.tca_minutes = 121.0;
+    closing.miss_distance_km = 2.0;
+    const auto close_updates = held_table.add({closing});
+    const bool held_ok = rescreen_updates.empty() && close_updates.size() == 1 &&
+                         close_updates[0].kind == UpdateKind::CHANGED && close_updates[0].event.event_id == held_id &&
+                         held_table.events()->size() == 1;
+    
+    return assert_true(initial_ok, "Incremental slices match a full window screen") &&
+           assert_true(unchanged_ok, "Unchanged catalog produces no updates") &&
+           assert_true(rescreened == 1 && involves_2, "Only the changed object is re-screened") &&
+           assert_true(same_events(*table.events(), expected), "Partial re-screen matches a full screen") &&
+           assert_true(held_ok, "Frontier events are updated, not resolved and re-added");
+}
+
+// ============================================================================
+// Stage Metrics Tests
+// ============================================================================
+
+bool test_stage_metrics_prometheus() {
+    StageMetrics metrics;
+    for (int step = 0; step < 2; ++step) {
+        StageTimings timings;
+        {
+            ScopedStageTimer timer(timings, Stage::PROPAGATE);
+            auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(2);
+            while (std::chrono::steady_clock::now() < until) {}
+        }
+        timings.add(StageCounter::HITS, 5);
+        metrics.record(timings);
+    }
+    
+    auto propagate = metrics.histogram(Stage::PROPAGATE);
+    double mean = propagate.sum_seconds / static_cast<double>(propagate.count);
+    
+    // Scrape the page over the loopback endpoint
+    MetricsEndpoint endpoint(0, [&metrics] {
+        std::string out;
+        metrics.render_prometheus(out);
+        return out;
+    });
+    std::string response;
+    if (endpoint.start()) {
+        int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(endpoint.port());
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) {
+            const std::string request = "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n";
+            ::send(fd, request.data(), request.size(), 0);
+            char buf[4096];
+            ssize_t n;
+            while ((n = ::recv(fd, buf, sizeof(buf), 0)) > 0) response.append(buf, static_cast<size_t>(n));
+        }
+        ::close(fd);
+        endpoint.stop();
+    }
+    
+    return assert_true(propagate.count == 2 && metrics.histogram(Stage::MONTE_CARLO).count == 0,
+                       "Only stages that ran are observed") &&
+           assert_true(mean > 1e-3 && mean < 1.0, "TSC timings calibrated to seconds") &&
+           assert_true(metrics.total(StageCounter::HITS) == 10, "Counters accumulate") &&
+           assert_true(response.rfind("HTTP/1.1 200", 0) == 0, "Endpoint serves /metrics") &&
+           assert_true(response.find("orbitops_stage_duration_seconds_count{stage=\"propagate\"} 2") != std::string::npos &&
+                       response.find("orbitops_stage_duration_seconds_bucket{stage=\"propagate\",le=\"+Inf\"} 2") != std::string::npos &&
+                       response.find("orbitops_hits_total 10") != std::string::npos,
+                       "Histogram and counters in Prometheus text format");
+}
+
+bool test_trace_rings_and_json() {
+    trace::clear();
+    const uint64_t since = cycle_count();
+    
+    // One span per worker, recorded into per-thread rings
+    int workers = 1;
+    #pragma omp parallel
+    {
+        trace::Scope scope("test.worker", 7);
+        #ifdef _OPENMP
+        #pragma omp single
+        workers = omp_get_num_threads();
+        #endif
+    }
+    std::string json = trace::chrome_json(since);
+    size_t spans = 0;
+    for (size_t pos = json.find("\"test.worker\""); pos != std::string::npos;
+         pos = json.find("\"test.worker\"", pos + 1)) {
+        spans++;
+    }
+    
+    // A lapped ring keeps its newest events, minus the slot the next push
+    // overwrites (a concurrent writer may be tearing it)
+    trace::ThreadRing ring(99);
+    for (size_t i = 0; i < trace::ThreadRing::CAPACITY + 10; ++i) {
+        ring.push({"x", i, i + 1, -1});
+    }
+    std::vector<trace::Event> events;
+    ring.snapshot(events);
+    
+    // A thread that inherits an exited thread's ring gets its own track
+    auto span_tid = [](const std::string& name) {
+        std::string json = trace::chrome_json();
+        size_t pos = json.find("\"" + name + "\"");
+        if (pos == std::string::npos) return std::string();
+        pos = json.find("\"tid\":", pos) + 6;
+        return json.substr(pos, json.find(',', pos) - pos);
+    };
+    std::thread([] { trace::record("test.first_thread", cycle_count(), cycle_count()); }).join();
+    const std::string first_tid = span_tid("test.first_thread");
+    std::thread([] { trace::record("test.second_thread", cycle_count(), cycle_count()); }).join();
+    const std::string second_tid = span_tid("test.second_thread");
+    
+    return assert_true(spans == static_cast<size_t>(workers), "One span per OpenMP worker") &&
+           assert_true(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0) == 0 &&
+                       json.find("\"ph\":\"X\"") != std::string::npos &&
+                       json.find("\"args\":{\"n\":7}") != std::string::npos, "Chrome trace-event JSON") &&
+           assert_true(events.size() == trace::ThreadRing::CAPACITY - 1 && events.front().start == 11 &&
+                       events.back().start == trace::ThreadRing::CAPACITY + 9,
+                       "Ring keeps the newest events") &&
+           assert_true(!first_tid.empty() && !second_tid.empty() && first_tid != second_tid,
+                       "Reused ring gets a new tid");
+}
+
+bool test_flight_recorder_dumps_slow_requests() {
+    const std::string dir = "/tmp/orbitops_flight_recorder_test";
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+    
+    FlightRecorderConfig config;
+    config.capacity = 4;
+    config.default_slo_ms = 1000.0;
+    config.method_slo_ms["Slow"] = 1.0;
+    config.dump_directory = dir;
+    
+    size_t described = 0;
+    FlightRecorder::Stats stats;
+    std::vector<RequestRecord> recent;
+    {
+        FlightRecorder recorder(config);
+        for (int i = 0; i < 5; ++i) {
+            FlightRecorder::Request fast(recorder, "Fast", 7, [&] { described++; return std::string("fast"); });
+        }
+        {
+            FlightRecorder::Request slow(recorder, "Slow", 8, [&] { described++; return std::string("ids: \"a\""); });
+            slow.timings().add(StageCounter::HITS, 3);
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        recorder.flush();
+        stats = recorder.get_stats();
+        recent = recorder.recent();
+    }
+    
+    // Back-to-back slow requests against a one-dump budget
+    FlightRecorderConfig budget_config = config;
+    budget_config.max_dumps = 1;
+    budget_config.min_dump_interval_seconds = 0.0;
+    budget_config.dump_directory = dir + "/budget";
+    FlightRecorder::Stats budget_stats;
+    {
+        FlightRecorder recorder(budget_config);
+        for (int i = 0; i < 4; ++i) {
+            FlightRecorder::Request slow(recorder, "Slow", 9);
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        recorder.flush();
+        budget_stats = recorder.get_stats();
+    }
+    
+    std::string dump;
+    for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+        if (!entry.is_regular_file()) continue;
+        std::ifstream file(entry.path());
+        dump.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    std::filesystem::remove_all(dir, ec);
+    
+    return assert_true(recent.size() == 4 && recent.back().slow, "Bounded ring of recent requests") &&
+           assert_true(described == 1, "Only slow requests are described") &&
+           assert_true(stats.slow_requests == 1 && stats.dumps_written == 1, "Slow request dumped") &&
+           assert_true(budget_stats.dumps_written == 1 && budget_stats.dumps_suppressed == 3,
+                       "Dumps never exceed max_dumps") &&
+           assert_true(dump.find("\"method\":\"Slow\"") != std::string::npos &&
+                       dump.find("\"catalog_version\":8") != std::string::npos &&
+                       dump.find("\"params\":\"ids: \\\"a\\\"\"") != std::string::npos &&
+                       dump.find("\"hits\":3") != std::string::npos &&
+                       dump.find("\"trace\":{") != std::string::npos, "Dump holds request, version, timings and trace");
+}
+
+bool test_sharded_screening_matches_single_process() {
+    // Node crossings every half revolution for three pairs, plus a higher shell
+    std::vector<TLE> tles(5);
+    for (size_t i = 0; i < tles.size(); ++i) {
+        tles[i].catalog_number = 200 + static_cast<int>(i);
+        tles[i].inclination = 51.6 + static_cast<double>(i);
+        tles[i].mean_motion = 15.5;
+    }
+    tles[4].mean_motion = 13.0;
+    SatelliteSystem sys = create_satellite_system(tles);
+    
+    MonitorConfig config;
+    const double end = 300.0;
+    auto expected = screen_window(sys, 0.0, end, config);
+    std::sort(expected.begin(), expected.end(), [](const MonitoredConjunction& a, const MonitoredConjunction& b) {
+        return std::tie(a.tca_minutes, a.sat1_id, a.sat2_id) < std::tie(b.tca_minutes, b.sat1_id, b.sat2_id);
+    });
+    
+    ShardingConfig sharding;
+    sharding.workers = 3;
+    sharding.threads_per_worker = 1;
+    auto result = screen_sharded(sys, 0.0, end, config, sharding);
+    
+    bool same = result.success && result.events.size() == expected.size();
+    for (size_t k = 0; same && k < expected.size(); ++k) {
+        const auto& a = result.events[k];
+        const auto& b = expected[k];
+        same = a.sat1_id == b.sat1_id && a.sat2_id == b.sat2_id &&
+               std::abs(a.tca_minutes - b.tca_minutes) < 1e-6 &&
+               std::abs(a.miss_distance_km - b.miss_distance_km) < 1e-6;
+    }
+    
+    // Boundary duplicates collapse to the closer approach
+    MonitoredConjunction first, second;
+    first.sat1_id = second.sat1_id = 1;
+    first.sat2_id = second.sat2_id = 2;
+    first.tca_minutes = 100.0;
+    first.miss_distance_km = 3.0;
+    second.tca_minutes = 100.5;
+    second.miss_distance_km = 2.0;
+    size_t duplicates = 0;
+    auto merged = merge_shard_events({{first}, {second}}, config.tca_match_minutes, &duplicates);
+    
+    return assert_true(result.success, ("Workers ran " + result.error_message).c_str()) &&
+           assert_true(result.shards == 3 && expected.size() > 3, "Work split across shards") &&
+           assert_true(same, "Merged shard results match single-process screening") &&
+           assert_true(merged.size() == 1 && duplicates == 1 && merged[0].miss_distance_km == 2.0,
+                       "Duplicates keep the closer approach");
+}
+
+// ============================================================================
+// Debris Tests
+// ============================================================================
+
+bool test_debris_system_masks() {
+    auto make = [](const char* name, const char* designator, int catalog, double mean_motion, double bstar) {
+        TLE tle;
+        tle.name = name;
+        tle.intl_designator = designator;
+        tle.catalog_number = catalog;
+        tle.mean_motion = mean_motion;
+        tle.eccentricity = 0.001;
+        tle.bstar = bstar;
+        return tle;
+    };
+    std::vector<TLE> tles = {
+        make("STARLINK-1007", "19074A", 44713, 15.0, 0.0),         // Payload, not debris
+        make("COSMOS 2251 DEB", "93036SX", 90000, 14.5, 0.0),      // Large LEO payload debris
+        make("CZ-3B R/B", "12018C", 38253, 2.0, 0.0),              // MEO rocket body
+        make("FENGYUN 1C DEB", "99025AB", 29000, 14.2, 0.006),     // Medium LEO fragments...
+        make("FENGYUN 1C DEB", "99025CD", 29001, 14.2, 0.0),
+        make("FENGYUN 1C DEB", "99025EF", 29002, 14.2, 0.0),       // ...three from one launch
+    };
+    
+    SatelliteSystem sys = create_satellite_system(tles);
+    DebrisModel model;
+    model.load(tles, sys);
+    const DebrisSystem& debris = model.debris();
+    
+    const uint32_t leo = debris_flag(OrbitRegime::LEO);
+    const uint32_t large_or_medium = debris_flag(DebrisSize::LARGE) | debris_flag(DebrisSize::MEDIUM);
+    
+    return assert_true(debris.count == 5 && debris.index[0] == 1, "Rows index into the system") &&
+           assert_true(model.get_debris_by_type(DebrisType::ROCKET_BODY) == std::vector<uint32_t>{1},
+                       "Rocket body by type") &&
+           assert_true(model.get_debris_by_type(DebrisType::FRAGMENTATION) == std::vector<uint32_t>{2, 3, 4},
+                       "Fragments by type") &&
+           assert_true(select_debris(debris, leo | debris_flag(DebrisSize::MEDIUM)) == std::vector<uint32_t>{2},
+                       "Groups ANDed") &&
+           assert_true(select_debris(debris, leo | large_or_medium) == std::vector<uint32_t>{0, 2, 3, 4},
+                       "Bits within a group ORed") &&
+           assert_true(model.get_debris_in_shell(0.0, 2000.0).size() == 4, "LEO shell") &&
+           assert_true(orbit_regime(debris.flags[1]) == OrbitRegime::MEO &&
+                       debris_risk(debris.flags[1]) == DebrisRisk::LOW, "Regime and baseline risk decode") &&
+           assert_true(model.get_debris_fields().size() == 1 &&
+                       model.get_debris_fields()[0].debris_ids.size() == 3, "One field per launch") &&
+           assert_true(model.get_object(1, sys).name == "CZ-3B R/B" &&
+                       model.get_statistics().rocket_bodies == 1, "Materialized object and statistics");
+}
+
+bool test_shell_density_histogram() {
+    // 40 debris objects spread over LEO at two inclinations
+    std::vector<TLE> tles(40);
+    for (size_t i = 0; i < tles.size(); ++i) {
+        tles[i].name = "OBJECT DEB " + std::to_string(i);
+        tles[i].mean_motion = 12.5 + 0.06 * i;
+        tles[i].inclination = (i % 2) ? 98.0 : 53.0;
+        tles[i].eccentricity = 0.0005;
+    }
+    SatelliteSystem sys = create_satellite_system(tles);
+    DebrisModel model;
+    model.load(tles, sys);
+    
+    ShellBinning binning;
+    binning.inclination_bins = 2;
+    auto table = model.shell_densities(sys, binning);
+    auto again = model.shell_densities(sys, binning);
+    
+    // Brute force: mean altitude shells, prograde/retrograde halves
+    const auto& debris = model.debris();
+    std::vector<uint32_t> expected(table->counts.size(), 0);
+    for (size_t row = 0; row < debris.count; ++row) {
+        const double alt = debris.mean_altitude_km[row];
+        if (alt < 200.0 || alt >= 2000.0) continue;
+        const size_t shell = static_cast<size_t>((alt - 200.0) / 50.0);
+        const size_t band = sys.incl[debris.index[row]] > M_PI / 2 ? 1 : 0;
+        expected[shell * 2 + band]++;
+    }
+    
+    double flux_sum = 0.0;
+    for (double f : table->flux) flux_sum += f;
+    double shell_sum = 0.0;
+    for (const auto& shell : model.calculate_shell_densities(sys)) shell_sum += shell.flux;
+    
+    model.load(tles, sys);
+    auto reloaded = model.shell_densities(sys, binning);
+    
+    return assert_true(table->counts == expected, "Histogram matches brute force") &&
+           assert_true(again == table, "Cached per catalog version") &&
+           assert_true(reloaded != table && reloaded->catalog_version == model.catalog_version(),
+                       "Reload invalidates the cache") &&
+           assert_near(shell_sum, flux_sum, 1e-12 * flux_sum) &&
+           assert_near(table->shell_flux(debris.mean_altitude_km[0]),
+                       table->flux[table->cell(debris.mean_altitude_km[0], 0.0)] +
+                       table->flux[table->cell(debris.mean_altitude_km[0], 179.0)], 1e-18);
+}
+
+bool test_fleet_risk_matches_linear_scan() {
+    // Dense LEO population: every third object is a payload, the rest debris
+    std::vector<TLE> tles(3000);
+    for (size_t i = 0; i < tles.size(); ++i) {
+        tles[i].name = (i % 3 == 0) ? "SAT " + std::to_string(i) : "FRAG " + std::to_string(i);
+        tles[i].catalog_number = static_cast<int>(i);
+        tles[i].inclination = 50.0 + 0.01 * static_cast<double>(i);
+        tles[i].raan = 0.05 * static_cast<double>(i);
+        tles[i].mean_anomaly = 0.11 * static_cast<double>(i);
+        tles[i].mean_motion = 14.8 + 0.0001 * static_cast<double>(i);
+        tles[i].eccentricity = 0.001;
+    }
+    SatelliteSystem sys = create_satellite_system(tles);
+    propagate_all_optimized(sys, 45.0);
+    
+    DebrisModel model;
+    model.load(tles, sys);
+    
+    std::vector<uint32_t> fleet;
+    for (uint32_t i = 0; i < sys.count; i += 3) fleet.push_back(i);
+    
+    auto assessments = model.assess_risk_fleet(sys, fleet, 45.0);
+    
+    bool same = assessments.size() == fleet.size();
+    size_t with_neighbors = 0;
+    for (size_t f = 0; same && f < fleet.size(); ++f) {
+        const uint32_t i = fleet[f];
+        const Vec3 p{sys.x[i], sys.y[i], sys.z[i]};
+        auto linear = model.assess_risk(sys, static_cast<int>(i), p, p.magnitude() - 6371.0);
+        const auto& fast = assessments[f];
+        
+        same = fast.nearby_debris_count == linear.nearby_debris_count &&
+               fast.overall_risk == linear.overall_risk &&
+               fast.closest_debris.size() == linear.closest_debris.size() &&
+               std::abs(fast.estimated_flux - linear.estimated_flux) <= 1e-12 * linear.estimated_flux;
+        for (size_t k = 0; same && k < fast.closest_debris.size(); ++k) {
+            same = std::abs(fast.closest_debris[k].second - linear.closest_debris[k].second) < 1e-9;
+        }
+        with_neighbors += fast.nearby_debris_count > 0;
+    }
+    
+    return assert_true(with_neighbors > 0, "Fleet has debris neighbours") &&
+           assert_true(same, "Indexed fleet assessment matches linear scan");
+}
+
+bool test_breakup_fragments_inject() {
+    std::vector<TLE> tles(1);
+    tles[0].name = "TEST SAT";
+    tles[0].inclination = 98.0;
+    tles[0].mean_motion = 14.5;
+    tles[0].eccentricity = 0.001;
+    SatelliteSystem sys = create_satellite_system(tles);
+    
+    BreakupEvent event;
+    event.kind = BreakupKind::EXPLOSION;
+    event.parent = 0;
+    event.time_minutes = 30.0;
+    event.min_length_m = 0.05;
+    
+    auto result = simulate_breakup(sys, event);
+    auto repeat = simulate_breakup(sys, event);
+    const FragmentCloud& cloud = result.fragments;
+    
+    const size_t injected = inject_fragments(sys, cloud, "TEST SAT", 900000);
+    
+    // Every fragment starts at the parent's position at the breakup epoch
+    propagate_all_optimized(sys, event.time_minutes);
+    double max_offset = 0.0;
+    double max_dv = 0.0;
+    for (size_t i = 1; i < sys.count; ++i) {
+        max_offset = std::max(max_offset, std::abs(sys.x[i] - cloud.parent_position.x) +
+                                          std::abs(sys.y[i] - cloud.parent_position.y) +
+                                          std::abs(sys.z[i] - cloud.parent_position.z));
+        const double dvx = sys.vx[i] - cloud.parent_velocity.x;
+        const double dvy = sys.vy[i] - cloud.parent_velocity.y;
+        const double dvz = sys.vz[i] - cloud.parent_velocity.z;
+        max_dv = std::max(max_dv, std::sqrt(dvx * dvx + dvy * dvy + dvz * dvz));
+    }
+    double cloud_max_dv = 0.0;
+    for (size_t k = 0; k < cloud.count; ++k) {
+        cloud_max_dv = std::max(cloud_max_dv, std::sqrt(cloud.dvx[k] * cloud.dvx[k] +
+                                                        cloud.dvy[k] * cloud.dvy[k] +
+                                                        cloud.dvz[k] * cloud.dvz[k]));
+    }
+    
+    // The cloud spreads and screens as ordinary catalog objects
+    propagate_all_optimized(sys, event.time_minutes + 10.0);
+    SpatialGrid grid(10.0);
+    grid.build(sys);
+    const auto pairs = grid.find_close_pairs(sys, 10.0);
+    
+    return assert_true(result.success && cloud.count == breakup_fragment_count(event) && cloud.count > 500,
+                       "Fragment count from the size power law") &&
+           assert_true(repeat.fragments.dvx == cloud.dvx && repeat.fragments.mass_kg == cloud.mass_kg,
+                       "Deterministic for a seed") &&
+           assert_true(injected > 0 && sys.count == 1 + injected && sys.object_class.back() == OBJECT_DEBRIS &&
+                       sys.catalog_numbers[1] == 900000, "Fragments appended as debris") &&
+           assert_true(max_offset < 1e-6, "Fragments start at the parent position") &&
+           assert_true(max_dv <= cloud_max_dv + 1e-9, "Fragment velocities are parent plus delta-v") &&
+           assert_true(!pairs.empty(), "Cloud screened by the grid") &&
+           assert_true(!simulate_breakup(sys, BreakupEvent{BreakupKind::EXPLOSION, 999999}).success,
+                       "Bad parent rejected");
+}
+
+bool test_small_debris_flux_table() {
+    // Tracked debris concentrated near 800 km, plus one payload to assess
+    std::vector<TLE> tles(201);
+    for (size_t i = 0; i < 200; ++i) {
+        tles[i].name = "FRAG " + std::to_string(i);
+        tles[i].mean_motion = 14.2 + 0.001 * static_cast<double>(i % 20);
+        tles[i].inclination = 97.0 + 0.02 * static_cast<double>(i);
+        tles[i].raan = 1.7 * static_cast<double>(i);
+        tles[i].eccentricity = 0.001;
+    }
+    tles[200].name = "PAYLOAD";
+    tles[200].mean_motion = 14.25;
+    tles[200].inclination = 53.0;
+    SatelliteSystem sys = create_satellite_system(tles);
+    
+    DebrisConfig config;
+    config.include_small_debris = true;
+    DebrisModel model(config);
+    model.load(tles, sys);
+    const SmallDebrisFluxTable& table = model.small_debris_flux();
+    
+    // Batch interpolation matches scalar lookups, including out-of-range points
+    std::vector<double> alt = {150.0, 350.0, 812.5, 830.0, 1999.0, 2500.0};
+    std::vector<double> incl = {53.0, 0.0, 98.0, 53.0, 179.0, 53.0};
+    std::vector<double> batch(alt.size());
+    table.flux_batch(alt.data(), incl.data(), alt.size(), batch.data());
+    bool batch_ok = true;
+    for (size_t k = 0; k < alt.size(); ++k) {
+        batch_ok = batch_ok && std::abs(batch[k] - table.flux(alt[k], incl[k])) <= 1e-12 * (1.0 + batch[k]);
+    }
+    
+    std::vector<double> directional(table.config().direction_bins, 0.0);
+    table.accumulate_directional(830.0, 53.0, directional.data());
+    double directional_sum = 0.0;
+    for (double d : directional) directional_sum += d;
+    
+    SmallDebrisExposure exposure;
+    auto assessed = model.assess_small_debris(sys, {200}, exposure);
+    exposure.area_m2 *= 2.0;
+    auto larger = model.assess_small_debris(sys, {200}, exposure);
+    const double sat_alt = sys.a0[200] - 6371.0;
+    
+    DebrisModel tracked_only;
+    tracked_only.load(tles, sys);
+    
+    return assert_true(!table.empty() && tracked_only.small_debris_flux().empty(), "Table built only when enabled") &&
+           assert_true(table.flux(830.0, 53.0) > 10.0 * table.flux(1500.0, 53.0), "Flux follows the population") &&
+           assert_true(batch[0] == 0.0 && batch[5] == 0.0, "Zero outside the grid") &&
+           assert_true(batch_ok, "Batch matches scalar interpolation") &&
+           assert_near(directional_sum, table.flux(830.0, 53.0), 1e-12 * directional_sum) &&
+           assert_true(assessed.size() == 1 &&
+                       std::abs(assessed[0].mean_flux - table.flux(sat_alt, 53.0)) < 0.05 * assessed[0].mean_flux,
+                       "Orbit average of a circular orbit") &&
+           assert_true(assessed[0].penetration_probability > 0.0 &&
+                       larger[0].penetration_probability > assessed[0].penetration_probability,
+                       "Penetration risk scales with area");
+}
+
+bool test_debris_evolution_decay() {
+    // Debris at 300, 500 and 1500 km (mean motion in rev/day as parsed)
+    const double rev_per_day[] = {15.92, 15.22, 12.63};
+    std::vector<TLE> tles(30);
+    for (size_t i = 0; i < tles.size(); ++i) {
+        tles[i].name = "DEB " + std::to_string(i);
+        tles[i].mean_motion = rev_per_day[i % 3];
+        tles[i].inclination = 51.6 + static_cast<double>(i);
+        tles[i].eccentricity = 0.001;
+        tles[i].bstar = 1e-3;
+    }
+    SatelliteSystem sys = create_satellite_system(tles);
+    DebrisModel model;
+    model.load(tles, sys);
+    
+    EvolutionConfig config;
+    config.duration_years = 10.0;
+    config.snapshot_interval_days = 365.25;
+    auto result = model.evolve_environment(sys, config);
+    
+    // Decay is faster at solar maximum
+    EvolutionConfig quiet = config;
+    quiet.solar.mean_f107 = 70.0;
+    quiet.solar.amplitude = 0.0;
+    EvolutionConfig active = quiet;
+    active.solar.mean_f107 = 250.0;
+    auto slow = model.evolve_environment(sys, quiet);
+    auto fast = model.evolve_environment(sys, active);
+    
+    bool ordered = true;
+    bool balanced = true;
+    for (size_t i = 0; i < result.initial_count; ++i) {
+        const uint32_t row = model.debris().index[i];
+        const double alt = sys.a0[row] - 6371.0;
+        if (alt < 400.0) ordered = ordered && result.reentry_days[i] >= 0.0f && result.reentry_days[i] < 365.0f;
+        else if (alt < 1000.0) ordered = ordered && result.reentry_days[i] > 365.0f;
+        else ordered = ordered && result.reentry_days[i] < 0.0f;
+        ordered = ordered && fast.reentry_days[i] <= slow.reentry_days[i] + (slow.reentry_days[i] < 0.0f ? 1e9f : 0.0f);
+    }
+    for (const auto& snap : result.snapshots) {
+        balanced = balanced && snap.population + snap.reentered + snap.broken_up == 30 + snap.injected &&
+                   snap.leo == snap.population;
+    }
+    
+    // An explosion in the 1500 km shell adds long-lived fragments
+    ScheduledBreakup breakup;
+    breakup.time_days = 100.0;
+    breakup.object = 2;
+    breakup.event.min_length_m = 0.2;
+    auto fragmented = model.evolve_environment(sys, config, {breakup});
+    const auto& last = fragmented.snapshots.back();
+    
+    return assert_true(result.success && result.snapshots.size() == 11, "Snapshots at every interval") &&
+           assert_true(ordered, "Lower and more active means earlier reentry") &&
+           assert_true(balanced, "Snapshot bookkeeping closes") &&
+           assert_true(result.snapshots.back().population == 10, "Only the 1500 km shell survives") &&
+           assert_true(fragmented.success && last.injected > 0 && last.broken_up == 1 &&
+                       fragmented.reentry_days.size() == 30 + last.injected &&
+                       last.population > result.snapshots.back().population, "Breakup fragments join the population");
+}
+
+bool test_debris_render_buffer() {
+    std::vector<TLE> tles(40);
+    for (size_t i = 0; i < tles.size(); ++i) {
+        tles[i].name = (i % 4 == 0) ? "CZ-4 R/B" : "FENGYUN 1C DEB";
+        tles[i].mean_motion = 14.0 + 0.05 * static_cast<double>(i);
+        tles[i].inclination = 98.0;
+        tles[i].raan = 9.0 * static_cast<double>(i);
+        tles[i].eccentricity = 0.002;
+    }
+    SatelliteSystem sys = create_satellite_system(tles);
+    DebrisModel model;
+    model.load(tles, sys);
+    const DebrisRenderBuffer& render = model.render_buffer();
+    const DebrisSystem& debris = model.debris();
+    
+    const bool fresh = render.count() == debris.count && !render.has_positions() &&
+                       render.catalog_version() == model.catalog_version();
+    const bool updated = model.update_render_positions(sys, 45.0);
+    
+    // Float positions from the kernel match the double propagator
+    double max_error = 0.0;
+    for (size_t row = 0; row < debris.count; ++row) {
+        Vec3 pos, vel;
+        propagate_state(sys, debris.index[row], 45.0, pos, vel);
+        const float* p = &render.positions()[3 * row];
+        max_error = std::max({max_error, std::abs(p[0] - pos.x / 6371.0), std::abs(p[1] - pos.y / 6371.0),
+                              std::abs(p[2] - pos.z / 6371.0)});
+    }
+    
+    bool attributes = true;
+    for (size_t row = 0; row < debris.count; ++row) {
+        const bool rocket = debris_type(debris.flags[row]) == DebrisType::ROCKET_BODY;
+        const float green = render.colors()[3 * row + 1];
+        attributes = attributes && (green == DebrisColors::ROCKET_BODY[1]) == rocket &&
+                     render.sizes()[row] >= 1.0f && render.ids()[row] == static_cast<int32_t>(row);
+    }
+    
+    // A subset gathers the same values as the full copy
+    std::vector<uint32_t> all(debris.count), odd;
+    for (uint32_t row = 0; row < debris.count; ++row) {
+        all[row] = row;
+        if (row % 2) odd.push_back(row);
+    }
+    std::vector<int32_t> ids(all.size());
+    std::vector<float> full(3 * all.size()), part(3 * odd.size()), sizes(odd.size());
+    render.gather(all, ids.data(), full.data(), nullptr, nullptr);
+    render.gather(odd, nullptr, part.data(), nullptr, sizes.data());
+    bool gathered = ids == render.ids() && full == render.positions();
+    for (size_t k = 0; k < odd.size(); ++k) {
+        gathered = gathered && part[3 * k + 1] == full[3 * odd[k] + 1] && sizes[k] == render.sizes()[odd[k]];
+    }
+    
+    return assert_true(fresh && updated && render.has_positions() && render.epoch_minutes() == 45.0,
+                       "Attributes at load, positions on demand") &&
+           assert_true(max_error < 1e-6, "Float32 positions from the kernel") &&
+           assert_true(attributes, "Static colors and sizes by classification") &&
+           assert_true(gathered, "Gather matches the persistent arrays");
+}
+
+bool test_debris_field_statistics() {
+    // Two clouds: one coplanar (spread only along track), one across planes
+    std::vector<TLE> tles(24);
+    for (size_t i = 0; i < tles.size(); ++i) {
+        const bool coplanar = i < 12;
+        tles[i].name = "FENGYUN 1C DEB";
+        tles[i].intl_designator = std::string(coplanar ? "99025" : "93036") + static_cast<char>('A' + i);
+        tles[i].catalog_number = 30000 + static_cast<int>(i);
+        tles[i].mean_motion = 14.2;
+        tles[i].inclination = 98.0;
+        tles[i].raan = coplanar ? 40.0 : 40.0 + 3.0 * static_cast<double>(i - 12);
+        tles[i].mean_anomaly = 2.0 * static_cast<double>(i % 12);
+        tles[i].eccentricity = 0.001;
+    }
+    SatelliteSystem sys = create_satellite_system(tles);
+    DebrisModel model;
+    model.load(tles, sys);
+    const auto& fields = model.get_debris_fields();
+    const bool pending = fields.size() == 2 && !fields[0].has_statistics;
+    
+    propagate_all_optimized(sys, 10.0);
+    model.update_field_statistics(sys, 10.0);
+    
+    // Brute-force centroid and RMS spread of the first field
+    const DebrisField& first = fields[0];
+    Vec3 c;
+    for (uint32_t i : first.indices) {
+        c.x += sys.x[i] / first.indices.size();
+        c.y += sys.y[i] / first.indices.size();
+        c.z += sys.z[i] / first.indices.size();
+    }
+    double sum_sq = 0.0;
+    for (uint32_t i : first.indices) {
+        const Vec3 d = Vec3{sys.x[i], sys.y[i], sys.z[i]} - c;
+        sum_sq += d.x * d.x + d.y * d.y + d.z * d.z;
+    }
+    const double rms = std::sqrt(sum_sq / first.indices.size());
+    const bool direct = (first.centroid - c).magnitude() < 1e-6 && std::abs(first.spread_radius_km - rms) < 1e-6;
+    
+    const bool first_coplanar = first.event_name.find("99025") != std::string::npos;
+    const DebrisField& coplanar = fields[first_coplanar ? 0 : 1];
+    const DebrisField& crossing = fields[first_coplanar ? 1 : 0];
+    
+    // The rate is the derivative at the epoch, whatever epoch came before
+    propagate_all_optimized(sys, 70.0);
+    model.update_field_statistics(sys, 70.0);
+    const double rate = coplanar.spread_rate_km_per_day;
+    propagate_all_optimized(sys, 70.01);
+    model.update_field_statistics(sys, 70.01);
+    const double spread_plus = coplanar.spread_radius_km;
+    propagate_all_optimized(sys, 69.99);
+    model.update_field_statistics(sys, 69.99);
+    const double spread_minus = coplanar.spread_radius_km;
+    const double finite_difference = (spread_plus - spread_minus) * 1440.0 / 0.02;
+    propagate_all_optimized(sys, 500.0);
+    model.update_field_statistics(sys, 500.0);
+    propagate_all_optimized(sys, 70.0);
+    model.update_field_statistics(sys, 70.0);
+    
+    return assert_true(pending, "Statistics wait for a propagation") &&
+           assert_true(direct, "Centroid and spread match a direct computation") &&
+           assert_true(coplanar.plane_dispersion_deg < 1e-3 && crossing.plane_dispersion_deg > 5.0,
+                       "Plane dispersion separates coplanar and crossing clouds") &&
+           assert_true(coplanar.stats_epoch_minutes == 70.0 && rate != 0.0 &&
+                       std::abs(rate - finite_difference) < 1e-3 * std::abs(rate) + 1e-3,
+                       "Spread rate is the derivative at the epoch") &&
+           assert_true(coplanar.spread_rate_km_per_day == rate, "Spread rate does not depend on update order");
+}
+
+bool test_orbit_interval_index() {
+    // LEO to GEO, circular and eccentric, deterministic spread
+    const size_t n = 500;
+    std::vector<TLE> tles(n);
+    for (size_t i = 0; i < n; ++i) {
+        tles[i].name = (i % 5 == 0) ? "COSMOS 2251 DEB" : "SAT";
+        tles[i].catalog_number = 40000 + static_cast<int>(i);
+        tles[i].mean_motion = (i % 50 == 0) ? 1.0027 : 11.0 + 0.01 * static_cast<double>(i % 500);
+        tles[i].eccentricity = (i % 7 == 0) ? 0.3 : 0.0005 * static_cast<double>(i % 11);
+        tles[i].inclination = 53.0;
+    }
+    SatelliteSystem sys = create_satellite_system(tles);
+    OrbitIntervalIndex bands;
+    bands.build(sys);
+    
+    auto brute = [&](double lo, double hi) {
+        std::vector<uint32_t> out;
+        for (uint32_t i = 0; i < sys.count; ++i) {
+            if (sys.a0[i] * (1.0 - sys.ecc[i]) <= hi && sys.a0[i] * (1.0 + sys.ecc[i]) >= lo) out.push_back(i);
+        }
+        return out;
+    };
+    const double queries[][2] = {{6911.0, 6931.0}, {7000.0, 7400.0}, {3000.0, 6500.0}, {42000.0, 42300.0},
+                                 {6378.0, 60000.0}};
+    bool matches = true;
+    for (const auto& q : queries) matches = matches && bands.query(q[0], q[1]) == brute(q[0], q[1]);
+    
+    // Incremental update touches only the changed objects
+    sys.ecc[3] = 0.2;
+    sys.a0[10] += 150.0;
+    const size_t updated = bands.sync(sys);
+    const bool synced = updated == 2 && bands.query(7000.0, 7400.0) == brute(7000.0, 7400.0) &&
+                        bands.query(9000.0, 9100.0) == brute(9000.0, 9100.0);
+    
+    // Filter and debris queries agree with the element-based answer
+    ObjectFilter crossing;
+    crossing.min_orbit_altitude_km = 540.0;
+    crossing.max_orbit_altitude_km = 560.0;
+    const auto indexed = select_filtered(sys, crossing, 0.0, &bands);
+    const auto direct = select_filtered(sys, crossing, 0.0);
+    
+    DebrisModel model;
+    model.load(tles, sys);
+    bool debris_ok = true;
+    for (uint32_t row : model.get_debris_crossing(bands, 540.0, 560.0)) {
+        const uint32_t i = model.debris().index[row];
+        debris_ok = debris_ok && std::binary_search(direct.begin(), direct.end(), i);
+    }
+    size_t debris_in_direct = 0;
+    for (uint32_t i : direct) debris_in_direct += (i % 5 == 0) ? 1 : 0;
+    
+    return assert_true(matches, "Queries match a linear scan") &&
+           assert_true(synced, "Sync re-indexes changed objects") &&
+           assert_true(!direct.empty() && indexed == direct && !crossing.is_pass_through(),
+                       "Crossing filter through the index") &&
+           assert_true(debris_ok && model.get_debris_crossing(bands, 540.0, 560.0).size() <= debris_in_direct,
+                       "Debris crossing rows");
+}
+
+bool test_reentry_predictions() {
+    // ~200 and ~250 km debris with graded B*, plus 350 km objects that are
+    // not candidates
+    const double rev_per_day[] = {16.29, 16.29, 16.10, 15.74};
+    const size_t n = 40;
+    std::vector<TLE> tles(n);
+    for (size_t i = 0; i < n; ++i) {
+        tles[i].name = "COSMOS 2251 DEB";
+        tles[i].catalog_number = 50000 + static_cast<int>(i);
+        tles[i].mean_motion = rev_per_day[i % 4];
+        tles[i].eccentricity = 0.0005;
+        tles[i].inclination = 74.0;
+        tles[i].bstar = 2e-4 * static_cast<double>(1 + i % 5);
+        tles[i].epoch_jd = 2460000.5;
+    }
+    SatelliteSystem sys = create_satellite_system(tles);
+    OrbitIntervalIndex bands;
+    bands.build(sys);
+    
+    ReentryConfig config;
+    config.ensemble_size = 12;
+    const auto report = predict_reentries(sys, config, &bands);
+    const auto scanned = predict_reentries(sys, config);
+    
+    // Index and linear scan agree; seeding is per object, not per thread
+    bool same = report.success && scanned.success && report.predictions.size() == scanned.predictions.size();
+    for (size_t k = 0; same && k < report.predictions.size(); ++k) {
+        same = report.predictions[k].index == scanned.predictions[k].index &&
+               report.predictions[k].nominal_days == scanned.predictions[k].nominal_days &&
+               report.predictions[k].window_end_days == scanned.predictions[k].window_end_days;
+    }
+    
+    bool candidates_ok = report.candidates == 30 && report.predictions.size() == 30;
+    bool windows_ok = true;
+    for (const auto& pred : report.predictions) {
+        candidates_ok = candidates_ok && pred.index % 4 != 3 && pred.perigee_altitude_km < 300.0 &&
+                        pred.catalog_number == 50000 + static_cast<int>(pred.index);
+        windows_ok = windows_ok && pred.reenters && pred.nominal_days > 0.0 && pred.nominal_days < 365.0 &&
+                     pred.window_start_days <= pred.window_end_days &&
+                     pred.mean_days >= pred.window_start_days && pred.mean_days <= pred.window_end_days &&
+                     (!pred.window_complete || pred.sigma_days > 0.0);
+    }
+    
+    // Larger B* (more drag per unit mass) reenters sooner at the same altitude
+    bool drag_ordered = true;
+    for (const auto& p : report.predictions) {
+        for (const auto& q : report.predictions) {
+            if (p.index % 4 == 2 || q.index % 4 == 2) continue;
+            if (sys.bstar[p.index] > sys.bstar[q.index]) {
+                drag_ordered = drag_ordered && p.nominal_days < q.nominal_days;
+            }
+        }
+    }
+    
+    // Tombstones only once the whole window lies in the past
+    size_t complete = 0;
+    for (const auto& pred : report.predictions) complete += pred.window_complete ? 1 : 0;
+    const bool tombstones = decayed_catalog_numbers(report, tles, 2460000.5).empty() &&
+                            decayed_catalog_numbers(report, tles, 2460000.5 + 400.0).size() == complete &&
+                            complete > 0;
+    
+    DebrisModel model;
+    model.load(tles, sys);
+    const size_t applied = model.apply_reentry_predictions(report, sys);
+    const auto& first = report.predictions.front();
+    const int32_t row = static_cast<int32_t>(first.index);
+    const bool debris_ok = applied == 30 && model.get_statistics().predicted_reentries == 30 &&
+                           model.debris().decay_days[row] == static_cast<int32_t>(std::ceil(first.nominal_days));
+    
+    return assert_true(same, "Index and scan candidates give identical predictions") &&
+           assert_true(candidates_ok, "Only low-perigee candidates") &&
+           assert_true(windows_ok, "Ordered reentry windows within the horizon") &&
+           assert_true(drag_ordered, "Higher drag reenters sooner") &&
+           assert_true(tombstones, "Decayed once the window has passed") &&
+           assert_true(debris_ok, "Predictions feed the debris model");
+}
+
+bool test_debris_objects_match_render_positions() {
+    std::vector<TLE> tles(24);
+    for (size_t i = 0; i < tles.size(); ++i) {
+        tles[i].name = "FENGYUN 1C DEB";
+        tles[i].mean_motion = 14.2 + 0.04 * static_cast<double>(i);
+        tles[i].inclination = 98.6;
+        tles[i].raan = 15.0 * static_cast<double>(i);
+        tles[i].eccentricity = 0.004;
+    }
+    SatelliteSystem sys = create_satellite_system(tles);
+    DebrisModel model;
+    model.load(tles, sys);
+    
+    // The SoA holds a different epoch than the request (as after a stream)
+    propagate_all_optimized(sys, 10.0);
+    const double t = 130.0;
+    model.update_render_positions(sys, t);
+    
+    // One GetDebrisField response: packed positions and objects for a band
+    const auto rows = model.get_debris_in_shell(0.0, 100000.0);
+    std::vector<float> positions(3 * rows.size());
+    model.render_buffer().gather(rows, nullptr, positions.data(), nullptr, nullptr);
+    std::vector<DebrisObject> objects;
+    const bool ok = model.get_objects_at(rows, sys, t, objects);
+    
+    const double scale = model.render_buffer().scale_factor();
+    double max_error = 0.0;
+    for (size_t k = 0; ok && k < objects.size(); ++k) {
+        const float* p = &positions[3 * k];
+        max_error = std::max({max_error, std::abs(p[0] - objects[k].position.x * scale),
+                              std::abs(p[1] - objects[k].position.y * scale),
+                              std::abs(p[2] - objects[k].position.z * scale)});
+    }
+    const Vec3 stale = model.get_object(rows.front(), sys).position;
+    const bool moved = std::abs(stale.x - objects.front().position.x) > 1.0;
+    
+    return assert_true(ok && objects.size() == rows.size() && !rows.empty(), "Objects for every row") &&
+           assert_true(max_error < 1e-5, "Object states match the packed positions") &&
+           assert_true(moved, "States are at the request epoch, not the SoA epoch");
+}
+
 // ============================================================================
 // Main
 // ============================================================================
@@ -268,6 +1641,52 @@ int main() {
     suite.add("Stability: 7-day propagation", test_long_propagation_stability);
     suite.add("Stability: High eccentricity orbit", test_high_eccentricity);
     
+    // Frame Cache
+    suite.add("Frame Cache: LRU eviction within budget", test_frame_cache_lru_eviction);
+    suite.add("Frame Cache: Catalog version invalidation", test_frame_cache_version_invalidation);
+    suite.add("Frame Cache: Catalog page ranges and keys", test_catalog_paging);
+    
+    // Object Filter
+    suite.add("Object Filter: Band, class, ID and geo predicates", test_object_filter_predicates);
+    
+    // Paced Writer
+    suite.add("Paced Writer: Slow client skips intermediate frames", test_paced_writer_skips_intermediate_frames);
+    suite.add("Paced Writer: Events never skipped, disconnect stops producer", test_paced_writer_keeps_events);
+    
+    // Cancellation
+    suite.add("Cancellation: Tripped token stops kernels", test_cancellation_stops_kernels);
+    
+    // Subset Propagation
+    suite.add("Orbit Path: Curvature-adaptive sampling", test_orbit_path_adaptive_sampling);
+    suite.add("State Queries: Match batch propagation", test_state_queries_match_propagation);
+    
+    // Neighbour Queries
+    suite.add("Neighbour Query: kNN and radius match brute force", test_neighbor_queries_match_brute_force);
+    
+    // Conjunction Monitor
+    suite.add("Monitor: Screening reduces hits to encounters", test_monitor_screens_encounters);
+    suite.add("Monitor: Event table reports new, changed, resolved", test_monitor_event_table_diffs);
+    suite.add("Monitor: Rolling horizon re-screens only what changed", test_screening_horizon_incremental);
+    suite.add("Monitor: Sharded screening matches single process", test_sharded_screening_matches_single_process);
+    
+    // Stage Metrics
+    suite.add("Stage Metrics: Timers, counters and Prometheus endpoint", test_stage_metrics_prometheus);
+    suite.add("Tracing: Per-thread rings dump as trace-event JSON", test_trace_rings_and_json);
+    suite.add("Flight Recorder: Slow requests dumped with context", test_flight_recorder_dumps_slow_requests);
+    
+    // Debris
+    suite.add("Debris: SoA classification masks and filters", test_debris_system_masks);
+    suite.add("Debris: Shell density histogram cached per catalog", test_shell_density_histogram);
+    suite.add("Debris: Indexed fleet risk matches linear scan", test_fleet_risk_matches_linear_scan);
+    suite.add("Debris: Breakup cloud injected at the parent state", test_breakup_fragments_inject);
+    suite.add("Debris: Small-debris flux table and orbit averages", test_small_debris_flux_table);
+    suite.add("Debris: Long-term evolution under drag and breakups", test_debris_evolution_decay);
+    suite.add("Debris: Render buffer written by the propagator", test_debris_render_buffer);
+    suite.add("Debris: Objects and packed positions share the request epoch", test_debris_objects_match_render_positions);
+    suite.add("Debris: Field statistics after each propagation", test_debris_field_statistics);
+    suite.add("Debris: Orbit interval index queries and sync", test_orbit_interval_index);
+    suite.add("Debris: Batch reentry prediction windows", test_reentry_predictions);
+    
     return suite.run();
 }
 